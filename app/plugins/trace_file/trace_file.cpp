@@ -0,0 +1,56 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_file.h"
+
+#include "core/util/logging.hpp"
+#include "core/util/profiling.hpp"
+
+namespace plugins
+{
+TraceFile::TraceFile() :
+    TraceFileTags("Trace File",
+                  "Write a Chrome trace of the profiled scopes and plots to a file.",
+                  {vkb::Hook::OnUpdate, vkb::Hook::OnPlatformClose}, {&trace_file_flag})
+{
+}
+
+bool TraceFile::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&trace_file_flag);
+}
+
+void TraceFile::init(const vkb::CommandParser &parser)
+{
+#ifdef TRACY_ENABLE
+	LOGW("Tracy is enabled, the profiled scopes are sent to Tracy and the trace file stays empty");
+#endif
+
+	vkb::trace::start(parser.as<std::string>(&trace_file_flag));
+}
+
+void TraceFile::on_update(float delta_time)
+{
+	// Drains the events of the frame, so that the ring buffer does not overflow on long runs
+	vkb::trace::flush();
+}
+
+void TraceFile::on_platform_close()
+{
+	vkb::trace::stop();
+}
+}        // namespace plugins
@@ -0,0 +1,51 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+using TraceFileTags = vkb::PluginBase<vkb::tags::Passive>;
+
+/**
+ * @brief Trace File
+ *
+ * Records the profiled scopes and plots into a Chrome trace event JSON file, when Tracy is not enabled
+ *
+ * Usage: vulkan_sample sample afbc --trace-file trace.json
+ *
+ */
+class TraceFile : public TraceFileTags
+{
+  public:
+	TraceFile();
+
+	virtual ~TraceFile() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	void on_update(float delta_time) override;
+
+	void on_platform_close() override;
+
+	vkb::FlagCommand trace_file_flag = {vkb::FlagType::OneValue, "trace-file", "", "Write a Chrome trace of the profiled scopes to the given file name"};
+};
+}        // namespace plugins
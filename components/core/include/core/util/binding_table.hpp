@@ -0,0 +1,137 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+
+namespace vkb
+{
+/**
+ * @brief Maps small indices, such as descriptor set or binding numbers, to values
+ *
+ * Indices lower than Capacity are stored in a fixed-capacity array along with a mask of the indices
+ * in use, so that looking them up or iterating over them neither hashes nor allocates. Larger
+ * indices are rare, they fall back to an ordered map.
+ *
+ * Clearing the table keeps the values of the array, so that the storage they own can be reused.
+ */
+template <typename T, uint32_t Capacity>
+class BindingTable
+{
+	static_assert(Capacity <= 32, "The mask of the indices in use holds 32 bits");
+
+  public:
+	/**
+	 * @brief Gets the value of an index, marking the index in use
+	 *        A value of the array is left as it was before the table was cleared
+	 */
+	T &operator[](uint32_t index)
+	{
+		if (index < Capacity)
+		{
+			mask |= 1u << index;
+			return values[index];
+		}
+
+		return overflow_values[index];
+	}
+
+	/**
+	 * @return The value of an index, or nullptr if the index is not in use
+	 */
+	T *find(uint32_t index)
+	{
+		return const_cast<T *>(static_cast<const BindingTable *>(this)->find(index));
+	}
+
+	const T *find(uint32_t index) const
+	{
+		if (index < Capacity)
+		{
+			return (mask & (1u << index)) ? &values[index] : nullptr;
+		}
+
+		auto it = overflow_values.find(index);
+		return it != overflow_values.end() ? &it->second : nullptr;
+	}
+
+	/**
+	 * @return A mask with a bit set for each index lower than Capacity which is in use
+	 */
+	uint32_t get_mask() const
+	{
+		return mask;
+	}
+
+	bool empty() const
+	{
+		return mask == 0 && overflow_values.empty();
+	}
+
+	/**
+	 * @brief Calls func(index, value) for each index in use, ordered by index
+	 */
+	template <class F>
+	void for_each(F &&func)
+	{
+		for_each_in(*this, func);
+	}
+
+	template <class F>
+	void for_each(F &&func) const
+	{
+		for_each_in(*this, func);
+	}
+
+	/**
+	 * @brief Marks all indices as not in use
+	 */
+	void clear()
+	{
+		mask = 0;
+		overflow_values.clear();
+	}
+
+  private:
+	template <class Table, class F>
+	static void for_each_in(Table &table, F &func)
+	{
+		uint32_t remaining = table.mask;
+		for (uint32_t index = 0; remaining != 0; ++index, remaining >>= 1)
+		{
+			if (remaining & 1u)
+			{
+				func(index, table.values[index]);
+			}
+		}
+
+		for (auto &value_it : table.overflow_values)
+		{
+			func(value_it.first, value_it.second);
+		}
+	}
+
+	uint32_t mask{0};
+
+	std::array<T, Capacity> values{};
+
+	std::map<uint32_t, T> overflow_values;
+};
+}        // namespace vkb
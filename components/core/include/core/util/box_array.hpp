@@ -0,0 +1,70 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Axis aligned boxes stored as one array per coordinate, so that several boxes are tested at a time
+ */
+struct BoxArray
+{
+	std::vector<float> center_x;
+	std::vector<float> center_y;
+	std::vector<float> center_z;
+
+	/// Half size of the boxes
+	std::vector<float> extent_x;
+	std::vector<float> extent_y;
+	std::vector<float> extent_z;
+
+	void resize(size_t size);
+
+	size_t size() const;
+
+	/**
+	 * @brief Sets a box from vectors with x, y and z members
+	 */
+	template <class Vec3>
+	void set(size_t index, const Vec3 &center, const Vec3 &extent)
+	{
+		center_x[index] = center.x;
+		center_y[index] = center.y;
+		center_z[index] = center.z;
+		extent_x[index] = extent.x;
+		extent_y[index] = extent.y;
+		extent_z[index] = extent.z;
+	}
+
+	/**
+	 * @brief Checks which boxes of a range intersect the volume on the positive side of all the planes
+	 *        The loops are branchless over the contiguous coordinates, so that the compiler vectorizes them
+	 * @param planes The planes as their normalized normal followed by their distance to the origin
+	 * @param plane_count The number of planes
+	 * @param begin The first box of the range
+	 * @param end The end of the range
+	 * @param visible One value per box of the range, set to 1 if the box intersects the volume or 0 otherwise
+	 */
+	void check_planes(const std::array<float, 4> *planes, size_t plane_count, size_t begin, size_t end, uint8_t *visible) const;
+};
+}        // namespace vkb
@@ -0,0 +1,95 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Flat list of draws sorted by 64-bit keys
+ *
+ * The keys pack the properties the draws are ordered by, most significant first, and each key carries the
+ * index of its draw in an array owned by the caller. Keys are sorted with a stable radix sort, and the
+ * storage is reused from one frame to the next, so that building a list does not allocate once warmed up.
+ *
+ * The key of an opaque draw is its shader variant, material, front face and submesh, and then its distance, so that
+ * opaque draws are grouped by state and drawn front-to-back within a group. The key of a transparent draw is its
+ * reverse distance, after all the opaque keys, so that transparent draws come last, back-to-front.
+ */
+class DrawList
+{
+  public:
+	struct Entry
+	{
+		uint64_t key;
+
+		/// Index of the draw in the array of the caller
+		uint32_t index;
+	};
+
+	/**
+	 * @brief Maps a non-negative float to an integer with the same order, negative values map to 0
+	 */
+	static uint32_t to_sortable(float value);
+
+	/**
+	 * @brief Packs the state of an opaque draw, ids beyond the bits available in the keys are clamped
+	 */
+	static uint64_t make_state_key(uint64_t variant_id, uint64_t material_id, uint64_t sub_mesh_id);
+
+	/**
+	 * @brief Key of an opaque draw
+	 * @param state_key The state of the draw, see make_state_key
+	 * @param flipped Whether the draw uses the other front face
+	 * @param distance Distance of the draw to the camera
+	 */
+	static uint64_t make_opaque_key(uint64_t state_key, bool flipped, float distance);
+
+	/**
+	 * @brief Key of a transparent draw
+	 * @param distance Distance of the draw to the camera
+	 */
+	static uint64_t make_transparent_key(float distance);
+
+	static bool is_transparent(uint64_t key);
+
+	/**
+	 * @return The state and front face of an opaque key, equal for the instances of a submesh which can be drawn together
+	 */
+	static uint64_t get_group(uint64_t key);
+
+	void clear();
+
+	void push_back(uint64_t key, uint32_t index);
+
+	/**
+	 * @brief Sorts the entries by increasing key, entries with equal keys keep their order
+	 */
+	void sort();
+
+	const std::vector<Entry> &get_entries() const;
+
+  private:
+	std::vector<Entry> entries;
+
+	/// Destination of the passes of the sort
+	std::vector<Entry> scratch;
+};
+}        // namespace vkb
@@ -0,0 +1,257 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Pool of worker threads running the jobs of the whole framework
+ *
+ * Each worker owns a deque of jobs. It runs the jobs it scheduled itself from the back of its deque,
+ * and steals the oldest jobs from the front of the other deques once its own is empty.
+ * Jobs scheduled from other threads are distributed across the workers in turn.
+ *
+ * A job starts once all the jobs it depends on have completed, which allows chaining continuations.
+ * A thread waiting for a job runs the other pending jobs meanwhile, so jobs can wait for jobs.
+ * Background jobs, such as pipeline compilations, are run by the workers once they are idle, or by a thread
+ * waiting for that job in particular if no worker started it yet, so that waiting on them from every worker
+ * cannot deadlock.
+ *
+ * The Platform owns the job system used by the framework (see get).
+ */
+class JobSystem
+{
+  public:
+	class Job;
+
+	using JobHandle = std::shared_ptr<Job>;
+
+	/**
+	 * @param worker_count Number of worker threads, 0 for one per hardware thread except the calling one
+	 */
+	explicit JobSystem(size_t worker_count = 0);
+
+	/**
+	 * @brief Runs the jobs which are still scheduled, then joins the workers
+	 */
+	~JobSystem();
+
+	JobSystem(const JobSystem &) = delete;
+
+	JobSystem(JobSystem &&) = delete;
+
+	JobSystem &operator=(const JobSystem &) = delete;
+
+	JobSystem &operator=(JobSystem &&) = delete;
+
+	/**
+	 * @brief Sets the job system returned by get, it remains owned by the caller
+	 */
+	static void set_instance(JobSystem *job_system);
+
+	/**
+	 * @return The job system of the framework, as set by the Platform.
+	 *         Without a Platform, a default one is created on first use
+	 */
+	static JobSystem &get();
+
+	/**
+	 * @brief Schedules a job
+	 * @param func Function run by the job
+	 * @param dependencies Jobs which must complete before this one starts
+	 * @return Handle to wait for the job, or to make other jobs depend on it
+	 */
+	JobHandle schedule(std::function<void()> &&func, const std::vector<JobHandle> &dependencies = {});
+
+	/**
+	 * @brief Schedules a job starting once another one completed
+	 */
+	JobHandle then(const JobHandle &job, std::function<void()> &&func);
+
+	/**
+	 * @brief Schedules a job which is only run by idle workers, never by a thread waiting for another job
+	 *        Used for long tasks which must not delay the threads waiting on short ones
+	 */
+	JobHandle schedule_background(std::function<void()> &&func);
+
+	bool is_complete(const JobHandle &job) const;
+
+	/**
+	 * @brief Waits for a job to complete, running other jobs meanwhile
+	 *        A background job which no worker started yet is run by the calling thread.
+	 *        Rethrows the exception the job exited with, if any
+	 */
+	void wait(const JobHandle &job);
+
+	/**
+	 * @brief Waits for all the jobs to complete, then rethrows the first exception if any
+	 */
+	void wait(const std::vector<JobHandle> &jobs);
+
+	/**
+	 * @brief Calls func for each index in [0, count), on the workers and the calling thread
+	 *        Indices are handed out one at a time, so that uneven calls are balanced.
+	 *        Waits for all the calls to complete, then rethrows the first exception if any
+	 */
+	template <typename F>
+	void parallel_for(size_t count, F &&func);
+
+	size_t get_worker_count() const;
+
+	/**
+	 * @return Index of the worker running the calling thread, or get_worker_count() for other threads
+	 */
+	size_t get_current_worker_index() const;
+
+	/**
+	 * @return Time the worker spent running jobs, since the job system was created or reset_busy_times was called
+	 */
+	std::chrono::nanoseconds get_busy_time(size_t worker_index) const;
+
+	void reset_busy_times();
+
+  private:
+	struct Worker
+	{
+		std::mutex mutex;
+
+		std::deque<JobHandle> jobs;
+
+		/// Nanoseconds spent running jobs
+		std::atomic<int64_t> busy_time{0};
+
+		std::thread thread;
+	};
+
+	void worker_loop(size_t worker_index);
+
+	/**
+	 * @brief Queues a job whose dependencies all completed
+	 */
+	void enqueue(const JobHandle &job);
+
+	/**
+	 * @brief Takes a job from the deque of the worker, or steals one from the other workers
+	 */
+	JobHandle pop_job(size_t worker_index);
+
+	JobHandle pop_background_job();
+
+	/**
+	 * @brief Removes a background job from the queue, so that the caller runs it
+	 * @return False if the job was already taken by a worker
+	 */
+	bool take_background_job(const JobHandle &job);
+
+	void run(const JobHandle &job, size_t worker_index);
+
+	/**
+	 * @brief Releases one of the dependencies the job is waiting for, queuing it after the last one
+	 */
+	void release_dependency(const JobHandle &job);
+
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	/// Worker receiving the next job scheduled from another thread
+	std::atomic<size_t> next_worker{0};
+
+	/// Jobs in the worker deques
+	std::atomic<size_t> queued_job_count{0};
+
+	std::mutex background_mutex;
+
+	std::deque<JobHandle> background_jobs;
+
+	std::atomic<size_t> queued_background_job_count{0};
+
+	/// Threads blocked in wait, which must be woken when a job completes
+	std::atomic<size_t> waiting_thread_count{0};
+
+	/// Guards sleeping on the condition, and stopping
+	std::mutex wake_mutex;
+
+	std::condition_variable wake_condition;
+
+	bool stopping{false};
+};
+
+template <typename F>
+void JobSystem::parallel_for(size_t count, F &&func)
+{
+	size_t batch_count = std::min(count, workers.size() + 1);
+
+	std::atomic<size_t> next_index{0};
+
+	auto run_batch = [&func, &next_index, count]() {
+		for (size_t index = next_index++; index < count; index = next_index++)
+		{
+			func(index);
+		}
+	};
+
+	std::vector<JobHandle> batch_jobs;
+	for (size_t i = 1; i < batch_count; i++)
+	{
+		batch_jobs.push_back(schedule(run_batch));
+	}
+
+	std::exception_ptr exception;
+
+	try
+	{
+		run_batch();
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+
+	// The batches refer to this stack frame, so they are all waited for
+	for (auto &batch_job : batch_jobs)
+	{
+		try
+		{
+			wait(batch_job);
+		}
+		catch (...)
+		{
+			if (!exception)
+			{
+				exception = std::current_exception();
+			}
+		}
+	}
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+}        // namespace vkb
@@ -17,10 +17,16 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
-#include <unordered_map>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "core/util/error.hpp"
 
@@ -28,6 +34,98 @@
 #	include <tracy/Tracy.hpp>
 #endif
 
+namespace vkb
+{
+/**
+ * @brief Lightweight recorder of the profiled scopes and plots, used when Tracy is not enabled
+ *
+ * Each thread records its events into a lock-free ring buffer of its own, so recording a scope only costs
+ * two clock reads. The events are written to a Chrome trace event JSON file, which can be opened in
+ * chrome://tracing or https://ui.perfetto.dev. Nothing is recorded until recording starts.
+ */
+namespace trace
+{
+/**
+ * @brief Starts recording, and creates the trace file
+ *        The events are written to the file by flush, and once recording stops or the application exits
+ * @param path The path of the trace file
+ * @return False if the file could not be created
+ */
+bool start(const std::string &path);
+
+/**
+ * @brief Stops recording, and completes the trace file
+ */
+void stop();
+
+/**
+ * @brief Writes the events recorded so far to the trace file
+ */
+void flush();
+
+namespace detail
+{
+extern std::atomic<bool> recording;
+
+uint64_t now();
+
+void record_scope(const char *name, uint64_t begin, uint64_t end);
+
+void record_counter(const char *name, double value);
+}        // namespace detail
+
+inline bool is_recording()
+{
+	return detail::recording.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Records the time spent between its construction and destruction
+ *        The name must outlive the recording, string literals are expected
+ */
+class Scope
+{
+  public:
+	explicit Scope(const char *name) :
+	    name{name}, active{is_recording()}, begin{active ? detail::now() : 0}
+	{}
+
+	~Scope()
+	{
+		if (active)
+		{
+			detail::record_scope(name, begin, detail::now());
+		}
+	}
+
+	Scope(const Scope &) = delete;
+
+	Scope &operator=(const Scope &) = delete;
+
+  private:
+	const char *name;
+
+	bool active;
+
+	uint64_t begin;
+};
+
+/**
+ * @brief Records the value of a plot, the name must outlive the recording
+ */
+inline void counter(const char *name, double value)
+{
+	if (is_recording())
+	{
+		detail::record_counter(name, value);
+	}
+}
+}        // namespace trace
+}        // namespace vkb
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
 #ifdef TRACY_ENABLE
 // malloc and free are used by Tracy to provide memory profiling
 void *operator new(size_t count);
@@ -39,8 +137,11 @@ void  operator delete(void *ptr) noexcept;
 // Trace a function
 #	define PROFILE_FUNCTION() ZoneScoped
 #else
-#	define PROFILE_SCOPE(name)
-#	define PROFILE_FUNCTION()
+// Record a scope in the trace
+#	define PROFILE_SCOPE(name) vkb::trace::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+
+// Record a function in the trace
+#	define PROFILE_FUNCTION() vkb::trace::Scope PROFILE_CONCAT(profile_function_, __LINE__)(__func__)
 #endif
 
 // The type of plot to use
@@ -77,54 +178,218 @@ inline tracy::PlotFormatType to_tracy_plot_format(PlotType type)
 #	define TO_TRACY_PLOT_FORMAT(name)
 #endif
 
-// Create plots
+namespace vkb
+{
+/**
+ * @brief Storage of a plot, its address is stable for the lifetime of the application
+ */
+struct PlotSlot
+{
+	static constexpr size_t MAX_NAME_LENGTH = 63;
+
+	char name[MAX_NAME_LENGTH + 1]{};
+
+	PlotType type{PlotType::Number};
+
+	/// Whether the value is stored as a double or as an int64_t
+	bool floating{false};
+
+	/// Bits of the value, updated with relaxed atomics
+	std::atomic<uint64_t> bits{0};
+};
+
+/**
+ * @brief Value of a plot at the time of a snapshot
+ */
+struct PlotValue
+{
+	const char *name;
+
+	PlotType type;
+
+	double value;
+};
+
+/**
+ * @brief Registry of all the plots, with a fixed capacity so that registering a plot never allocates
+ */
+class PlotRegistry
+{
+  public:
+	static constexpr size_t MAX_PLOTS = 256;
+
+	static PlotRegistry &get();
+
+	/**
+	 * @brief Finds the slot of a plot, creating it on first use
+	 *        Takes a lock, so hot paths should resolve their plots once, see Plot
+	 * @param name The name of the plot, names longer than PlotSlot::MAX_NAME_LENGTH are truncated
+	 * @param type How the plot is displayed
+	 * @param floating Whether the value is stored as a double or as an int64_t
+	 * @return The slot of the plot, or an overflow slot storing values the same way if the registry is full,
+	 *         or if the plot already exists and stores its value the other way
+	 */
+	PlotSlot &resolve(const char *name, PlotType type, bool floating);
+
+	/**
+	 * @brief Reads the current value of all the plots, may be called from any thread
+	 */
+	std::vector<PlotValue> snapshot() const;
+
+  private:
+	PlotRegistry() = default;
+
+	PlotSlot &get_overflow_slot(bool floating);
+
+	std::mutex mutex;
+
+	std::array<PlotSlot, MAX_PLOTS> slots{};
+
+	/// Number of initialized slots, published after a slot is initialized
+	std::atomic<size_t> slot_count{0};
+
+	/// Slots shared by the plots which could not be registered, one per way of storing the value
+	std::array<PlotSlot, 2> overflow_slots{};
+};
+}        // namespace vkb
+
+/**
+ * @brief Handle to a plot, resolved once and updated with relaxed atomics
+ *
+ * Hot paths should keep a handle, typically in a static at the call site:
+ *
+ *     static Plot<int64_t> loaded_images{"Loaded Images"};
+ *     loaded_images.increment(1);
+ *
+ * The static functions taking a name resolve the plot on every call instead.
+ */
 template <typename T, PlotType PT = PlotType::Number>
 class Plot
 {
+	static_assert((std::is_same<T, int64_t>::value || std::is_same<T, double>::value || std::is_same<T, float>::value), "Plot only supports int64_t, double and float");
+
+	static constexpr bool floating = !std::is_same<T, int64_t>::value;
+
   public:
+	explicit Plot(const char *name) :
+	    slot{&vkb::PlotRegistry::get().resolve(name, PT, floating)}
+	{}
+
+	void plot(T value)
+	{
+		store(*slot, value);
+	}
+
+	void increment(T amount)
+	{
+		add(*slot, amount);
+	}
+
+	void decrement(T amount)
+	{
+		add(*slot, -amount);
+	}
+
+	void reset()
+	{
+		store(*slot, T{});
+	}
+
+	T get() const
+	{
+		return from_bits(slot->bits.load(std::memory_order_relaxed));
+	}
+
 	static void plot(const char *name, T value)
 	{
-		auto *p        = get_instance();
-		p->plots[name] = value;
-		update_tracy_plot(name, value);
+		store(resolve(name), value);
 	}
 
 	static void increment(const char *name, T amount)
 	{
-		auto *p = get_instance();
-		p->plots[name] += amount;
-		update_tracy_plot(name, p->plots[name]);
+		add(resolve(name), amount);
 	}
 
 	static void decrement(const char *name, T amount)
 	{
-		auto *p = get_instance();
-		p->plots[name] -= amount;
-		update_tracy_plot(name, p->plots[name]);
+		add(resolve(name), -amount);
 	}
 
 	static void reset(const char *name)
 	{
-		auto *p        = get_instance();
-		p->plots[name] = T{};
-		update_tracy_plot(name, p->plots[name]);
+		store(resolve(name), T{});
 	}
 
   private:
-	static void update_tracy_plot(const char *name, T value)
+	static vkb::PlotSlot &resolve(const char *name)
 	{
-#ifdef TRACY_ENABLE
-		TracyPlot(name, value);
-		TracyPlotConfig(name, TO_TRACY_PLOT_FORMAT(PT), true, true, 0);
-#endif
+		return vkb::PlotRegistry::get().resolve(name, PT, floating);
+	}
+
+	static uint64_t to_bits(T value)
+	{
+		if constexpr (floating)
+		{
+			double   as_double = static_cast<double>(value);
+			uint64_t bits;
+			std::memcpy(&bits, &as_double, sizeof(bits));
+			return bits;
+		}
+		else
+		{
+			return static_cast<uint64_t>(value);
+		}
+	}
+
+	static T from_bits(uint64_t bits)
+	{
+		if constexpr (floating)
+		{
+			double as_double;
+			std::memcpy(&as_double, &bits, sizeof(bits));
+			return static_cast<T>(as_double);
+		}
+		else
+		{
+			return static_cast<T>(bits);
+		}
+	}
+
+	static void store(vkb::PlotSlot &slot, T value)
+	{
+		slot.bits.store(to_bits(value), std::memory_order_relaxed);
+		update_plot(slot.name, value);
+	}
+
+	static void add(vkb::PlotSlot &slot, T amount)
+	{
+		T value;
+
+		if constexpr (floating)
+		{
+			// There is no atomic floating point addition before C++20
+			uint64_t old_bits = slot.bits.load(std::memory_order_relaxed);
+			do
+			{
+				value = from_bits(old_bits) + amount;
+			} while (!slot.bits.compare_exchange_weak(old_bits, to_bits(value), std::memory_order_relaxed));
+		}
+		else
+		{
+			value = from_bits(slot.bits.fetch_add(to_bits(amount), std::memory_order_relaxed)) + amount;
+		}
+
+		update_plot(slot.name, value);
 	}
 
-	static Plot *get_instance()
+	static void update_plot(const char *name, T value)
 	{
-		static_assert((std::is_same<T, int64_t>::value || std::is_same<T, double>::value || std::is_same<T, float>::value), "PlotStore only supports int64_t, double and float");
-		static Plot instance;
-		return &instance;
+#ifdef TRACY_ENABLE
+		TracyPlot(name, value);
+#else
+		vkb::trace::counter(name, static_cast<double>(value));
+#endif
 	}
 
-	std::unordered_map<const char *, T> plots;
+	vkb::PlotSlot *slot;
 };
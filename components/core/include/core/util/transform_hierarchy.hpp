@@ -0,0 +1,151 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Tracks which nodes of a hierarchy need their world transform recomputed
+ *
+ * The nodes are indices in depth-first order, so that a parent comes before its children and each subtree is
+ * a contiguous range. Marking a node dirty marks its whole subtree, one bit per node. The hierarchy is also
+ * split in batches, ranges of nodes which only depend on nodes outside of them, which may be updated in
+ * parallel once their serial ancestors are.
+ *
+ * It holds no transforms, so that the owner of the matrices decides how they are computed.
+ */
+class TransformHierarchy
+{
+  public:
+	/// Index of the parent of a root node
+	static constexpr uint32_t INVALID_INDEX = ~0u;
+
+	/**
+	 * @brief Builds the hierarchy, all the nodes are then dirty
+	 * @param parents The parent of each node, in depth-first order, INVALID_INDEX for roots
+	 * @param batch_size Maximum number of nodes of a batch, larger subtrees are split
+	 */
+	void build(const std::vector<uint32_t> &parents, uint32_t batch_size);
+
+	void clear();
+
+	uint32_t size() const;
+
+	uint32_t get_parent(uint32_t index) const;
+
+	/**
+	 * @return End of the subtree of a node, its descendants are the nodes in (index, end)
+	 */
+	uint32_t get_subtree_end(uint32_t index) const;
+
+	/**
+	 * @brief Marks the node dirty, and the world transforms of its subtree
+	 */
+	void mark_dirty(uint32_t index);
+
+	/**
+	 * @return Whether the local transform of the node changed
+	 */
+	bool is_local_dirty(uint32_t index) const;
+
+	/**
+	 * @return Whether the transform of the node or of an ancestor changed
+	 */
+	bool is_world_dirty(uint32_t index) const;
+
+	/**
+	 * @return Whether any node is dirty
+	 */
+	bool is_any_dirty() const;
+
+	/**
+	 * @brief Clears the dirty bits of a node, once its world transform was recomputed
+	 */
+	void clear_dirty(uint32_t index);
+
+	/**
+	 * @brief Clears the dirty bits of all the nodes
+	 */
+	void clear_all_dirty();
+
+	/**
+	 * @brief Finds the dirty ancestors of a dirty node, which must be updated before it
+	 * @param index The node
+	 * @param chain Filled with the node and its dirty ancestors, top-down, empty if the node is not dirty
+	 */
+	void get_dirty_chain(uint32_t index, std::vector<uint32_t> &chain) const;
+
+	/**
+	 * @brief Calls a function on the nodes of [begin, end) whose world transform is dirty, in order
+	 */
+	template <typename Function>
+	void for_each_dirty(uint32_t begin, uint32_t end, Function &&function) const;
+
+	/**
+	 * @return The ancestors of the batches, in order, to update before them
+	 */
+	const std::vector<uint32_t> &get_serial_nodes() const;
+
+	/**
+	 * @return The ranges of nodes which only depend on serial nodes
+	 */
+	const std::vector<std::pair<uint32_t, uint32_t>> &get_batches() const;
+
+  private:
+	static bool test(const std::vector<uint64_t> &bits, uint32_t index);
+
+	std::vector<uint32_t> parents;
+
+	std::vector<uint32_t> subtree_ends;
+
+	/// One bit per node, set once the transform of the node changed
+	std::vector<uint64_t> local_dirty;
+
+	/// One bit per node, set once the transform of the node or of an ancestor changed
+	std::vector<uint64_t> world_dirty;
+
+	bool any_dirty{false};
+
+	std::vector<uint32_t> serial_nodes;
+
+	std::vector<std::pair<uint32_t, uint32_t>> batches;
+};
+
+template <typename Function>
+void TransformHierarchy::for_each_dirty(uint32_t begin, uint32_t end, Function &&function) const
+{
+	for (uint32_t i = begin; i < end; i++)
+	{
+		// Skips the words of clean nodes
+		if (i % 64 == 0 && world_dirty[i / 64] == 0)
+		{
+			i += 63;
+			continue;
+		}
+
+		if (test(world_dirty, i))
+		{
+			function(i);
+		}
+	}
+}
+}        // namespace vkb
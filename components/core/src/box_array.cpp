@@ -0,0 +1,75 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/box_array.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace vkb
+{
+void BoxArray::resize(size_t size)
+{
+	center_x.resize(size);
+	center_y.resize(size);
+	center_z.resize(size);
+	extent_x.resize(size);
+	extent_y.resize(size);
+	extent_z.resize(size);
+}
+
+size_t BoxArray::size() const
+{
+	return center_x.size();
+}
+
+void BoxArray::check_planes(const std::array<float, 4> *planes, size_t plane_count, size_t begin, size_t end, uint8_t *visible) const
+{
+	assert(begin <= end && end <= size());
+
+	size_t count = end - begin;
+
+	const float *c_x = center_x.data() + begin;
+	const float *c_y = center_y.data() + begin;
+	const float *c_z = center_z.data() + begin;
+	const float *e_x = extent_x.data() + begin;
+	const float *e_y = extent_y.data() + begin;
+	const float *e_z = extent_z.data() + begin;
+
+	std::fill(visible, visible + count, uint8_t{1});
+
+	// One plane at a time, so that the inner loop runs over the boxes
+	for (size_t p = 0; p < plane_count; p++)
+	{
+		const auto &plane = planes[p];
+
+		// Distance to the plane of the corner furthest along its normal, per unit of extent
+		float abs_x = std::abs(plane[0]);
+		float abs_y = std::abs(plane[1]);
+		float abs_z = std::abs(plane[2]);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			float distance = plane[0] * c_x[i] + plane[1] * c_y[i] + plane[2] * c_z[i] + plane[3];
+			float radius   = abs_x * e_x[i] + abs_y * e_y[i] + abs_z * e_z[i];
+
+			visible[i] &= static_cast<uint8_t>(distance + radius > 0.0f);
+		}
+	}
+}
+}        // namespace vkb
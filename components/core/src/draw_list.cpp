@@ -0,0 +1,123 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/draw_list.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace vkb
+{
+uint32_t DrawList::to_sortable(float value)
+{
+	// The bits of positive floats are ordered like their values
+	if (!(value > 0.0f))
+	{
+		return 0;
+	}
+
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+uint64_t DrawList::make_state_key(uint64_t variant_id, uint64_t material_id, uint64_t sub_mesh_id)
+{
+	return (std::min<uint64_t>(variant_id, 0xFFFF) << 47) |
+	       (std::min<uint64_t>(material_id, 0x7FFF) << 32) |
+	       (std::min<uint64_t>(sub_mesh_id, 0xFFFF) << 15);
+}
+
+uint64_t DrawList::make_opaque_key(uint64_t state_key, bool flipped, float distance)
+{
+	// The 15 most significant bits of the distance, its sign bit is always 0
+	return state_key | (static_cast<uint64_t>(flipped) << 31) | (to_sortable(distance) >> 17);
+}
+
+uint64_t DrawList::make_transparent_key(float distance)
+{
+	return (1ull << 63) | (static_cast<uint64_t>(~to_sortable(distance)) << 31);
+}
+
+bool DrawList::is_transparent(uint64_t key)
+{
+	return (key >> 63) != 0;
+}
+
+uint64_t DrawList::get_group(uint64_t key)
+{
+	return key >> 15;
+}
+
+void DrawList::clear()
+{
+	entries.clear();
+}
+
+void DrawList::push_back(uint64_t key, uint32_t index)
+{
+	entries.push_back({key, index});
+}
+
+void DrawList::sort()
+{
+	if (entries.size() < 2)
+	{
+		return;
+	}
+
+	scratch.resize(entries.size());
+
+	// Least significant digit first, each pass is stable so it keeps the order of the previous ones
+	for (uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		std::array<size_t, 256> offsets{};
+
+		for (auto &entry : entries)
+		{
+			offsets[(entry.key >> shift) & 0xFF]++;
+		}
+
+		// Skip the digits shared by all the keys, such as the unused bits
+		if (offsets[(entries.front().key >> shift) & 0xFF] == entries.size())
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (auto &count : offsets)
+		{
+			size_t digit_count = count;
+			count              = offset;
+			offset += digit_count;
+		}
+
+		for (auto &entry : entries)
+		{
+			scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+		}
+
+		entries.swap(scratch);
+	}
+}
+
+const std::vector<DrawList::Entry> &DrawList::get_entries() const
+{
+	return entries;
+}
+}        // namespace vkb
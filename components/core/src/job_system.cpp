@@ -0,0 +1,427 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/util/job_system.hpp"
+
+#include <cassert>
+
+namespace vkb
+{
+namespace
+{
+std::atomic<JobSystem *> instance{nullptr};
+
+/// Job system of the worker running the calling thread, if any
+thread_local const JobSystem *current_job_system{nullptr};
+
+thread_local size_t current_worker_index{0};
+}        // namespace
+
+class JobSystem::Job
+{
+  public:
+	Job(std::function<void()> &&func, bool background) :
+	    func{std::move(func)}, background{background}
+	{}
+
+	std::function<void()> func;
+
+	const bool background;
+
+	/// Dependencies still running, plus one held while the job is being scheduled
+	std::atomic<uint32_t> pending_dependencies{1};
+
+	std::atomic<bool> complete{false};
+
+	/// Set before complete, read after it
+	std::exception_ptr exception;
+
+	/// Guards continuations against the completion of the job
+	std::mutex mutex;
+
+	std::vector<JobHandle> continuations;
+};
+
+JobSystem::JobSystem(size_t worker_count)
+{
+	if (worker_count == 0)
+	{
+		auto hardware_thread_count = std::thread::hardware_concurrency();
+		worker_count               = hardware_thread_count > 1 ? hardware_thread_count - 1 : 1;
+	}
+
+	for (size_t i = 0; i < worker_count; i++)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+
+	// Workers are only started once all the deques exist, as they steal from each other
+	for (size_t i = 0; i < worker_count; i++)
+	{
+		workers[i]->thread = std::thread([this, i]() { worker_loop(i); });
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		stopping = true;
+	}
+	wake_condition.notify_all();
+
+	for (auto &worker : workers)
+	{
+		worker->thread.join();
+	}
+}
+
+void JobSystem::set_instance(JobSystem *job_system)
+{
+	instance = job_system;
+}
+
+JobSystem &JobSystem::get()
+{
+	if (auto job_system = instance.load())
+	{
+		return *job_system;
+	}
+
+	// Tools using the framework without a Platform
+	static JobSystem default_job_system;
+	return default_job_system;
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> &&func, const std::vector<JobHandle> &dependencies)
+{
+	auto job = std::make_shared<Job>(std::move(func), false);
+
+	for (auto &dependency : dependencies)
+	{
+		std::lock_guard<std::mutex> lock(dependency->mutex);
+
+		if (!dependency->complete)
+		{
+			job->pending_dependencies++;
+			dependency->continuations.push_back(job);
+		}
+	}
+
+	release_dependency(job);
+
+	return job;
+}
+
+JobSystem::JobHandle JobSystem::then(const JobHandle &job, std::function<void()> &&func)
+{
+	return schedule(std::move(func), {job});
+}
+
+JobSystem::JobHandle JobSystem::schedule_background(std::function<void()> &&func)
+{
+	auto job = std::make_shared<Job>(std::move(func), true);
+
+	release_dependency(job);
+
+	return job;
+}
+
+bool JobSystem::is_complete(const JobHandle &job) const
+{
+	return job->complete;
+}
+
+void JobSystem::wait(const JobHandle &job)
+{
+	size_t worker_index = get_current_worker_index();
+
+	while (!job->complete)
+	{
+		if (auto other_job = pop_job(worker_index))
+		{
+			run(other_job, worker_index);
+			continue;
+		}
+
+		// Background jobs have no dependencies, so they are queued as soon as they are scheduled
+		if (job->background && take_background_job(job))
+		{
+			run(job, worker_index);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex);
+
+		waiting_thread_count++;
+		wake_condition.wait(lock, [this, &job]() { return job->complete || queued_job_count > 0; });
+		waiting_thread_count--;
+	}
+
+	if (job->exception)
+	{
+		std::rethrow_exception(job->exception);
+	}
+}
+
+void JobSystem::wait(const std::vector<JobHandle> &jobs)
+{
+	std::exception_ptr exception;
+
+	for (auto &job : jobs)
+	{
+		try
+		{
+			wait(job);
+		}
+		catch (...)
+		{
+			if (!exception)
+			{
+				exception = std::current_exception();
+			}
+		}
+	}
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+size_t JobSystem::get_worker_count() const
+{
+	return workers.size();
+}
+
+size_t JobSystem::get_current_worker_index() const
+{
+	return current_job_system == this ? current_worker_index : workers.size();
+}
+
+std::chrono::nanoseconds JobSystem::get_busy_time(size_t worker_index) const
+{
+	assert(worker_index < workers.size() && "Worker index is out of bounds");
+
+	return std::chrono::nanoseconds{workers[worker_index]->busy_time.load()};
+}
+
+void JobSystem::reset_busy_times()
+{
+	for (auto &worker : workers)
+	{
+		worker->busy_time = 0;
+	}
+}
+
+void JobSystem::worker_loop(size_t worker_index)
+{
+	current_job_system   = this;
+	current_worker_index = worker_index;
+
+	while (true)
+	{
+		if (auto job = pop_job(worker_index))
+		{
+			run(job, worker_index);
+			continue;
+		}
+
+		if (auto job = pop_background_job())
+		{
+			run(job, worker_index);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex);
+
+		wake_condition.wait(lock, [this]() { return stopping || queued_job_count > 0 || queued_background_job_count > 0; });
+
+		if (stopping && queued_job_count == 0 && queued_background_job_count == 0)
+		{
+			return;
+		}
+	}
+}
+
+void JobSystem::enqueue(const JobHandle &job)
+{
+	if (job->background)
+	{
+		{
+			std::lock_guard<std::mutex> lock(background_mutex);
+			background_jobs.push_back(job);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex);
+			queued_background_job_count++;
+		}
+
+		// Waiting threads may be woken first, but only workers can run the job
+		wake_condition.notify_all();
+		return;
+	}
+
+	size_t worker_index = get_current_worker_index();
+
+	if (worker_index == workers.size())
+	{
+		worker_index = next_worker++ % workers.size();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(workers[worker_index]->mutex);
+		workers[worker_index]->jobs.push_back(job);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		queued_job_count++;
+	}
+
+	wake_condition.notify_one();
+}
+
+JobSystem::JobHandle JobSystem::pop_job(size_t worker_index)
+{
+	if (queued_job_count == 0)
+	{
+		return nullptr;
+	}
+
+	// The most recent job of the worker is the most likely to find its data in cache
+	if (worker_index < workers.size())
+	{
+		auto &worker = *workers[worker_index];
+
+		std::lock_guard<std::mutex> lock(worker.mutex);
+
+		if (!worker.jobs.empty())
+		{
+			auto job = std::move(worker.jobs.back());
+			worker.jobs.pop_back();
+			queued_job_count--;
+			return job;
+		}
+	}
+
+	for (size_t i = 1; i <= workers.size(); i++)
+	{
+		auto &victim = *workers[(worker_index + i) % workers.size()];
+
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if (!victim.jobs.empty())
+		{
+			auto job = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+			queued_job_count--;
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+JobSystem::JobHandle JobSystem::pop_background_job()
+{
+	if (queued_background_job_count == 0)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(background_mutex);
+
+	if (background_jobs.empty())
+	{
+		return nullptr;
+	}
+
+	auto job = std::move(background_jobs.front());
+	background_jobs.pop_front();
+	queued_background_job_count--;
+	return job;
+}
+
+bool JobSystem::take_background_job(const JobHandle &job)
+{
+	std::lock_guard<std::mutex> lock(background_mutex);
+
+	auto it = std::find(background_jobs.begin(), background_jobs.end(), job);
+
+	if (it == background_jobs.end())
+	{
+		return false;
+	}
+
+	background_jobs.erase(it);
+	queued_background_job_count--;
+	return true;
+}
+
+void JobSystem::run(const JobHandle &job, size_t worker_index)
+{
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		job->func();
+	}
+	catch (...)
+	{
+		job->exception = std::current_exception();
+	}
+
+	// Release the captures as soon as possible, the handle may be kept for a long time
+	job->func = nullptr;
+
+	if (worker_index < workers.size())
+	{
+		workers[worker_index]->busy_time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+	}
+
+	std::vector<JobHandle> continuations;
+
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		job->complete = true;
+		continuations.swap(job->continuations);
+	}
+
+	for (auto &continuation : continuations)
+	{
+		release_dependency(continuation);
+	}
+
+	if (waiting_thread_count > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex);
+		}
+		wake_condition.notify_all();
+	}
+}
+
+void JobSystem::release_dependency(const JobHandle &job)
+{
+	if (--job->pending_dependencies == 0)
+	{
+		enqueue(job);
+	}
+}
+}        // namespace vkb
@@ -17,7 +17,14 @@
 
 #include "core/util/profiling.hpp"
 
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/util/logging.hpp"
 
 #ifdef TRACY_ENABLE
 void *operator new(size_t count)
@@ -33,3 +40,379 @@ void operator delete(void *ptr) noexcept
 	free(ptr);
 }
 #endif
+
+namespace vkb
+{
+PlotRegistry &PlotRegistry::get()
+{
+	static PlotRegistry registry;
+	return registry;
+}
+
+PlotSlot &PlotRegistry::resolve(const char *name, PlotType type, bool floating)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto count = slot_count.load(std::memory_order_relaxed);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (std::strncmp(slots[i].name, name, PlotSlot::MAX_NAME_LENGTH) == 0)
+		{
+			if (slots[i].floating != floating)
+			{
+				// Reading the bits of one type as the other would report garbage
+				if (overflow_slots[floating].name[0] == '\0')
+				{
+					LOGE("Plot {} is used with both integer and floating point values, the values of the other type and the next mismatched plots share an overflow slot", name);
+				}
+				return get_overflow_slot(floating);
+			}
+			return slots[i];
+		}
+	}
+
+	if (count == MAX_PLOTS)
+	{
+		if (overflow_slots[floating].name[0] == '\0')
+		{
+			LOGW("Too many plots, plot {} and the next ones share an overflow slot", name);
+		}
+		return get_overflow_slot(floating);
+	}
+
+	auto &slot = slots[count];
+	std::strncpy(slot.name, name, PlotSlot::MAX_NAME_LENGTH);
+	slot.type     = type;
+	slot.floating = floating;
+	slot.bits.store(0, std::memory_order_relaxed);
+
+#ifdef TRACY_ENABLE
+	TracyPlotConfig(slot.name, TO_TRACY_PLOT_FORMAT(type), true, true, 0);
+#endif
+
+	// Snapshots read the slots without the lock, up to the published count
+	slot_count.store(count + 1, std::memory_order_release);
+
+	return slot;
+}
+
+PlotSlot &PlotRegistry::get_overflow_slot(bool floating)
+{
+	auto &slot = overflow_slots[floating];
+
+	if (slot.name[0] == '\0')
+	{
+		std::strncpy(slot.name, "Plot Overflow", PlotSlot::MAX_NAME_LENGTH);
+		slot.floating = floating;
+	}
+
+	return slot;
+}
+
+std::vector<PlotValue> PlotRegistry::snapshot() const
+{
+	auto count = slot_count.load(std::memory_order_acquire);
+
+	std::vector<PlotValue> values;
+	values.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		auto    &slot = slots[i];
+		uint64_t bits = slot.bits.load(std::memory_order_relaxed);
+
+		double value;
+		if (slot.floating)
+		{
+			std::memcpy(&value, &bits, sizeof(value));
+		}
+		else
+		{
+			value = static_cast<double>(static_cast<int64_t>(bits));
+		}
+
+		values.push_back({slot.name, slot.type, value});
+	}
+
+	return values;
+}
+
+namespace trace
+{
+namespace
+{
+struct Event
+{
+	enum class Type : uint32_t
+	{
+		Scope,
+		Counter
+	};
+
+	const char *name;
+
+	Type type;
+
+	/// Time of the event, the beginning of a scope
+	uint64_t timestamp;
+
+	/// End of a scope, unused for a counter
+	uint64_t end;
+
+	/// Value of a counter, unused for a scope
+	double value;
+};
+
+/**
+ * @brief Single producer, single consumer ring of events
+ *        The thread owning the buffer pushes events, the thread writing the trace file drains them
+ */
+class ThreadBuffer
+{
+  public:
+	static constexpr uint64_t CAPACITY = 16 * 1024;
+
+	explicit ThreadBuffer(uint32_t thread_id) :
+	    thread_id{thread_id}, events(CAPACITY)
+	{}
+
+	void push(const Event &event)
+	{
+		auto head_index = head.load(std::memory_order_relaxed);
+
+		// Events are dropped rather than blocking the recording thread until the ring is drained
+		if (head_index - tail.load(std::memory_order_acquire) >= CAPACITY)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		events[head_index % CAPACITY] = event;
+		head.store(head_index + 1, std::memory_order_release);
+	}
+
+	template <typename Func>
+	void drain(Func &&func)
+	{
+		auto tail_index = tail.load(std::memory_order_relaxed);
+		auto head_index = head.load(std::memory_order_acquire);
+
+		for (; tail_index != head_index; tail_index++)
+		{
+			func(events[tail_index % CAPACITY]);
+		}
+
+		tail.store(tail_index, std::memory_order_release);
+	}
+
+	uint64_t take_dropped()
+	{
+		return dropped.exchange(0, std::memory_order_relaxed);
+	}
+
+	const uint32_t thread_id;
+
+  private:
+	std::vector<Event> events;
+
+	std::atomic<uint64_t> head{0};
+
+	std::atomic<uint64_t> tail{0};
+
+	std::atomic<uint64_t> dropped{0};
+};
+
+class Recorder
+{
+  public:
+	~Recorder()
+	{
+		stop();
+	}
+
+	bool start(const std::string &path)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		close_file();
+
+		file = std::fopen(path.c_str(), "w");
+		if (!file)
+		{
+			LOGE("Failed to create trace file {}", path);
+			return false;
+		}
+
+		std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+		first_event = true;
+
+		// Discard the events of a previous recording which were never written
+		for (auto &buffer : buffers)
+		{
+			buffer->drain([](const Event &) {});
+			buffer->take_dropped();
+		}
+
+		start_time = detail::now();
+		detail::recording.store(true, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	void stop()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		detail::recording.store(false, std::memory_order_relaxed);
+		close_file();
+	}
+
+	void flush()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (file)
+		{
+			write_events();
+			std::fflush(file);
+		}
+	}
+
+	ThreadBuffer &get_thread_buffer()
+	{
+		// The recorder keeps the buffer alive after the thread exits, until its events are written
+		thread_local std::shared_ptr<ThreadBuffer> thread_buffer;
+
+		if (!thread_buffer)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			thread_buffer = std::make_shared<ThreadBuffer>(static_cast<uint32_t>(buffers.size()));
+			buffers.push_back(thread_buffer);
+		}
+
+		return *thread_buffer;
+	}
+
+  private:
+	void close_file()
+	{
+		if (!file)
+		{
+			return;
+		}
+
+		write_events();
+
+		std::fputs("\n]}\n", file);
+		std::fclose(file);
+		file = nullptr;
+	}
+
+	void write_events()
+	{
+		uint64_t dropped = 0;
+
+		for (auto &buffer : buffers)
+		{
+			buffer->drain([&](const Event &event) { write_event(buffer->thread_id, event); });
+			dropped += buffer->take_dropped();
+		}
+
+		if (dropped > 0)
+		{
+			LOGW("Trace buffers full, {} events were dropped", dropped);
+		}
+	}
+
+	void write_event(uint32_t thread_id, const Event &event)
+	{
+		// Scopes which began before the recording started are incomplete
+		if (event.timestamp < start_time)
+		{
+			return;
+		}
+
+		std::fputs(first_event ? "\n{\"name\":\"" : ",\n{\"name\":\"", file);
+		first_event = false;
+
+		for (auto *c = event.name; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				std::fputc('\\', file);
+			}
+			std::fputc(*c, file);
+		}
+
+		// Timestamps are written in microseconds
+		double timestamp = static_cast<double>(event.timestamp - start_time) / 1000.0;
+
+		if (event.type == Event::Type::Scope)
+		{
+			double duration = static_cast<double>(event.end - event.timestamp) / 1000.0;
+			std::fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", thread_id, timestamp, duration);
+		}
+		else
+		{
+			std::fprintf(file, "\",\"ph\":\"C\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%.17g}}", thread_id, timestamp, event.value);
+		}
+	}
+
+	/// Guards the file and the list of buffers
+	std::mutex mutex;
+
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+	std::FILE *file{nullptr};
+
+	bool first_event{true};
+
+	uint64_t start_time{0};
+};
+
+Recorder &get_recorder()
+{
+	// Destroyed at exit, which completes the trace file
+	static Recorder recorder;
+	return recorder;
+}
+}        // namespace
+
+namespace detail
+{
+std::atomic<bool> recording{false};
+
+uint64_t now()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void record_scope(const char *name, uint64_t begin, uint64_t end)
+{
+	get_recorder().get_thread_buffer().push({name, Event::Type::Scope, begin, end, 0.0});
+}
+
+void record_counter(const char *name, double value)
+{
+	get_recorder().get_thread_buffer().push({name, Event::Type::Counter, now(), 0, value});
+}
+}        // namespace detail
+
+bool start(const std::string &path)
+{
+	return get_recorder().start(path);
+}
+
+void stop()
+{
+	get_recorder().stop();
+}
+
+void flush()
+{
+	get_recorder().flush();
+}
+}        // namespace trace
+}        // namespace vkb
@@ -0,0 +1,194 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/transform_hierarchy.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace vkb
+{
+void TransformHierarchy::build(const std::vector<uint32_t> &parents_, uint32_t batch_size)
+{
+	clear();
+
+	parents = parents_;
+
+	uint32_t node_count = static_cast<uint32_t>(parents.size());
+
+	// Descendants come after their ancestors, so the ends are propagated up backwards
+	subtree_ends.resize(node_count);
+	for (uint32_t i = 0; i < node_count; i++)
+	{
+		assert((parents[i] == INVALID_INDEX || parents[i] < i) && "Nodes must be in depth-first order");
+
+		subtree_ends[i] = i + 1;
+	}
+	for (uint32_t i = node_count; i-- > 0;)
+	{
+		if (parents[i] != INVALID_INDEX)
+		{
+			subtree_ends[parents[i]] = std::max(subtree_ends[parents[i]], subtree_ends[i]);
+		}
+	}
+
+	local_dirty.assign((node_count + 63) / 64, ~0ull);
+	world_dirty.assign((node_count + 63) / 64, ~0ull);
+
+	any_dirty = node_count > 0;
+
+	// Subtrees small enough are batches, merged with the previous batch while they fit, their ancestors are serial
+	for (uint32_t i = 0; i < node_count;)
+	{
+		if (subtree_ends[i] - i > batch_size)
+		{
+			serial_nodes.push_back(i);
+			i++;
+		}
+		else
+		{
+			if (!batches.empty() && batches.back().second == i && subtree_ends[i] - batches.back().first <= batch_size)
+			{
+				batches.back().second = subtree_ends[i];
+			}
+			else
+			{
+				batches.emplace_back(i, subtree_ends[i]);
+			}
+			i = subtree_ends[i];
+		}
+	}
+}
+
+void TransformHierarchy::clear()
+{
+	parents.clear();
+	subtree_ends.clear();
+	local_dirty.clear();
+	world_dirty.clear();
+	serial_nodes.clear();
+	batches.clear();
+
+	any_dirty = false;
+}
+
+uint32_t TransformHierarchy::size() const
+{
+	return static_cast<uint32_t>(parents.size());
+}
+
+uint32_t TransformHierarchy::get_parent(uint32_t index) const
+{
+	return parents[index];
+}
+
+uint32_t TransformHierarchy::get_subtree_end(uint32_t index) const
+{
+	return subtree_ends[index];
+}
+
+void TransformHierarchy::mark_dirty(uint32_t index)
+{
+	local_dirty[index / 64] |= 1ull << (index % 64);
+
+	any_dirty = true;
+
+	// The subtree of a dirty node is already dirty
+	if (test(world_dirty, index))
+	{
+		return;
+	}
+
+	uint32_t end = subtree_ends[index];
+
+	for (uint32_t i = index; i < end;)
+	{
+		if (i % 64 == 0 && end - i >= 64)
+		{
+			world_dirty[i / 64] = ~0ull;
+			i += 64;
+		}
+		else
+		{
+			world_dirty[i / 64] |= 1ull << (i % 64);
+			i++;
+		}
+	}
+}
+
+bool TransformHierarchy::is_local_dirty(uint32_t index) const
+{
+	return test(local_dirty, index);
+}
+
+bool TransformHierarchy::is_world_dirty(uint32_t index) const
+{
+	return test(world_dirty, index);
+}
+
+bool TransformHierarchy::is_any_dirty() const
+{
+	return any_dirty;
+}
+
+void TransformHierarchy::clear_dirty(uint32_t index)
+{
+	local_dirty[index / 64] &= ~(1ull << (index % 64));
+	world_dirty[index / 64] &= ~(1ull << (index % 64));
+}
+
+void TransformHierarchy::clear_all_dirty()
+{
+	std::fill(local_dirty.begin(), local_dirty.end(), 0);
+	std::fill(world_dirty.begin(), world_dirty.end(), 0);
+
+	any_dirty = false;
+}
+
+void TransformHierarchy::get_dirty_chain(uint32_t index, std::vector<uint32_t> &chain) const
+{
+	chain.clear();
+
+	if (!test(world_dirty, index))
+	{
+		return;
+	}
+
+	// The dirty ancestors of a dirty node form a chain up from it
+	for (uint32_t i = index; i != INVALID_INDEX && test(world_dirty, i); i = parents[i])
+	{
+		chain.push_back(i);
+	}
+
+	std::reverse(chain.begin(), chain.end());
+}
+
+const std::vector<uint32_t> &TransformHierarchy::get_serial_nodes() const
+{
+	return serial_nodes;
+}
+
+const std::vector<std::pair<uint32_t, uint32_t>> &TransformHierarchy::get_batches() const
+{
+	return batches;
+}
+
+bool TransformHierarchy::test(const std::vector<uint64_t> &bits, uint32_t index)
+{
+	return (bits[index / 64] >> (index % 64)) & 1;
+}
+}        // namespace vkb
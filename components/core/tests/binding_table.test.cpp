@@ -0,0 +1,153 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <core/util/binding_table.hpp>
+
+using namespace vkb;
+
+namespace
+{
+std::vector<std::pair<uint32_t, int>> collect(const BindingTable<int, 8> &table)
+{
+	std::vector<std::pair<uint32_t, int>> values;
+	table.for_each([&values](uint32_t index, int value) { values.emplace_back(index, value); });
+	return values;
+}
+
+// Resources bound per draw in a typical sample: a few sets with a few bindings each
+const uint32_t DRAW_SETS     = 3;
+const uint32_t DRAW_BINDINGS = 4;
+}        // namespace
+
+TEST_CASE("vkb::BindingTable tracks indices in use", "[binding_table]")
+{
+	BindingTable<int, 8> table;
+
+	REQUIRE(table.empty());
+	REQUIRE(table.find(3) == nullptr);
+
+	table[3] = 30;
+	table[0] = 10;
+
+	REQUIRE(!table.empty());
+	REQUIRE(table.get_mask() == 0b1001);
+	REQUIRE(table.find(1) == nullptr);
+	REQUIRE(*table.find(3) == 30);
+
+	std::vector<std::pair<uint32_t, int>> expected{{0, 10}, {3, 30}};
+	REQUIRE(collect(table) == expected);
+}
+
+TEST_CASE("vkb::BindingTable falls back to a map beyond its capacity", "[binding_table]")
+{
+	BindingTable<int, 8> table;
+
+	table[40] = 400;
+	table[8]  = 80;
+	table[7]  = 70;
+
+	// Indices beyond the capacity are not part of the mask, but are found and visited in order
+	REQUIRE(table.get_mask() == 0b10000000);
+	REQUIRE(*table.find(8) == 80);
+	REQUIRE(*table.find(40) == 400);
+	REQUIRE(table.find(9) == nullptr);
+
+	std::vector<std::pair<uint32_t, int>> expected{{7, 70}, {8, 80}, {40, 400}};
+	REQUIRE(collect(table) == expected);
+
+	table.clear();
+
+	REQUIRE(table.empty());
+	REQUIRE(table.find(8) == nullptr);
+	REQUIRE(collect(table).empty());
+}
+
+TEST_CASE("vkb::BindingTable keeps array values on clear", "[binding_table]")
+{
+	BindingTable<std::vector<int>, 8> table;
+
+	table[2].resize(16);
+	auto capacity = table[2].capacity();
+	table[2].clear();
+
+	table.clear();
+
+	REQUIRE(table.find(2) == nullptr);
+
+	// The storage of the value is reused when the index is used again
+	REQUIRE(table[2].capacity() == capacity);
+}
+
+TEST_CASE("vkb::BindingTable per-draw binding lookup", "[binding_table][.benchmark]")
+{
+	BindingTable<BindingTable<std::vector<int>, 32>, 8>                            table;
+	std::unordered_map<uint32_t, std::unordered_map<uint32_t, std::vector<int>>> map;
+
+	for (uint32_t set = 0; set < DRAW_SETS; ++set)
+	{
+		for (uint32_t binding = 0; binding < DRAW_BINDINGS; ++binding)
+		{
+			table[set][binding].push_back(1);
+			map[set][binding].push_back(1);
+		}
+	}
+
+	BENCHMARK("BindingTable")
+	{
+		int sum = 0;
+		for (uint32_t set = 0; set < DRAW_SETS; ++set)
+		{
+			for (uint32_t binding = 0; binding < DRAW_BINDINGS; ++binding)
+			{
+				table[set][binding][0] = static_cast<int>(binding);
+			}
+		}
+		table.for_each([&sum](uint32_t, const BindingTable<std::vector<int>, 32> &bindings) {
+			bindings.for_each([&sum](uint32_t, const std::vector<int> &values) { sum += values[0]; });
+		});
+		return sum;
+	};
+
+	BENCHMARK("std::unordered_map")
+	{
+		int sum = 0;
+		for (uint32_t set = 0; set < DRAW_SETS; ++set)
+		{
+			for (uint32_t binding = 0; binding < DRAW_BINDINGS; ++binding)
+			{
+				map[set][binding][0] = static_cast<int>(binding);
+			}
+		}
+		for (auto &set_it : map)
+		{
+			for (auto &binding_it : set_it.second)
+			{
+				sum += binding_it.second[0];
+			}
+		}
+		return sum;
+	};
+}
@@ -0,0 +1,89 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <vector>
+
+#include <core/util/box_array.hpp>
+
+using namespace vkb;
+
+namespace
+{
+struct Vec3
+{
+	float x;
+	float y;
+	float z;
+};
+
+// The planes bounding the cube from -1 to 1, with their normals pointing inside
+const std::array<std::array<float, 4>, 6> CUBE_PLANES{{{1.0f, 0.0f, 0.0f, 1.0f},
+                                                       {-1.0f, 0.0f, 0.0f, 1.0f},
+                                                       {0.0f, 1.0f, 0.0f, 1.0f},
+                                                       {0.0f, -1.0f, 0.0f, 1.0f},
+                                                       {0.0f, 0.0f, 1.0f, 1.0f},
+                                                       {0.0f, 0.0f, -1.0f, 1.0f}}};
+}        // namespace
+
+TEST_CASE("vkb::BoxArray checks boxes against planes", "[box_array]")
+{
+	BoxArray boxes;
+	boxes.resize(5);
+
+	boxes.set(0, Vec3{0.0f, 0.0f, 0.0f}, Vec3{0.1f, 0.1f, 0.1f});          // Inside
+	boxes.set(1, Vec3{1.5f, 0.0f, 0.0f}, Vec3{1.0f, 1.0f, 1.0f});          // Crossing a plane
+	boxes.set(2, Vec3{3.0f, 0.0f, 0.0f}, Vec3{1.0f, 1.0f, 1.0f});          // Outside along x
+	boxes.set(3, Vec3{0.0f, 0.0f, -5.0f}, Vec3{1.0f, 1.0f, 1.0f});         // Outside along z
+	boxes.set(4, Vec3{0.0f, 0.0f, 0.0f}, Vec3{10.0f, 10.0f, 10.0f});       // Containing the volume
+
+	std::vector<uint8_t> visible(boxes.size(), 2);
+	boxes.check_planes(CUBE_PLANES.data(), CUBE_PLANES.size(), 0, boxes.size(), visible.data());
+
+	std::vector<uint8_t> expected{1, 1, 0, 0, 1};
+	REQUIRE(visible == expected);
+}
+
+TEST_CASE("vkb::BoxArray checks a range of boxes", "[box_array]")
+{
+	BoxArray boxes;
+	boxes.resize(4);
+
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		// Boxes at x = 0, 2, 4 and 6, only the first one reaches the cube
+		boxes.set(i, Vec3{2.0f * static_cast<float>(i), 0.0f, 0.0f}, Vec3{0.5f, 0.5f, 0.5f});
+	}
+
+	// Only the values of the range are written
+	std::vector<uint8_t> visible(3, 2);
+	boxes.check_planes(CUBE_PLANES.data(), CUBE_PLANES.size(), 1, 3, visible.data());
+
+	std::vector<uint8_t> expected{0, 0, 2};
+	REQUIRE(visible == expected);
+
+	boxes.check_planes(CUBE_PLANES.data(), CUBE_PLANES.size(), 0, 1, visible.data());
+	REQUIRE(visible[0] == 1);
+
+	// An empty range writes nothing
+	boxes.check_planes(CUBE_PLANES.data(), CUBE_PLANES.size(), 4, 4, visible.data());
+	REQUIRE(visible[0] == 1);
+}
@@ -0,0 +1,128 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include <core/util/draw_list.hpp>
+
+using namespace vkb;
+
+namespace
+{
+std::vector<uint32_t> sorted_indices(DrawList &draw_list)
+{
+	draw_list.sort();
+
+	std::vector<uint32_t> indices;
+	for (auto &entry : draw_list.get_entries())
+	{
+		indices.push_back(entry.index);
+	}
+	return indices;
+}
+}        // namespace
+
+TEST_CASE("vkb::DrawList sorts opaque draws front-to-back", "[draw_list]")
+{
+	DrawList draw_list;
+
+	auto state = DrawList::make_state_key(0, 0, 0);
+
+	draw_list.push_back(DrawList::make_opaque_key(state, false, 50.0f), 0);
+	draw_list.push_back(DrawList::make_opaque_key(state, false, 1.0f), 1);
+	draw_list.push_back(DrawList::make_opaque_key(state, false, 8.0f), 2);
+
+	std::vector<uint32_t> expected{1, 2, 0};
+	REQUIRE(sorted_indices(draw_list) == expected);
+}
+
+TEST_CASE("vkb::DrawList sorts transparent draws back-to-front after the opaque ones", "[draw_list]")
+{
+	DrawList draw_list;
+
+	auto state = DrawList::make_state_key(0xFFFF, 0x7FFF, 0xFFFF);
+
+	draw_list.push_back(DrawList::make_transparent_key(1.0f), 0);
+	draw_list.push_back(DrawList::make_opaque_key(state, true, 1000.0f), 1);
+	draw_list.push_back(DrawList::make_transparent_key(20.0f), 2);
+
+	REQUIRE(DrawList::is_transparent(DrawList::make_transparent_key(0.0f)));
+	REQUIRE(!DrawList::is_transparent(DrawList::make_opaque_key(state, true, 1000.0f)));
+
+	std::vector<uint32_t> expected{1, 2, 0};
+	REQUIRE(sorted_indices(draw_list) == expected);
+}
+
+TEST_CASE("vkb::DrawList groups opaque draws by state before distance", "[draw_list]")
+{
+	DrawList draw_list;
+
+	auto first_variant  = DrawList::make_state_key(0, 1, 0);
+	auto second_variant = DrawList::make_state_key(1, 0, 0);
+
+	// The shader variant comes first, then the material, then the submesh
+	draw_list.push_back(DrawList::make_opaque_key(second_variant, false, 1.0f), 0);
+	draw_list.push_back(DrawList::make_opaque_key(first_variant, false, 100.0f), 1);
+	draw_list.push_back(DrawList::make_opaque_key(DrawList::make_state_key(0, 0, 2), false, 100.0f), 2);
+	draw_list.push_back(DrawList::make_opaque_key(DrawList::make_state_key(0, 1, 1), false, 1.0f), 3);
+
+	std::vector<uint32_t> expected{2, 1, 3, 0};
+	REQUIRE(sorted_indices(draw_list) == expected);
+}
+
+TEST_CASE("vkb::DrawList groups the instances of a submesh by front face", "[draw_list]")
+{
+	auto state = DrawList::make_state_key(3, 2, 1);
+
+	auto near_key    = DrawList::make_opaque_key(state, false, 1.0f);
+	auto far_key     = DrawList::make_opaque_key(state, false, 300.0f);
+	auto flipped_key = DrawList::make_opaque_key(state, true, 1.0f);
+
+	// Instances at any distance are drawn together, unless their front face differs
+	REQUIRE(DrawList::get_group(near_key) == DrawList::get_group(far_key));
+	REQUIRE(DrawList::get_group(near_key) != DrawList::get_group(flipped_key));
+	REQUIRE(DrawList::get_group(near_key) != DrawList::get_group(DrawList::make_opaque_key(DrawList::make_state_key(3, 2, 2), false, 1.0f)));
+
+	// Ids beyond the bits of the keys are clamped, so callers also compare the submeshes
+	REQUIRE(DrawList::make_state_key(0, 0, 0x10000) == DrawList::make_state_key(0, 0, 0x20000));
+}
+
+TEST_CASE("vkb::DrawList keeps the order of equal keys", "[draw_list]")
+{
+	DrawList draw_list;
+
+	// Negative distances, such as the camera inside a bounding box, count as 0
+	REQUIRE(DrawList::to_sortable(-1.0f) == 0);
+
+	auto key = DrawList::make_opaque_key(DrawList::make_state_key(1, 1, 1), false, 0.0f);
+
+	draw_list.push_back(DrawList::make_opaque_key(DrawList::make_state_key(1, 1, 1), false, -2.0f), 0);
+	draw_list.push_back(key, 1);
+	draw_list.push_back(DrawList::make_opaque_key(DrawList::make_state_key(0, 0, 0), false, 5.0f), 2);
+	draw_list.push_back(key, 3);
+
+	std::vector<uint32_t> expected{2, 0, 1, 3};
+	REQUIRE(sorted_indices(draw_list) == expected);
+
+	// The storage is reused by the next frame
+	draw_list.clear();
+	REQUIRE(draw_list.get_entries().empty());
+}
@@ -0,0 +1,189 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <core/util/job_system.hpp>
+
+using namespace vkb;
+
+// Assertions are only made on the test thread, jobs record what they observed
+
+TEST_CASE("vkb::JobSystem starts a job once its dependencies completed", "[job_system]")
+{
+	JobSystem job_system(3);
+
+	std::atomic<bool> first_done{false};
+	std::atomic<bool> second_done{false};
+	std::atomic<bool> dependencies_done{false};
+	std::atomic<bool> continued{false};
+
+	auto first = job_system.schedule([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		first_done = true;
+	});
+
+	auto second = job_system.schedule([&]() { second_done = true; });
+
+	auto last = job_system.schedule([&]() { dependencies_done = first_done && second_done; }, {first, second});
+
+	auto continuation = job_system.then(last, [&]() { continued = job_system.is_complete(last); });
+
+	job_system.wait(continuation);
+
+	REQUIRE(dependencies_done);
+	REQUIRE(continued);
+}
+
+TEST_CASE("vkb::JobSystem rethrows the exception of a job", "[job_system]")
+{
+	JobSystem job_system(2);
+
+	auto failing = job_system.schedule([]() { throw std::runtime_error("failure"); });
+
+	REQUIRE_THROWS_AS(job_system.wait(failing), std::runtime_error);
+
+	// The continuations of a failed job still run
+	std::atomic<bool> continued{false};
+	job_system.wait(job_system.then(failing, [&]() { continued = true; }));
+	REQUIRE(continued);
+}
+
+TEST_CASE("vkb::JobSystem runs background jobs", "[job_system]")
+{
+	JobSystem job_system(2);
+
+	std::atomic<int> count{0};
+
+	std::vector<JobSystem::JobHandle> jobs;
+	for (int i = 0; i < 16; i++)
+	{
+		jobs.push_back(job_system.schedule_background([&count]() { count++; }));
+	}
+
+	job_system.wait(jobs);
+
+	REQUIRE(count == 16);
+}
+
+TEST_CASE("vkb::JobSystem runs a background job waited for while the workers are busy", "[job_system]")
+{
+	JobSystem job_system(2);
+
+	std::atomic<int>  busy_count{0};
+	std::atomic<bool> release{false};
+
+	// Occupy both workers
+	std::vector<JobSystem::JobHandle> busy_jobs;
+	for (int i = 0; i < 2; i++)
+	{
+		busy_jobs.push_back(job_system.schedule([&]() {
+			busy_count++;
+			while (!release)
+			{
+				std::this_thread::yield();
+			}
+		}));
+	}
+
+	while (busy_count < 2)
+	{
+		std::this_thread::yield();
+	}
+
+	std::atomic<bool> ran{false};
+
+	// No worker is idle, so the waiting thread runs the background job itself
+	job_system.wait(job_system.schedule_background([&ran]() { ran = true; }));
+	REQUIRE(ran);
+
+	release = true;
+	job_system.wait(busy_jobs);
+}
+
+TEST_CASE("vkb::JobSystem does not deadlock when every worker waits for a background job", "[job_system]")
+{
+	JobSystem job_system(2);
+
+	std::atomic<int> count{0};
+
+	std::vector<JobSystem::JobHandle> jobs;
+	for (int i = 0; i < 8; i++)
+	{
+		jobs.push_back(job_system.schedule([&]() {
+			job_system.wait(job_system.schedule_background([&count]() { count++; }));
+		}));
+	}
+
+	job_system.wait(jobs);
+
+	REQUIRE(count == 8);
+}
+
+TEST_CASE("vkb::JobSystem parallel_for calls every index once", "[job_system]")
+{
+	JobSystem job_system(3);
+
+	std::vector<std::atomic<int>> calls(1000);
+
+	job_system.parallel_for(calls.size(), [&calls](size_t index) { calls[index]++; });
+
+	for (auto &call : calls)
+	{
+		REQUIRE(call == 1);
+	}
+}
+
+TEST_CASE("vkb::JobSystem accounts for the time spent by the workers", "[job_system]")
+{
+	JobSystem job_system(1);
+
+	REQUIRE(job_system.get_worker_count() == 1);
+	REQUIRE(job_system.get_current_worker_index() == 1);
+
+	std::atomic<size_t> worker_index{0};
+
+	auto start = std::chrono::steady_clock::now();
+
+	auto job = job_system.schedule([&]() {
+		worker_index = job_system.get_current_worker_index();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	});
+
+	// Polling instead of waiting, as a waiting thread may run the job itself
+	while (!job_system.is_complete(job))
+	{
+		std::this_thread::yield();
+	}
+
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	REQUIRE(worker_index == 0);
+	REQUIRE(job_system.get_busy_time(0) >= std::chrono::milliseconds(20));
+	REQUIRE(job_system.get_busy_time(0) <= elapsed);
+
+	job_system.reset_busy_times();
+	REQUIRE(job_system.get_busy_time(0) == std::chrono::nanoseconds(0));
+}
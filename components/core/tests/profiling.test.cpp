@@ -0,0 +1,91 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <core/util/profiling.hpp>
+
+namespace
+{
+double find_plot_value(const char *name)
+{
+	auto values = vkb::PlotRegistry::get().snapshot();
+	auto it     = std::find_if(values.begin(), values.end(), [name](const vkb::PlotValue &value) { return std::string{value.name} == name; });
+	REQUIRE(it != values.end());
+	return it->value;
+}
+}        // namespace
+
+TEST_CASE("Plot handles and names share a slot", "[profiling]")
+{
+	Plot<int64_t> plot{"test_shared_slot"};
+
+	plot.plot(5);
+	Plot<int64_t>::increment("test_shared_slot", 3);
+	plot.decrement(2);
+
+	REQUIRE(plot.get() == 6);
+	REQUIRE(find_plot_value("test_shared_slot") == 6.0);
+
+	plot.reset();
+	REQUIRE(find_plot_value("test_shared_slot") == 0.0);
+}
+
+TEST_CASE("Plot increments from multiple threads", "[profiling]")
+{
+	Plot<int64_t> integer_plot{"test_threads_integer"};
+	Plot<double>  double_plot{"test_threads_double"};
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; i++)
+	{
+		threads.emplace_back([&]() {
+			for (int j = 0; j < 10000; j++)
+			{
+				integer_plot.increment(1);
+				double_plot.increment(0.5);
+			}
+		});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(integer_plot.get() == 40000);
+	REQUIRE(double_plot.get() == 20000.0);
+}
+
+TEST_CASE("Plot values of another type do not share the slot", "[profiling]")
+{
+	Plot<int64_t> integer_plot{"test_mismatched_type"};
+	Plot<double>  double_plot{"test_mismatched_type"};
+
+	integer_plot.plot(7);
+	double_plot.plot(0.5);
+
+	REQUIRE(integer_plot.get() == 7);
+	REQUIRE(double_plot.get() == 0.5);
+	REQUIRE(find_plot_value("test_mismatched_type") == 7.0);
+}
@@ -0,0 +1,208 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <utility>
+#include <vector>
+
+#include <core/util/transform_hierarchy.hpp>
+
+using namespace vkb;
+
+namespace
+{
+constexpr uint32_t NONE = TransformHierarchy::INVALID_INDEX;
+
+using Batch = std::pair<uint32_t, uint32_t>;
+
+std::vector<uint32_t> dirty_nodes(const TransformHierarchy &hierarchy)
+{
+	std::vector<uint32_t> nodes;
+	hierarchy.for_each_dirty(0, hierarchy.size(), [&nodes](uint32_t index) { nodes.push_back(index); });
+	return nodes;
+}
+
+/**
+ * @brief Depth-first parents of a root with two subtrees
+ *
+ *     0
+ *     +- 1
+ *     |  +- 2
+ *     |  +- 3
+ *     +- 4
+ *        +- 5
+ */
+std::vector<uint32_t> two_subtrees()
+{
+	return {NONE, 0, 1, 1, 0, 4};
+}
+}        // namespace
+
+TEST_CASE("vkb::TransformHierarchy computes the subtrees of depth-first nodes", "[transform_hierarchy]")
+{
+	TransformHierarchy hierarchy;
+	hierarchy.build(two_subtrees(), 512);
+
+	REQUIRE(hierarchy.size() == 6);
+	REQUIRE(hierarchy.get_subtree_end(0) == 6);
+	REQUIRE(hierarchy.get_subtree_end(1) == 4);
+	REQUIRE(hierarchy.get_subtree_end(2) == 3);
+	REQUIRE(hierarchy.get_subtree_end(4) == 6);
+	REQUIRE(hierarchy.get_parent(5) == 4);
+
+	// Everything is dirty after a build
+	std::vector<uint32_t> all_nodes{0, 1, 2, 3, 4, 5};
+	REQUIRE(hierarchy.is_any_dirty());
+	REQUIRE(dirty_nodes(hierarchy) == all_nodes);
+}
+
+TEST_CASE("vkb::TransformHierarchy marks the subtree of a dirty node", "[transform_hierarchy]")
+{
+	TransformHierarchy hierarchy;
+	hierarchy.build(two_subtrees(), 512);
+	hierarchy.clear_all_dirty();
+
+	REQUIRE(!hierarchy.is_any_dirty());
+	REQUIRE(dirty_nodes(hierarchy).empty());
+
+	hierarchy.mark_dirty(1);
+
+	std::vector<uint32_t> subtree{1, 2, 3};
+	REQUIRE(hierarchy.is_any_dirty());
+	REQUIRE(dirty_nodes(hierarchy) == subtree);
+
+	// Only the marked node has a dirty local transform, its ancestors and siblings are untouched
+	REQUIRE(hierarchy.is_local_dirty(1));
+	REQUIRE(!hierarchy.is_local_dirty(2));
+	REQUIRE(!hierarchy.is_world_dirty(0));
+	REQUIRE(!hierarchy.is_world_dirty(4));
+
+	// Marking a node of a dirty subtree only changes its local bit
+	hierarchy.mark_dirty(3);
+
+	REQUIRE(dirty_nodes(hierarchy) == subtree);
+	REQUIRE(hierarchy.is_local_dirty(3));
+}
+
+TEST_CASE("vkb::TransformHierarchy marks large subtrees a word at a time", "[transform_hierarchy]")
+{
+	// A chain of 200 nodes, each the child of the previous one
+	std::vector<uint32_t> parents{NONE};
+	for (uint32_t i = 1; i < 200; i++)
+	{
+		parents.push_back(i - 1);
+	}
+
+	TransformHierarchy hierarchy;
+	hierarchy.build(parents, 512);
+	hierarchy.clear_all_dirty();
+
+	hierarchy.mark_dirty(10);
+
+	auto nodes = dirty_nodes(hierarchy);
+
+	REQUIRE(nodes.size() == 190);
+	REQUIRE(nodes.front() == 10);
+	REQUIRE(nodes.back() == 199);
+	REQUIRE(!hierarchy.is_world_dirty(9));
+}
+
+TEST_CASE("vkb::TransformHierarchy finds the dirty ancestors of a node top-down", "[transform_hierarchy]")
+{
+	TransformHierarchy hierarchy;
+	hierarchy.build(two_subtrees(), 512);
+
+	std::vector<uint32_t> chain;
+
+	hierarchy.get_dirty_chain(3, chain);
+
+	std::vector<uint32_t> root_chain{0, 1, 3};
+	REQUIRE(chain == root_chain);
+
+	// Updating the chain leaves the rest of the subtree dirty
+	for (auto index : chain)
+	{
+		hierarchy.clear_dirty(index);
+	}
+
+	hierarchy.get_dirty_chain(2, chain);
+
+	std::vector<uint32_t> sibling_chain{2};
+	REQUIRE(chain == sibling_chain);
+
+	hierarchy.get_dirty_chain(3, chain);
+	REQUIRE(chain.empty());
+
+	hierarchy.get_dirty_chain(5, chain);
+
+	std::vector<uint32_t> other_subtree_chain{4, 5};
+	REQUIRE(chain == other_subtree_chain);
+}
+
+TEST_CASE("vkb::TransformHierarchy is rebuilt after reparenting", "[transform_hierarchy]")
+{
+	TransformHierarchy hierarchy;
+	hierarchy.build(two_subtrees(), 512);
+	hierarchy.clear_all_dirty();
+
+	// Node 4 and its child move under node 2, the depth-first order becomes 0, 1, 2, 4, 5, 3
+	hierarchy.build({NONE, 0, 1, 2, 3, 1}, 512);
+
+	REQUIRE(hierarchy.size() == 6);
+	REQUIRE(hierarchy.get_subtree_end(0) == 6);
+	REQUIRE(hierarchy.get_subtree_end(1) == 6);
+	REQUIRE(hierarchy.get_subtree_end(2) == 5);
+	REQUIRE(hierarchy.get_subtree_end(3) == 5);
+	REQUIRE(hierarchy.get_subtree_end(5) == 6);
+
+	// The rebuild makes everything dirty again
+	std::vector<uint32_t> all_nodes{0, 1, 2, 3, 4, 5};
+	REQUIRE(dirty_nodes(hierarchy) == all_nodes);
+
+	// Marking the new parent now reaches the moved nodes
+	hierarchy.clear_all_dirty();
+	hierarchy.mark_dirty(2);
+
+	std::vector<uint32_t> moved_subtree{2, 3, 4};
+	REQUIRE(dirty_nodes(hierarchy) == moved_subtree);
+}
+
+TEST_CASE("vkb::TransformHierarchy splits large subtrees in batches after their ancestors", "[transform_hierarchy]")
+{
+	TransformHierarchy hierarchy;
+	hierarchy.build(two_subtrees(), 3);
+
+	// The root is too large for a batch, its subtrees fit
+	std::vector<uint32_t> serial_nodes{0};
+	REQUIRE(hierarchy.get_serial_nodes() == serial_nodes);
+
+	auto &batches = hierarchy.get_batches();
+
+	REQUIRE(batches.size() == 2);
+	REQUIRE(batches[0] == Batch(1, 4));
+	REQUIRE(batches[1] == Batch(4, 6));
+
+	// Small sibling subtrees are merged in a batch
+	hierarchy.build(two_subtrees(), 5);
+
+	REQUIRE(hierarchy.get_serial_nodes() == serial_nodes);
+	REQUIRE(hierarchy.get_batches().size() == 1);
+	REQUIRE(hierarchy.get_batches()[0] == Batch(1, 6));
+}
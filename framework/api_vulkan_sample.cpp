@@ -25,6 +25,7 @@
 #include "scene_graph/components/sampler.h"
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
+#include "upload_manager.h"
 
 bool ApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 {
@@ -35,17 +36,11 @@ bool ApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 
 	depth_format = vkb::get_suitable_depth_format(get_device().get_gpu().get_handle());
 
-	// Create synchronization objects
-	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
-	// Create a semaphore used to synchronize image presentation
-	// Ensures that the current swapchain render target has completed presentation and has been released by the presentation engine, ready for rendering
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphores.acquired_image_ready));
-	// Create a semaphore used to synchronize command submission
-	// Ensures that the image is not presented until all commands have been sumbitted and executed
-	VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphores.render_complete));
+	// Create the semaphores and fences used to keep several frames in flight
+	create_frame_synchronization_primitives();
 
 	// Set up submit info structure
-	// Semaphores will stay the same during application lifetime
+	// The submit info points to the semaphores of the current frame, which are updated by prepare_frame
 	// Command buffer submission info is set by each example
 	submit_info                   = vkb::initializers::submit_info();
 	submit_info.pWaitDstStageMask = &submit_pipeline_stages;
@@ -77,6 +72,7 @@ bool ApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 void ApiVulkanSample::prepare_gui()
 {
 	create_gui(*window, nullptr, 15.0f, true);
+	get_gui().set_buffer_count(draw_cmd_buffers.size());
 	get_gui().prepare(pipeline_cache, render_pass,
 	                  {load_shader("uioverlay/uioverlay.vert", VK_SHADER_STAGE_VERTEX_BIT),
 	                   load_shader("uioverlay/uioverlay.frag", VK_SHADER_STAGE_FRAGMENT_BIT)});
@@ -483,13 +479,8 @@ void ApiVulkanSample::update_overlay(float delta_time, const std::function<void(
 			additional_ui();
 		});
 
+		// The GUI buffers are written by prepare_frame, once the GPU is done with the buffers of the acquired image
 		get_gui().update(delta_time);
-
-		if (get_gui().update_buffers() || get_gui().get_drawer().is_dirty())
-		{
-			rebuild_command_buffers();
-			get_gui().get_drawer().clear();
-		}
 	}
 }
 
@@ -502,12 +493,21 @@ void ApiVulkanSample::draw_ui(const VkCommandBuffer command_buffer)
 		vkCmdSetViewport(command_buffer, 0, 1, &viewport);
 		vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 
-		get_gui().draw(command_buffer);
+		// The command buffer of a swapchain image draws from the GUI buffers of that image
+		auto   it           = std::find(draw_cmd_buffers.begin(), draw_cmd_buffers.end(), command_buffer);
+		size_t buffer_index = (it != draw_cmd_buffers.end()) ? std::distance(draw_cmd_buffers.begin(), it) : current_buffer;
+
+		get_gui().draw(command_buffer, buffer_index);
 	}
 }
 
 void ApiVulkanSample::prepare_frame()
 {
+	// Wait for the GPU to be done with the last frame which used the synchronization objects of this frame
+	VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &frame_fences[frame_index], VK_TRUE, UINT64_MAX));
+
+	semaphores.acquired_image_ready = frame_acquired_semaphores[frame_index];
+
 	if (get_render_context().has_swapchain())
 	{
 		handle_surface_changes();
@@ -525,10 +525,53 @@ void ApiVulkanSample::prepare_frame()
 			VK_CHECK(result);
 		}
 	}
+
+	// The swapchain may have more images than the surface reported at prepare time
+	if (current_buffer >= image_fences.size())
+	{
+		VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+		while (image_render_semaphores.size() <= current_buffer)
+		{
+			VkSemaphore semaphore{VK_NULL_HANDLE};
+			VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphore));
+			image_render_semaphores.push_back(semaphore);
+		}
+		image_fences.resize(current_buffer + 1, VK_NULL_HANDLE);
+	}
+
+	// Images may be acquired out of order: the command buffer of this image can only be submitted again
+	// once the frame which last rendered to it is complete
+	if (image_fences[current_buffer] != VK_NULL_HANDLE && image_fences[current_buffer] != frame_fences[frame_index])
+	{
+		VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &image_fences[current_buffer], VK_TRUE, UINT64_MAX));
+	}
+	image_fences[current_buffer] = frame_fences[frame_index];
+
+	semaphores.render_complete = image_render_semaphores[current_buffer];
+
+	if (has_gui())
+	{
+		get_gui().set_buffer_count(draw_cmd_buffers.size());
+
+		// Reallocating the GUI buffers replaces the buffers of all the images, including those still in flight
+		if (get_gui().update_buffers(current_buffer, [this]() { wait_for_frames_in_flight(); }) || get_gui().get_drawer().is_dirty())
+		{
+			rebuild_command_buffers();
+			get_gui().get_drawer().clear();
+		}
+	}
 }
 
 void ApiVulkanSample::submit_frame()
 {
+	// Signal the fence of this frame once the work submitted to the queue so far is complete.
+	// A submission without batches is ordered after all the previous submissions to the queue
+	VkFence frame_fence = frame_fences[frame_index];
+	VK_CHECK(vkResetFences(get_device().get_handle(), 1, &frame_fence));
+	VK_CHECK(vkQueueSubmit(queue, 0, nullptr, frame_fence));
+
+	frame_index = (frame_index + 1) % frame_lag;
+
 	if (get_render_context().has_swapchain())
 	{
 		const auto &queue = get_device().get_queue_by_present(0);
@@ -574,10 +617,111 @@ void ApiVulkanSample::submit_frame()
 		}
 	}
 
-	// DO NOT USE
-	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
-	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	VK_CHECK(get_device().get_queue_by_present(0).wait_idle());
+	if (wait_idle_per_frame)
+	{
+		// DO NOT USE
+		// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
+		// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
+		VK_CHECK(get_device().get_queue_by_present(0).wait_idle());
+	}
+	else if (frame_lag == 1)
+	{
+		// Without frames in flight, samples may update the resources used by the frame as soon as it is submitted
+		VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &frame_fence, VK_TRUE, UINT64_MAX));
+	}
+}
+
+void ApiVulkanSample::set_frame_lag(uint32_t lag)
+{
+	assert(frame_fences.empty() && "The frame lag must be set before prepare");
+	frame_lag = std::max(lag, 1u);
+}
+
+uint32_t ApiVulkanSample::get_frame_lag() const
+{
+	return frame_lag;
+}
+
+uint32_t ApiVulkanSample::get_frame_index() const
+{
+	return frame_index;
+}
+
+void ApiVulkanSample::wait_for_frames_in_flight()
+{
+	if (!frame_fences.empty())
+	{
+		VK_CHECK(vkWaitForFences(get_device().get_handle(), vkb::to_u32(frame_fences.size()), frame_fences.data(), VK_TRUE, UINT64_MAX));
+	}
+}
+
+void ApiVulkanSample::create_frame_uniform_buffers(std::vector<std::unique_ptr<vkb::core::BufferC>> &buffers, VkDeviceSize size)
+{
+	buffers.clear();
+	for (size_t i = 0; i < draw_cmd_buffers.size(); ++i)
+	{
+		buffers.push_back(std::make_unique<vkb::core::BufferC>(get_device(), size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU));
+	}
+}
+
+vkb::core::BufferC &ApiVulkanSample::get_frame_uniform_buffer(std::vector<std::unique_ptr<vkb::core::BufferC>> &buffers)
+{
+	assert(current_buffer < buffers.size());
+	return *buffers[current_buffer];
+}
+
+void ApiVulkanSample::create_frame_synchronization_primitives()
+{
+	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+	// Fences are created signaled, as no frame is in flight yet
+	VkFenceCreateInfo fence_create_info = vkb::initializers::fence_create_info(VK_FENCE_CREATE_SIGNALED_BIT);
+
+	// Semaphores used to synchronize image presentation
+	// Ensure that the current swapchain render target has completed presentation and has been released by the presentation engine, ready for rendering
+	frame_acquired_semaphores.resize(frame_lag, VK_NULL_HANDLE);
+	frame_fences.resize(frame_lag, VK_NULL_HANDLE);
+	for (uint32_t i = 0; i < frame_lag; ++i)
+	{
+		VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &frame_acquired_semaphores[i]));
+		VK_CHECK(vkCreateFence(get_device().get_handle(), &fence_create_info, nullptr, &frame_fences[i]));
+	}
+
+	// Semaphores used to synchronize command submission
+	// Ensure that an image is not presented until all commands have been sumbitted and executed.
+	// A semaphore waited on by a presentation can only be reused once the image is acquired again, hence one per image
+	image_render_semaphores.resize(std::max<size_t>(get_render_context().get_render_frames().size(), 1), VK_NULL_HANDLE);
+	for (auto &semaphore : image_render_semaphores)
+	{
+		VK_CHECK(vkCreateSemaphore(get_device().get_handle(), &semaphore_create_info, nullptr, &semaphore));
+	}
+	image_fences.resize(image_render_semaphores.size(), VK_NULL_HANDLE);
+
+	frame_index                     = 0;
+	semaphores.acquired_image_ready = frame_acquired_semaphores[0];
+	semaphores.render_complete      = image_render_semaphores[0];
+}
+
+void ApiVulkanSample::destroy_frame_synchronization_primitives()
+{
+	for (auto &semaphore : frame_acquired_semaphores)
+	{
+		vkDestroySemaphore(get_device().get_handle(), semaphore, nullptr);
+	}
+	for (auto &fence : frame_fences)
+	{
+		vkDestroyFence(get_device().get_handle(), fence, nullptr);
+	}
+	for (auto &semaphore : image_render_semaphores)
+	{
+		vkDestroySemaphore(get_device().get_handle(), semaphore, nullptr);
+	}
+	frame_acquired_semaphores.clear();
+	frame_fences.clear();
+	image_render_semaphores.clear();
+	image_fences.clear();
+
+	semaphores.acquired_image_ready = VK_NULL_HANDLE;
+	semaphores.render_complete      = VK_NULL_HANDLE;
 }
 
 ApiVulkanSample::~ApiVulkanSample()
@@ -618,8 +762,7 @@ ApiVulkanSample::~ApiVulkanSample()
 
 		vkDestroyCommandPool(get_device().get_handle(), cmd_pool, nullptr);
 
-		vkDestroySemaphore(get_device().get_handle(), semaphores.acquired_image_ready, nullptr);
-		vkDestroySemaphore(get_device().get_handle(), semaphores.render_complete, nullptr);
+		destroy_frame_synchronization_primitives();
 		for (auto &fence : wait_fences)
 		{
 			vkDestroyFence(get_device().get_handle(), fence, nullptr);
@@ -635,6 +778,9 @@ void ApiVulkanSample::build_command_buffers()
 
 void ApiVulkanSample::rebuild_command_buffers()
 {
+	// The command buffers may still be in use by the frames in flight
+	wait_for_frames_in_flight();
+
 	vkResetCommandPool(get_device().get_handle(), cmd_pool, 0);
 	build_command_buffers();
 }
@@ -1023,12 +1169,6 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(get_device());
 
-	const auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::BufferC stage_buffer = vkb::core::BufferC::create_staging_buffer(get_device(), texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> bufferCopyRegions;
 
@@ -1055,31 +1195,14 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
 	subresource_range.layerCount              = 1;
 
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_UNDEFINED,
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(bufferCopyRegions.size()),
-	    bufferCopyRegions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             subresource_range);
-
-	get_device().flush_command_buffer(command_buffer, queue.get_handle());
+	// The texture may be used on a queue other than the one of the upload manager, so the upload is waited for
+	auto &upload_manager = get_device().get_upload_manager();
+
+	upload_manager.wait(upload_manager.upload_image(texture.image->get_vk_image().get_handle(),
+	                                                texture.image->get_format(),
+	                                                texture.image->get_data(),
+	                                                bufferCopyRegions,
+	                                                subresource_range));
 
 	// Calculate valid filter and mipmap modes
 	VkFilter            filter      = VK_FILTER_LINEAR;
@@ -1119,12 +1242,6 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(get_device(), VK_IMAGE_VIEW_TYPE_2D_ARRAY);
 
-	const auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::BufferC stage_buffer = vkb::core::BufferC::create_staging_buffer(get_device(), texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1157,31 +1274,14 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
 	subresource_range.layerCount              = layers;
 
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_UNDEFINED,
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             subresource_range);
-
-	get_device().flush_command_buffer(command_buffer, queue.get_handle());
+	// The texture may be used on a queue other than the one of the upload manager, so the upload is waited for
+	auto &upload_manager = get_device().get_upload_manager();
+
+	upload_manager.wait(upload_manager.upload_image(texture.image->get_vk_image().get_handle(),
+	                                                texture.image->get_format(),
+	                                                texture.image->get_data(),
+	                                                buffer_copy_regions,
+	                                                subresource_range));
 
 	// Calculate valid filter and mipmap modes
 	VkFilter            filter      = VK_FILTER_LINEAR;
@@ -1218,12 +1318,6 @@ Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(get_device(), VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 
-	const auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = get_device().create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::BufferC stage_buffer = vkb::core::BufferC::create_staging_buffer(get_device(), texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1256,31 +1350,14 @@ Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::
 	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
 	subresource_range.layerCount              = layers;
 
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_UNDEFINED,
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::image_layout_transition(command_buffer,
-	                             texture.image->get_vk_image().get_handle(),
-	                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             subresource_range);
-
-	get_device().flush_command_buffer(command_buffer, queue.get_handle());
+	// The texture may be used on a queue other than the one of the upload manager, so the upload is waited for
+	auto &upload_manager = get_device().get_upload_manager();
+
+	upload_manager.wait(upload_manager.upload_image(texture.image->get_vk_image().get_handle(),
+	                                                texture.image->get_format(),
+	                                                texture.image->get_data(),
+	                                                buffer_copy_regions,
+	                                                subresource_range));
 
 	// Calculate valid filter and mipmap modes
 	VkFilter            filter      = VK_FILTER_LINEAR;
@@ -41,37 +41,52 @@ class BufferAllocation
 	BufferAllocation &operator=(const BufferAllocation &) = delete;
 	BufferAllocation &operator=(BufferAllocation &&)      = default;
 
-	BufferAllocation(vkb::core::Buffer<bindingType> &buffer, DeviceSizeType size, DeviceSizeType offset);
+	/**
+	 * @param flush_on_update False if the writes are flushed later, together with the rest of the block (see BufferBlock::collect_flush_range)
+	 */
+	BufferAllocation(vkb::core::Buffer<bindingType> &buffer, DeviceSizeType size, DeviceSizeType offset, bool flush_on_update = true);
 
 	bool                            empty() const;
 	vkb::core::Buffer<bindingType> &get_buffer();
 	DeviceSizeType                  get_offset() const;
 	DeviceSizeType                  get_size() const;
 	void                            update(const std::vector<uint8_t> &data, uint32_t offset = 0);
+
+	/**
+	 * @brief Copies data straight into the mapped memory of the allocation, without intermediate copies
+	 * @param data Pointer to the data to copy
+	 * @param data_size Size of the data in bytes
+	 * @param offset Offset in bytes from the start of the allocation
+	 */
+	void update(const uint8_t *data, size_t data_size, uint32_t offset = 0);
+
 	template <typename T>
 	void update(const T &value, uint32_t offset = 0);
 
   private:
-	vkb::core::BufferCpp *buffer = nullptr;
-	vk::DeviceSize        offset = 0;
-	vk::DeviceSize        size   = 0;
+	vkb::core::BufferCpp *buffer          = nullptr;
+	vk::DeviceSize        offset          = 0;
+	vk::DeviceSize        size            = 0;
+	bool                  flush_on_update = true;
 };
 
 using BufferAllocationC   = BufferAllocation<vkb::BindingType::C>;
 using BufferAllocationCpp = BufferAllocation<vkb::BindingType::Cpp>;
 
 template <>
-inline BufferAllocation<vkb::BindingType::Cpp>::BufferAllocation(vkb::core::BufferCpp &buffer, vk::DeviceSize size, vk::DeviceSize offset) :
+inline BufferAllocation<vkb::BindingType::Cpp>::BufferAllocation(vkb::core::BufferCpp &buffer, vk::DeviceSize size, vk::DeviceSize offset, bool flush_on_update) :
     buffer(&buffer),
     offset(offset),
-    size(size)
+    size(size),
+    flush_on_update(flush_on_update)
 {}
 
 template <>
-inline BufferAllocation<vkb::BindingType::C>::BufferAllocation(vkb::core::BufferC &buffer, VkDeviceSize size, VkDeviceSize offset) :
+inline BufferAllocation<vkb::BindingType::C>::BufferAllocation(vkb::core::BufferC &buffer, VkDeviceSize size, VkDeviceSize offset, bool flush_on_update) :
     buffer(reinterpret_cast<vkb::core::BufferCpp *>(&buffer)),
     offset(static_cast<vk::DeviceSize>(offset)),
-    size(static_cast<vk::DeviceSize>(size))
+    size(static_cast<vk::DeviceSize>(size)),
+    flush_on_update(flush_on_update)
 {}
 
 template <vkb::BindingType bindingType>
@@ -122,12 +137,31 @@ typename BufferAllocation<bindingType>::DeviceSizeType BufferAllocation<bindingT
 
 template <vkb::BindingType bindingType>
 void BufferAllocation<bindingType>::update(const std::vector<uint8_t> &data, uint32_t offset)
+{
+	update(data.data(), data.size(), offset);
+}
+
+template <vkb::BindingType bindingType>
+void BufferAllocation<bindingType>::update(const uint8_t *data, size_t data_size, uint32_t offset)
 {
 	assert(buffer && "Invalid buffer pointer");
 
-	if (offset + data.size() <= size)
+	if (offset + data_size <= size)
 	{
-		buffer->update(data, to_u32(this->offset) + offset);
+		if (buffer->mapped())
+		{
+			// Blocks are persistently mapped, write in place and only flush the written range
+			std::copy(data, data + data_size, buffer->map() + this->offset + offset);
+
+			if (flush_on_update)
+			{
+				buffer->flush(this->offset + offset, data_size);
+			}
+		}
+		else
+		{
+			buffer->update(data, data_size, to_u32(this->offset) + offset);
+		}
 	}
 	else
 	{
@@ -139,7 +173,45 @@ template <vkb::BindingType bindingType>
 template <typename T>
 void BufferAllocation<bindingType>::update(const T &value, uint32_t offset)
 {
-	update(to_bytes(value), offset);
+	update(reinterpret_cast<const uint8_t *>(&value), sizeof(T), offset);
+}
+
+/**
+ * @brief Ranges of non-coherent memory written in place, flushed together by a single vmaFlushAllocations call
+ */
+struct BufferFlushBatch
+{
+	std::vector<VmaAllocation> allocations;
+	std::vector<VkDeviceSize>  offsets;
+	std::vector<VkDeviceSize>  sizes;
+
+	void add(VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size);
+
+	/**
+	 * @brief Flushes all the ranges, then clears the batch while keeping its capacity
+	 */
+	void flush();
+};
+
+inline void BufferFlushBatch::add(VmaAllocation allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+	allocations.push_back(allocation);
+	offsets.push_back(offset);
+	sizes.push_back(size);
+}
+
+inline void BufferFlushBatch::flush()
+{
+	if (allocations.empty())
+	{
+		return;
+	}
+
+	VK_CHECK(vmaFlushAllocations(vkb::allocated::get_memory_allocator(), to_u32(allocations.size()), allocations.data(), offsets.data(), sizes.data()));
+
+	allocations.clear();
+	offsets.clear();
+	sizes.clear();
 }
 
 /**
@@ -176,7 +248,23 @@ class BufferBlock
 	bool can_allocate(DeviceSizeType size) const;
 
 	DeviceSizeType get_size() const;
-	void           reset();
+
+	/**
+	 * @return The number of bytes allocated since the last reset, including alignment padding
+	 */
+	DeviceSizeType get_used_size() const;
+
+	void reset();
+
+	/**
+	 * @brief Defers the flushes of the allocations, which are then flushed by collect_flush_range
+	 */
+	void set_deferred_flush(bool deferred);
+
+	/**
+	 * @brief Adds the range allocated since the previous call to the batch, if the memory is not HOST_COHERENT
+	 */
+	void collect_flush_range(BufferFlushBatch &batch);
 
   private:
 	/**
@@ -188,8 +276,10 @@ class BufferBlock
 
   private:
 	vkb::core::BufferCpp buffer;
-	vk::DeviceSize       alignment = 0;        // Memory alignment, it may change according to the usage
-	vk::DeviceSize       offset    = 0;        // Current offset, it increases on every allocation
+	vk::DeviceSize       alignment      = 0;            // Memory alignment, it may change according to the usage
+	vk::DeviceSize       offset         = 0;            // Current offset, it increases on every allocation
+	vk::DeviceSize       flushed_offset = 0;            // End of the range already collected for flushing
+	bool                 deferred_flush = false;        // Whether allocations leave flushing to collect_flush_range
 };
 
 using BufferBlockC   = BufferBlock<vkb::BindingType::C>;
@@ -220,11 +310,11 @@ BufferAllocation<bindingType> BufferBlock<bindingType>::allocate(DeviceSizeType
 		offset       = aligned + size;
 		if constexpr (bindingType == vkb::BindingType::Cpp)
 		{
-			return BufferAllocationCpp{buffer, size, aligned};
+			return BufferAllocationCpp{buffer, size, aligned, !deferred_flush};
 		}
 		else
 		{
-			return BufferAllocationC{reinterpret_cast<vkb::core::BufferC &>(buffer), static_cast<VkDeviceSize>(size), static_cast<VkDeviceSize>(aligned)};
+			return BufferAllocationC{reinterpret_cast<vkb::core::BufferC &>(buffer), static_cast<VkDeviceSize>(size), static_cast<VkDeviceSize>(aligned), !deferred_flush};
 		}
 	}
 
@@ -245,10 +335,34 @@ typename BufferBlock<bindingType>::DeviceSizeType BufferBlock<bindingType>::get_
 	return buffer.get_size();
 }
 
+template <vkb::BindingType bindingType>
+typename BufferBlock<bindingType>::DeviceSizeType BufferBlock<bindingType>::get_used_size() const
+{
+	return static_cast<DeviceSizeType>(offset);
+}
+
 template <vkb::BindingType bindingType>
 void BufferBlock<bindingType>::reset()
 {
-	offset = 0;
+	offset         = 0;
+	flushed_offset = 0;
+}
+
+template <vkb::BindingType bindingType>
+void BufferBlock<bindingType>::set_deferred_flush(bool deferred)
+{
+	deferred_flush = deferred;
+}
+
+template <vkb::BindingType bindingType>
+void BufferBlock<bindingType>::collect_flush_range(BufferFlushBatch &batch)
+{
+	if (offset > flushed_offset && buffer.mapped() && !buffer.is_coherent())
+	{
+		batch.add(buffer.get_allocation(), static_cast<VkDeviceSize>(flushed_offset), static_cast<VkDeviceSize>(offset - flushed_offset));
+	}
+
+	flushed_offset = offset;
 }
 
 template <vkb::BindingType bindingType>
@@ -299,6 +413,11 @@ vk::DeviceSize BufferBlock<bindingType>::determine_alignment(vk::BufferUsageFlag
  *
  * We re-use descriptor sets: we only need one for the corresponding buffer infos (and we only
  * have one VkBuffer per BufferBlock), then it is bound and we use dynamic offsets.
+ *
+ * With deferred flushing (see set_deferred_flush) allocations are written in place without any flush,
+ * the ranges written since the previous submit are flushed together (see collect_flush_ranges).
+ * Blocks can also be merged into a single one once a frame needed several (see coalesce_blocks),
+ * so that the pool converges to one large persistently mapped buffer.
  */
 template <vkb::BindingType bindingType>
 class BufferPool
@@ -316,12 +435,30 @@ class BufferPool
 
 	void reset();
 
+	/**
+	 * @brief Enables deferred flushing for all the blocks of the pool, current and future
+	 */
+	void set_deferred_flush(bool deferred);
+
+	/**
+	 * @brief Adds the ranges allocated since the previous call to the batch, for the blocks which are not HOST_COHERENT
+	 */
+	void collect_flush_ranges(BufferFlushBatch &batch);
+
+	/**
+	 * @brief Replaces the blocks with a single one large enough for all of them, if more than one was used since the last reset
+	 *        The GPU must be done with the blocks, and descriptor sets referring to them must be dropped.
+	 * @return True if the blocks were replaced
+	 */
+	bool coalesce_blocks();
+
   private:
 	vkb::core::HPPDevice                        &device;
 	std::vector<std::unique_ptr<BufferBlockCpp>> buffer_blocks;         /// List of blocks requested (need to be pointers in order to keep their address constant on vector resizing)
 	vk::DeviceSize                               block_size = 0;        /// Minimum size of the blocks
 	vk::BufferUsageFlags                         usage;
 	VmaMemoryUsage                               memory_usage{};
+	bool                                         deferred_flush = false;        /// Whether the blocks leave flushing to collect_flush_ranges
 };
 
 using BufferPoolC   = BufferPool<vkb::BindingType::C>;
@@ -352,6 +489,7 @@ BufferBlock<bindingType> &BufferPool<bindingType>::request_buffer_block(DeviceSi
 
 		// Create a new block and get the iterator on it
 		it = buffer_blocks.emplace(buffer_blocks.end(), std::make_unique<BufferBlockCpp>(device, new_block_size, usage, memory_usage));
+		(*it)->set_deferred_flush(deferred_flush);
 	}
 
 	if constexpr (bindingType == vkb::BindingType::Cpp)
@@ -376,4 +514,56 @@ void BufferPool<bindingType>::reset()
 	}
 }
 
+template <vkb::BindingType bindingType>
+void BufferPool<bindingType>::set_deferred_flush(bool deferred)
+{
+	deferred_flush = deferred;
+
+	for (auto &buffer_block : buffer_blocks)
+	{
+		buffer_block->set_deferred_flush(deferred);
+	}
+}
+
+template <vkb::BindingType bindingType>
+void BufferPool<bindingType>::collect_flush_ranges(BufferFlushBatch &batch)
+{
+	for (auto &buffer_block : buffer_blocks)
+	{
+		buffer_block->collect_flush_range(batch);
+	}
+}
+
+template <vkb::BindingType bindingType>
+bool BufferPool<bindingType>::coalesce_blocks()
+{
+	size_t         used_block_count = 0;
+	vk::DeviceSize total_size       = 0;
+
+	for (auto &buffer_block : buffer_blocks)
+	{
+		if (buffer_block->get_used_size() > 0)
+		{
+			used_block_count++;
+		}
+		total_size += buffer_block->get_size();
+	}
+
+	if (used_block_count <= 1)
+	{
+		return false;
+	}
+
+	// Round up to the block size, so that small variations of the usage do not split the block again
+	vk::DeviceSize new_block_size = ((total_size + block_size - 1) / block_size) * block_size;
+
+	LOGD("Coalescing {} buffer blocks ({}) into one of {} bytes", buffer_blocks.size(), vk::to_string(usage), new_block_size);
+
+	buffer_blocks.clear();
+	buffer_blocks.push_back(std::make_unique<BufferBlockCpp>(device, new_block_size, usage, memory_usage));
+	buffer_blocks.back()->set_deferred_flush(deferred_flush);
+
+	return true;
+}
+
 }        // namespace vkb
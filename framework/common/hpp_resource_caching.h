@@ -351,14 +351,14 @@ struct HPPRecordHelper<vkb::core::HPPGraphicsPipeline, A...>
 };
 }        // namespace
 
+/**
+ * @brief Same as request_resource, for callers which already computed the hash of the arguments
+ */
 template <class T, class... A>
-T &request_resource(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *recorder, std::unordered_map<size_t, T> &resources, A &...args)
+T &request_resource_with_hash(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *recorder, std::unordered_map<size_t, T> &resources, size_t hash, A &...args)
 {
 	HPPRecordHelper<T, A...> record_helper;
 
-	size_t hash{0U};
-	hash_param(hash, args...);
-
 	auto res_it = resources.find(hash);
 
 	if (res_it != resources.end())
@@ -404,5 +404,14 @@ T &request_resource(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *record
 
 	return res_it->second;
 }
+
+template <class T, class... A>
+T &request_resource(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *recorder, std::unordered_map<size_t, T> &resources, A &...args)
+{
+	size_t hash{0U};
+	hash_param(hash, args...);
+
+	return request_resource_with_hash(device, recorder, resources, hash, args...);
+}
 }        // namespace common
 }        // namespace vkb
@@ -121,6 +121,13 @@ bool is_buffer_descriptor_type(VkDescriptorType descriptor_type);
  */
 int32_t get_bits_per_pixel(VkFormat format);
 
+/**
+ * @brief Helper function to get the size of a texel block of a Vulkan format, which is a single texel for uncompressed formats.
+ * @param format Vulkan format to check.
+ * @return The size in bytes of a texel block of the given format, 0 for invalid formats.
+ */
+uint32_t get_texel_block_size(VkFormat format);
+
 enum class ShaderSourceLanguage
 {
 	GLSL,
@@ -180,6 +180,18 @@ class Allocated : public vkb::core::VulkanResource<bindingType, HandleType>
 	 */
 	DeviceMemoryType get_memory() const;
 
+	/**
+	 * @brief Retrieves the VMA allocation backing the memory, to batch operations over several allocations.
+	 * @return The VMA allocation.
+	 */
+	VmaAllocation get_allocation() const;
+
+	/**
+	 * @brief Returns true if the memory is `HOST_COHERENT`, in which case writes never need to be flushed.
+	 * @return coherency status.
+	 */
+	bool is_coherent() const;
+
 	/**
 	 * @brief Maps Vulkan memory if it isn't already mapped to a host visible address. Does nothing if the
 	 * allocation is already mapped (including persistently mapped allocations).
@@ -562,6 +574,18 @@ inline typename Allocated<bindingType, HandleType>::DeviceMemoryType Allocated<b
 	}
 }
 
+template <vkb::BindingType bindingType, typename HandleType>
+inline VmaAllocation Allocated<bindingType, HandleType>::get_allocation() const
+{
+	return allocation;
+}
+
+template <vkb::BindingType bindingType, typename HandleType>
+inline bool Allocated<bindingType, HandleType>::is_coherent() const
+{
+	return coherent;
+}
+
 template <vkb::BindingType bindingType, typename HandleType>
 inline uint8_t *Allocated<bindingType, HandleType>::map()
 {
@@ -30,7 +30,7 @@ namespace vkb
 CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level) :
     VulkanResource{VK_NULL_HANDLE, &command_pool.get_device()},
     command_pool{command_pool},
-    max_push_constants_size{get_device().get_gpu().get_properties().limits.maxPushConstantsSize},
+    max_push_constants_size{std::min(get_device().get_gpu().get_properties().limits.maxPushConstantsSize, MAX_PUSH_CONSTANTS_SIZE)},
     level{level}
 {
 	VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
@@ -60,7 +60,8 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     current_render_pass(std::exchange(other.current_render_pass, {})),
     pipeline_state(std::exchange(other.pipeline_state, {})),
     resource_binding_state(std::exchange(other.resource_binding_state, {})),
-    stored_push_constants(std::exchange(other.stored_push_constants, {})),
+    stored_push_constants(other.stored_push_constants),
+    stored_push_constants_size(std::exchange(other.stored_push_constants_size, {})),
     max_push_constants_size(std::exchange(other.max_push_constants_size, {})),
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
@@ -92,7 +93,7 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	pipeline_state.reset();
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
-	stored_push_constants.clear();
+	stored_push_constants_size = 0;
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -110,6 +111,13 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 		inheritance.subpass     = subpass_index;
 
 		begin_info.pInheritanceInfo = &inheritance;
+
+		// Pipelines recorded in the secondary command buffer must target the inherited subpass
+		pipeline_state.set_subpass_index(subpass_index);
+
+		auto blend_state = pipeline_state.get_color_blend_state();
+		blend_state.attachments.resize(current_render_pass.render_pass->get_color_output_count(subpass_index));
+		pipeline_state.set_color_blend_state(blend_state);
 	}
 
 	return vkBeginCommandBuffer(get_handle(), &begin_info);
@@ -122,13 +130,20 @@ VkResult CommandBuffer::end()
 	return VK_SUCCESS;
 }
 
-void CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
+bool CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
 {
-	flush_pipeline_state(pipeline_bind_point);
+	if (!flush_pipeline_state(pipeline_bind_point))
+	{
+		// The push constants belong to the skipped command
+		stored_push_constants_size = 0;
+		return false;
+	}
 
 	flush_push_constants();
 
 	flush_descriptor_state(pipeline_bind_point);
+
+	return true;
 }
 
 void CommandBuffer::begin_render_pass(const RenderTarget                                           &render_target,
@@ -185,7 +200,7 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const R
 	pipeline_state.set_color_blend_state(blend_state);
 }
 
-void CommandBuffer::next_subpass()
+void CommandBuffer::next_subpass(VkSubpassContents contents)
 {
 	// Increment subpass index
 	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
@@ -200,9 +215,9 @@ void CommandBuffer::next_subpass()
 	descriptor_set_layout_binding_state.clear();
 
 	// Clear stored push constants
-	stored_push_constants.clear();
+	stored_push_constants_size = 0;
 
-	vkCmdNextSubpass(get_handle(), VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdNextSubpass(get_handle(), contents);
 }
 
 void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
@@ -235,17 +250,22 @@ void CommandBuffer::set_specialization_constant(uint32_t constant_id, const std:
 
 void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
 {
-	uint32_t push_constant_size = to_u32(stored_push_constants.size() + values.size());
+	push_constants(values.data(), to_u32(values.size()));
+}
+
+void CommandBuffer::push_constants(const uint8_t *data, uint32_t size)
+{
+	uint32_t push_constant_size = stored_push_constants_size + size;
 
 	if (push_constant_size > max_push_constants_size)
 	{
-		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, values.size(), push_constant_size);
+		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, size, push_constant_size);
 		throw std::runtime_error("Push constant limit exceeded.");
 	}
-	else
-	{
-		stored_push_constants.insert(stored_push_constants.end(), values.begin(), values.end());
-	}
+
+	std::copy(data, data + size, stored_push_constants.begin() + stored_push_constants_size);
+
+	stored_push_constants_size = push_constant_size;
 }
 
 void CommandBuffer::bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
@@ -357,35 +377,50 @@ void CommandBuffer::set_depth_bounds(float min_depth_bounds, float max_depth_bou
 
 void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		return;
+	}
 
 	vkCmdDraw(get_handle(), vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		return;
+	}
 
 	vkCmdDrawIndexed(get_handle(), index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
 void CommandBuffer::draw_indexed_indirect(const vkb::core::BufferC &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		return;
+	}
 
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
 }
 
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
-	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
+	if (!flush(VK_PIPELINE_BIND_POINT_COMPUTE))
+	{
+		return;
+	}
 
 	vkCmdDispatch(get_handle(), group_count_x, group_count_y, group_count_z);
 }
 
 void CommandBuffer::dispatch_indirect(const vkb::core::BufferC &buffer, VkDeviceSize offset)
 {
-	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
+	if (!flush(VK_PIPELINE_BIND_POINT_COMPUTE))
+	{
+		return;
+	}
 
 	vkCmdDispatchIndirect(get_handle(), buffer.get_handle(), offset);
 }
@@ -483,21 +518,50 @@ void CommandBuffer::buffer_memory_barrier(const vkb::core::BufferC &buffer, VkDe
 	    0, nullptr);
 }
 
-void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
+bool CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
 {
 	// Create a new pipeline only if the graphics state changed
 	if (!pipeline_state.is_dirty())
 	{
-		return;
+		return true;
 	}
 
-	pipeline_state.clear_dirty();
+	auto &resource_cache = get_device().get_resource_cache();
 
 	// Create and bind pipeline
 	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
 	{
 		pipeline_state.set_render_pass(*current_render_pass.render_pass);
-		auto &pipeline = get_device().get_resource_cache().request_graphics_pipeline(pipeline_state);
+
+		if (resource_cache.is_async_graphics_pipelines())
+		{
+			auto pipeline = resource_cache.request_graphics_pipeline_async(pipeline_state);
+
+			if (pipeline)
+			{
+				pipeline_state.clear_dirty();
+			}
+			else
+			{
+				// Keep the state dirty so that the next command checks again whether the pipeline is ready
+				pipeline = resource_cache.request_fallback_graphics_pipeline(pipeline_state);
+
+				if (!pipeline)
+				{
+					return false;
+				}
+			}
+
+			vkCmdBindPipeline(get_handle(),
+			                  pipeline_bind_point,
+			                  pipeline->get_handle());
+
+			return true;
+		}
+
+		pipeline_state.clear_dirty();
+
+		auto &pipeline = resource_cache.request_graphics_pipeline(pipeline_state);
 
 		vkCmdBindPipeline(get_handle(),
 		                  pipeline_bind_point,
@@ -505,7 +569,9 @@ void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point
 	}
 	else if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
 	{
-		auto &pipeline = get_device().get_resource_cache().request_compute_pipeline(pipeline_state);
+		pipeline_state.clear_dirty();
+
+		auto &pipeline = resource_cache.request_compute_pipeline(pipeline_state);
 
 		vkCmdBindPipeline(get_handle(),
 		                  pipeline_bind_point,
@@ -515,6 +581,8 @@ void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point
 	{
 		throw "Only graphics and compute pipeline bind points are supported now";
 	}
+
+	return true;
 }
 
 void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point)
@@ -523,198 +591,258 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 
 	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-	std::unordered_set<uint32_t> update_descriptor_sets;
+	// Validate that the bound descriptor set layouts exist in the pipeline layout
+	descriptor_set_layout_binding_state.for_each([&pipeline_layout](uint32_t descriptor_set_id, DescriptorSetLayout *&bound_layout) {
+		if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+		{
+			bound_layout = nullptr;
+		}
+	});
 
-	// Iterate over the shader sets to check if they have already been bound
-	// If they have, add the set so that the command buffer later updates it
+	// A set which has already been bound with another layout is updated even if its resources did not change
+	auto is_layout_changed = [this, &pipeline_layout](uint32_t descriptor_set_id) {
+		auto bound_layout = descriptor_set_layout_binding_state.find(descriptor_set_id);
+		return bound_layout != nullptr && *bound_layout != nullptr && (*bound_layout)->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle();
+	};
+
+	bool layout_changed = false;
 	for (auto &set_it : pipeline_layout.get_shader_sets())
 	{
-		uint32_t descriptor_set_id = set_it.first;
+		layout_changed = layout_changed || is_layout_changed(set_it.first);
+	}
 
-		auto descriptor_set_layout_it = descriptor_set_layout_binding_state.find(descriptor_set_id);
+	// Check if a descriptor set needs to be created
+	if (resource_binding_state.is_dirty() || layout_changed)
+	{
+		resource_binding_state.clear_dirty();
 
-		if (descriptor_set_layout_it != descriptor_set_layout_binding_state.end())
-		{
-			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
-			{
-				update_descriptor_sets.emplace(descriptor_set_id);
-			}
-		}
+		// Iterate over all of the resource sets bound by the command buffer
+		resource_binding_state.get_resource_sets().for_each([&](uint32_t descriptor_set_id, const ResourceSet &resource_set) {
+			flush_resource_set(pipeline_bind_point, descriptor_set_id, resource_set, is_layout_changed(descriptor_set_id));
+		});
 	}
+}
 
-	// Validate that the bound descriptor set layouts exist in the pipeline layout
-	for (auto set_it = descriptor_set_layout_binding_state.begin(); set_it != descriptor_set_layout_binding_state.end();)
+void CommandBuffer::flush_resource_set(VkPipelineBindPoint pipeline_bind_point, uint32_t descriptor_set_id, const ResourceSet &resource_set, bool layout_changed)
+{
+	// Don't update resource set if it's not in the update list OR its state hasn't changed
+	if (!resource_set.is_dirty() && !layout_changed)
 	{
-		if (!pipeline_layout.has_descriptor_set_layout(set_it->first))
-		{
-			set_it = descriptor_set_layout_binding_state.erase(set_it);
-		}
-		else
-		{
-			++set_it;
-		}
+		return;
 	}
 
-	// Check if a descriptor set needs to be created
-	if (resource_binding_state.is_dirty() || !update_descriptor_sets.empty())
+	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
+
+	// Skip resource set if a descriptor set layout doesn't exist for it
+	if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
 	{
-		resource_binding_state.clear_dirty();
+		resource_binding_state.clear_dirty(descriptor_set_id);
+		return;
+	}
 
-		// Iterate over all of the resource sets bound by the command buffer
-		for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+	auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+
+	auto bound_layout = descriptor_set_layout_binding_state.find(descriptor_set_id);
+
+	bool layout_bound = bound_layout != nullptr && *bound_layout == &descriptor_set_layout;
+
+	// Make descriptor set layout bound for current set
+	descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+
+	std::array<uint32_t, MAX_DYNAMIC_OFFSETS> dynamic_offsets;
+	uint32_t                                  dynamic_offset_count = 0;
+
+	// Offsets of non-dynamic buffers are written to the descriptor set, so they are part of its key
+	size_t static_offsets_hash = 0;
+
+	// The descriptor set bound last can be reused if only dynamic offsets changed since
+	bool reuse_descriptor_set = resource_set.is_offset_only_dirty() && layout_bound && resource_set.get_descriptor_set() != VK_NULL_HANDLE;
+
+	// Iterate over buffer bindings to collect offsets, ordered by binding and array element
+	resource_set.get_resource_bindings().for_each([&](uint32_t binding_index, const std::vector<ResourceInfo> &binding_resources) {
+		auto binding_info = descriptor_set_layout.find_layout_binding(binding_index);
+		if (binding_info == nullptr || !is_buffer_descriptor_type(binding_info->descriptorType))
 		{
-			uint32_t descriptor_set_id = resource_set_it.first;
-			auto    &resource_set      = resource_set_it.second;
+			return;
+		}
 
-			// Don't update resource set if it's not in the update list OR its state hasn't changed
-			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
+		bool is_dynamic = is_dynamic_buffer_descriptor_type(binding_info->descriptorType);
+
+		for (auto &resource_info : binding_resources)
+		{
+			if (resource_info.buffer == nullptr)
 			{
 				continue;
 			}
 
-			// Clear dirty flag for resource set
-			resource_binding_state.clear_dirty(descriptor_set_id);
+			if (is_dynamic)
+			{
+				if (dynamic_offset_count == MAX_DYNAMIC_OFFSETS)
+				{
+					LOGE("Dynamic offset limit of {} exceeded in descriptor set {}", MAX_DYNAMIC_OFFSETS, descriptor_set_id);
+					throw std::runtime_error("Dynamic offset limit exceeded.");
+				}
 
-			// Skip resource set if a descriptor set layout doesn't exist for it
-			if (!pipeline_layout.has_descriptor_set_layout(descriptor_set_id))
+				dynamic_offsets[dynamic_offset_count++] = to_u32(resource_info.offset);
+			}
+			else
 			{
-				continue;
+				reuse_descriptor_set = reuse_descriptor_set && !resource_info.dirty;
+
+				hash_combine(static_offsets_hash, resource_info.offset);
 			}
+		}
+	});
+
+	// Clear dirty flag for resource set
+	resource_binding_state.clear_dirty(descriptor_set_id);
+
+	VkDescriptorSet descriptor_set_handle = resource_set.get_descriptor_set();
 
-			auto &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(descriptor_set_id);
+	if (!reuse_descriptor_set)
+	{
+		size_t key = resource_set.get_hash();
+		hash_combine(key, static_offsets_hash);
+		hash_combine(key, descriptor_set_layout.get_handle());
+
+		auto render_frame = command_pool.get_render_frame();
 
-			// Make descriptor set layout bound for current set
-			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
+		// Descriptor infos are only built if the descriptor set does not exist yet
+		descriptor_set_handle = render_frame->find_descriptor_set(key, command_pool.get_thread_index());
 
+		if (descriptor_set_handle == VK_NULL_HANDLE)
+		{
 			BindingMap<VkDescriptorBufferInfo> buffer_infos;
 			BindingMap<VkDescriptorImageInfo>  image_infos;
 
-			std::vector<uint32_t> dynamic_offsets;
+			collect_descriptor_infos(descriptor_set_layout, resource_set, buffer_infos, image_infos);
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
-			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+			descriptor_set_handle = render_frame->request_descriptor_set(key,
+			                                                             descriptor_set_layout,
+			                                                             buffer_infos,
+			                                                             image_infos,
+			                                                             update_after_bind,
+			                                                             command_pool.get_thread_index());
+		}
 
-				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
-				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
-					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+		resource_binding_state.set_descriptor_set(descriptor_set_id, descriptor_set_handle);
+	}
 
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
+	// Bind descriptor set
+	vkCmdBindDescriptorSets(get_handle(),
+	                        pipeline_bind_point,
+	                        pipeline_layout.get_handle(),
+	                        descriptor_set_id,
+	                        1, &descriptor_set_handle,
+	                        dynamic_offset_count,
+	                        dynamic_offsets.data());
+}
+
+void CommandBuffer::collect_descriptor_infos(const DescriptorSetLayout          &descriptor_set_layout,
+                                             const ResourceSet                  &resource_set,
+                                             BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                             BindingMap<VkDescriptorImageInfo>  &image_infos) const
+{
+	// Iterate over all resource bindings
+	resource_set.get_resource_bindings().for_each([&](uint32_t binding_index, const std::vector<ResourceInfo> &binding_resources) {
+		// Check if binding exists in the pipeline layout
+		if (auto binding_info = descriptor_set_layout.find_layout_binding(binding_index))
+		{
+			// Iterate over all binding resources
+			for (uint32_t array_element = 0; array_element < to_u32(binding_resources.size()); ++array_element)
+			{
+				auto &resource_info = binding_resources[array_element];
 
-						// Get buffer info
-						if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
-						{
-							VkDescriptorBufferInfo buffer_info{};
+				// Pointer references
+				auto &buffer     = resource_info.buffer;
+				auto &sampler    = resource_info.sampler;
+				auto &image_view = resource_info.image_view;
 
-							buffer_info.buffer = resource_info.buffer->get_handle();
-							buffer_info.offset = resource_info.offset;
-							buffer_info.range  = resource_info.range;
+				// Get buffer info
+				if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+				{
+					VkDescriptorBufferInfo buffer_info{};
 
-							if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
+					buffer_info.buffer = resource_info.buffer->get_handle();
+					buffer_info.offset = resource_info.offset;
+					buffer_info.range  = resource_info.range;
 
-								buffer_info.offset = 0;
-							}
+					// Dynamic offsets are passed when binding the descriptor set
+					if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						buffer_info.offset = 0;
+					}
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+					buffer_infos[binding_index][array_element] = buffer_info;
+				}
+
+				// Get image info
+				else if (image_view != nullptr || sampler != nullptr)
+				{
+					// Can be null for input attachments
+					VkDescriptorImageInfo image_info{};
+					image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
+					image_info.imageView = image_view->get_handle();
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
+					if (image_view != nullptr)
+					{
+						// Add image layout info based on descriptor type
+						switch (binding_info->descriptorType)
 						{
-							// Can be null for input attachments
-							VkDescriptorImageInfo image_info{};
-							image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
-							image_info.imageView = image_view->get_handle();
-
-							if (image_view != nullptr)
-							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
+							case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+								break;
+							case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+								if (is_depth_format(image_view->get_format()))
+								{
+									image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+								}
+								else
 								{
-									case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										break;
-									case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-										if (is_depth_format(image_view->get_format()))
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-										}
-										else
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										}
-										break;
-									case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-										break;
-
-									default:
-										continue;
+									image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 								}
-							}
+								break;
+							case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+								image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+								break;
 
-							image_infos[binding_index][array_element] = image_info;
+							default:
+								continue;
 						}
 					}
 
-					assert((!update_after_bind ||
-					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
-					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
+					image_infos[binding_index][array_element] = image_info;
 				}
 			}
 
-			VkDescriptorSet descriptor_set_handle =
-			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
-			                                                            buffer_infos,
-			                                                            image_infos,
-			                                                            update_after_bind,
-			                                                            command_pool.get_thread_index());
-
-			// Bind descriptor set
-			vkCmdBindDescriptorSets(get_handle(),
-			                        pipeline_bind_point,
-			                        pipeline_layout.get_handle(),
-			                        descriptor_set_id,
-			                        1, &descriptor_set_handle,
-			                        to_u32(dynamic_offsets.size()),
-			                        dynamic_offsets.data());
+			assert((!update_after_bind ||
+			        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
+			       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
 		}
-	}
+	});
 }
 
 void CommandBuffer::flush_push_constants()
 {
-	if (stored_push_constants.empty())
+	if (stored_push_constants_size == 0)
 	{
 		return;
 	}
 
 	const PipelineLayout &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-	VkShaderStageFlags shader_stage = pipeline_layout.get_push_constant_range_stage(to_u32(stored_push_constants.size()));
+	VkShaderStageFlags shader_stage = pipeline_layout.get_push_constant_range_stage(stored_push_constants_size);
 
 	if (shader_stage)
 	{
-		vkCmdPushConstants(get_handle(), pipeline_layout.get_handle(), shader_stage, 0, to_u32(stored_push_constants.size()), stored_push_constants.data());
+		vkCmdPushConstants(get_handle(), pipeline_layout.get_handle(), shader_stage, 0, stored_push_constants_size, stored_push_constants.data());
 	}
 	else
 	{
-		LOGW("Push constant range [{}, {}] not found", 0, stored_push_constants.size());
+		LOGW("Push constant range [{}, {}] not found", 0, stored_push_constants_size);
 	}
 
-	stored_push_constants.clear();
+	stored_push_constants_size = 0;
 }
 
 void CommandBuffer::set_update_after_bind(bool update_after_bind_)
@@ -722,6 +850,11 @@ void CommandBuffer::set_update_after_bind(bool update_after_bind_)
 	update_after_bind = update_after_bind_;
 }
 
+CommandBuffer::ResetMode CommandBuffer::get_reset_mode() const
+{
+	return command_pool.get_reset_mode();
+}
+
 const CommandBuffer::RenderPassBinding &CommandBuffer::get_current_render_pass() const
 {
 	return current_render_pass;
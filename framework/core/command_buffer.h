@@ -60,6 +60,12 @@ using SubpassC = Subpass<vkb::BindingType::C>;
 class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 {
   public:
+	/// Size of the inline push constant storage, devices reporting a larger limit are clamped to it
+	static constexpr uint32_t MAX_PUSH_CONSTANTS_SIZE = 256;
+
+	/// Maximum number of dynamic offsets passed when binding a descriptor set
+	static constexpr uint32_t MAX_DYNAMIC_OFFSETS = 32;
+
 	enum class ResetMode
 	{
 		ResetPool,
@@ -92,8 +98,10 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 	/**
 	 * @brief Flushes the command buffer, pushing the new changes
 	 * @param pipeline_bind_point The type of pipeline we want to flush
+	 * @return False if no pipeline is available yet and the next command must be skipped,
+	 *         which only happens with asynchronous pipeline compilation
 	 */
-	void flush(VkPipelineBindPoint pipeline_bind_point);
+	bool flush(VkPipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Sets the command buffer so that it is ready for recording
@@ -129,7 +137,11 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	void begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
-	void next_subpass();
+	/**
+	 * @brief Moves to the next subpass of the render pass
+	 * @param contents Whether the subpass is recorded inline or in secondary command buffers
+	 */
+	void next_subpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
 	void execute_commands(CommandBuffer &secondary_command_buffer);
 
@@ -150,20 +162,17 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 	 */
 	void push_constants(const std::vector<uint8_t> &values);
 
+	/**
+	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
+	 * @param data Pointer to the byte data to store
+	 * @param size Size of the data in bytes
+	 */
+	void push_constants(const uint8_t *data, uint32_t size);
+
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), to_u32(sizeof(T)));
 	}
 
 	void bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
@@ -250,6 +259,11 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 	 */
 	VkResult reset(ResetMode reset_mode);
 
+	/**
+	 * @return The reset mode of the pool the command buffer was allocated from
+	 */
+	ResetMode get_reset_mode() const;
+
 	RenderPass &get_render_pass(const vkb::RenderTarget                                      &render_target,
 	                            const std::vector<LoadStoreInfo>                             &load_store_infos,
 	                            const std::vector<std::unique_ptr<vkb::rendering::SubpassC>> &subpasses);
@@ -265,7 +279,9 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	ResourceBindingState resource_binding_state;
 
-	std::vector<uint8_t> stored_push_constants;
+	std::array<uint8_t, MAX_PUSH_CONSTANTS_SIZE> stored_push_constants{};
+
+	uint32_t stored_push_constants_size{0};
 
 	uint32_t max_push_constants_size;
 
@@ -277,7 +293,7 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 	// that contain update after bind, as they wont be implicitly updated
 	bool update_after_bind{false};
 
-	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
+	BindingTable<DescriptorSetLayout *, ResourceBindingState::MAX_SETS> descriptor_set_layout_binding_state;
 
 	const RenderPassBinding &get_current_render_pass() const;
 
@@ -290,14 +306,29 @@ class CommandBuffer : public vkb::core::VulkanResourceC<VkCommandBuffer>
 
 	/**
 	 * @brief Flush the pipeline state
+	 * @return False if no pipeline could be bound
 	 */
-	void flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
+	bool flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Flush the descriptor set state
 	 */
 	void flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point);
 
+	/**
+	 * @brief Binds the descriptor set of a resource set if it is dirty or its layout changed
+	 */
+	void flush_resource_set(VkPipelineBindPoint pipeline_bind_point, uint32_t descriptor_set_id, const ResourceSet &resource_set, bool layout_changed);
+
+	/**
+	 * @brief Builds the descriptor writes of a resource set for the bindings present in a descriptor set layout
+	 *        Dynamic buffer offsets are left out, they are passed when binding the descriptor set
+	 */
+	void collect_descriptor_infos(const DescriptorSetLayout          &descriptor_set_layout,
+	                              const ResourceSet                  &resource_set,
+	                              BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                              BindingMap<VkDescriptorImageInfo>  &image_infos) const;
+
 	/**
 	 * @brief Flush the push constant state
 	 */
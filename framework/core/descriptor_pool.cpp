@@ -17,16 +17,74 @@
 
 #include "descriptor_pool.h"
 
+#include "common/strings.h"
+#include "core/util/logging.hpp"
 #include "descriptor_set_layout.h"
 #include "device.h"
+#include "filesystem/filesystem.hpp"
 
 namespace vkb
 {
+namespace
+{
+/// Identifies a descriptor pool usage file
+constexpr uint32_t DESCRIPTOR_POOL_USAGE_MAGIC = 0x50444B56;        // "VKDP"
+
+constexpr uint32_t DESCRIPTOR_POOL_USAGE_VERSION = 1;
+
+const char *DESCRIPTOR_POOL_USAGE_FILENAME = "descriptor_pool_usage.bin";
+
+/**
+ * @brief Hashes the content of a descriptor set layout, unlike its handle it is the same across runs
+ */
+size_t hash_layout_content(const DescriptorSetLayout &descriptor_set_layout)
+{
+	size_t result = 0;
+
+	for (auto &binding : descriptor_set_layout.get_bindings())
+	{
+		hash_combine(result, binding.binding);
+		hash_combine(result, static_cast<uint32_t>(binding.descriptorType));
+		hash_combine(result, binding.descriptorCount);
+		hash_combine(result, static_cast<uint32_t>(binding.stageFlags));
+	}
+
+	for (auto binding_flag : descriptor_set_layout.get_binding_flags())
+	{
+		hash_combine(result, static_cast<uint32_t>(binding_flag));
+	}
+
+	return result;
+}
+
+/**
+ * @brief Rounds up to the next power of two
+ */
+uint32_t next_power_of_two(uint32_t value)
+{
+	uint32_t result = 1;
+
+	while (result < value)
+	{
+		result <<= 1;
+	}
+
+	return result;
+}
+}        // namespace
+
+std::atomic<bool>                    DescriptorPool::usage_hints_enabled{true};
+std::mutex                           DescriptorPool::usage_mutex;
+std::unordered_map<size_t, uint32_t> DescriptorPool::recorded_usage;
+
 DescriptorPool::DescriptorPool(Device &                   device,
                                const DescriptorSetLayout &descriptor_set_layout,
-                               uint32_t                   pool_size) :
+                               uint32_t                   pool_size,
+                               bool                       free_descriptor_sets) :
     device{device},
-    descriptor_set_layout{&descriptor_set_layout}
+    descriptor_set_layout{&descriptor_set_layout},
+    free_descriptor_sets{free_descriptor_sets},
+    usage_key{hash_layout_content(descriptor_set_layout)}
 {
 	const auto &bindings = descriptor_set_layout.get_bindings();
 
@@ -43,21 +101,35 @@ DescriptorPool::DescriptorPool(Device &                   device,
 
 	auto pool_size_it = pool_sizes.begin();
 
-	// Fill pool size for each descriptor type count multiplied by the pool size
+	// Fill pool size for each descriptor type count, it is multiplied by the number of sets when creating a pool
 	for (auto &it : descriptor_type_counts)
 	{
 		pool_size_it->type = it.first;
 
-		pool_size_it->descriptorCount = it.second * pool_size;
+		pool_size_it->descriptorCount = it.second;
 
 		++pool_size_it;
 	}
 
-	pool_max_sets = pool_size;
+	pool_max_sets = std::max(pool_size, 1u);
+
+	// Start with a pool large enough for the usage recorded in a previous run
+	if (usage_hints_enabled)
+	{
+		std::lock_guard<std::mutex> guard(usage_mutex);
+
+		auto usage_it = recorded_usage.find(usage_key);
+		if (usage_it != recorded_usage.end())
+		{
+			pool_max_sets = std::max(pool_max_sets, std::min(next_power_of_two(usage_it->second), MAX_POOL_SIZE));
+		}
+	}
 }
 
 DescriptorPool::~DescriptorPool()
 {
+	record_usage();
+
 	// Destroy all descriptor pools
 	for (auto pool : pools)
 	{
@@ -67,15 +139,43 @@ DescriptorPool::~DescriptorPool()
 
 void DescriptorPool::reset()
 {
-	// Reset all descriptor pools
-	for (auto pool : pools)
+	record_usage();
+
+	if (pools.size() > 1)
+	{
+		// The pool had to grow, replace its pools with a single one large enough for the peak usage
+		uint32_t first_pool_max_sets = pools_max_sets.front();
+
+		for (auto pool : pools)
+		{
+			vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+		}
+
+		pools.clear();
+		pools_max_sets.clear();
+		pool_sets_count.clear();
+		pools_full.clear();
+
+		pool_max_sets = std::max(first_pool_max_sets, std::min(next_power_of_two(peak_set_count), MAX_POOL_SIZE));
+	}
+	else
 	{
-		vkResetDescriptorPool(device.get_handle(), pool, 0);
+		// Reset all descriptor pools
+		for (auto pool : pools)
+		{
+			vkResetDescriptorPool(device.get_handle(), pool, 0);
+		}
+
+		// Clear internal tracking of descriptor set allocations
+		std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
+		std::fill(pools_full.begin(), pools_full.end(), false);
 	}
 
-	// Clear internal tracking of descriptor set allocations
-	std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
 	set_pool_mapping.clear();
+	available_pools.clear();
+
+	// The peak usage has been recorded, the next one is measured from this reset
+	peak_set_count = 0;
 
 	// Reset the pool index from which descriptor sets are allocated
 	pool_index = 0;
@@ -94,34 +194,61 @@ void DescriptorPool::set_descriptor_set_layout(const DescriptorSetLayout &set_la
 
 VkDescriptorSet DescriptorPool::allocate()
 {
-	pool_index = find_available_pool(pool_index);
-
-	// Increment allocated set count for the current pool
-	++pool_sets_count[pool_index];
-
 	VkDescriptorSetLayout set_layout = get_descriptor_set_layout().get_handle();
 
 	VkDescriptorSetAllocateInfo alloc_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-	alloc_info.descriptorPool     = pools[pool_index];
 	alloc_info.descriptorSetCount = 1;
 	alloc_info.pSetLayouts        = &set_layout;
 
 	VkDescriptorSet handle = VK_NULL_HANDLE;
 
-	// Allocate a new descriptor set from the current pool
-	auto result = vkAllocateDescriptorSets(device.get_handle(), &alloc_info, &handle);
-
-	if (result != VK_SUCCESS)
+	// A pool may run out of memory before reaching its max sets when it is fragmented by freed sets,
+	// in which case the allocation is attempted once more from another pool
+	for (uint32_t attempt = 0; attempt < 2; ++attempt)
 	{
-		// Decrement allocated set count for the current pool
-		--pool_sets_count[pool_index];
+		pool_index = find_available_pool(attempt == 0 ? pool_index : to_u32(pools.size()));
+
+		if (pool_index >= pools.size())
+		{
+			++allocation_failures;
+			return VK_NULL_HANDLE;
+		}
+
+		alloc_info.descriptorPool = pools[pool_index];
+
+		// Allocate a new descriptor set from the current pool
+		auto result = vkAllocateDescriptorSets(device.get_handle(), &alloc_info, &handle);
+
+		if (result == VK_SUCCESS)
+		{
+			break;
+		}
+
+		++allocation_failures;
+		handle = VK_NULL_HANDLE;
+
+		if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+		{
+			return VK_NULL_HANDLE;
+		}
 
+		// Do not try this pool again until it is reset
+		pools_full[pool_index] = true;
+	}
+
+	if (handle == VK_NULL_HANDLE)
+	{
 		return VK_NULL_HANDLE;
 	}
 
+	// Increment allocated set count for the current pool
+	++pool_sets_count[pool_index];
+
 	// Store mapping between the descriptor set and the pool
 	set_pool_mapping.emplace(handle, pool_index);
 
+	peak_set_count = std::max(peak_set_count, to_u32(set_pool_mapping.size()));
+
 	return handle;
 }
 
@@ -130,7 +257,8 @@ VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
 	// Get the pool index of the descriptor set
 	auto it = set_pool_mapping.find(descriptor_set);
 
-	if (it == set_pool_mapping.end())
+	// Sets of pools created without FREE_DESCRIPTOR_SET_BIT are only reclaimed on reset
+	if (it == set_pool_mapping.end() || !free_descriptor_sets)
 	{
 		return VK_INCOMPLETE;
 	}
@@ -143,63 +271,229 @@ VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
 	// Remove descriptor set mapping to the pool
 	set_pool_mapping.erase(it);
 
+	// The pool has space again, make it available unless it is the current pool or it is known to be full
+	if (pool_sets_count[desc_pool_index] == pools_max_sets[desc_pool_index] && desc_pool_index != pool_index && !pools_full[desc_pool_index])
+	{
+		available_pools.push_back(desc_pool_index);
+	}
+
 	// Decrement allocated set count for the pool
 	--pool_sets_count[desc_pool_index];
 
-	// Change the current pool index to use the available pool
-	pool_index = desc_pool_index;
-
 	return VK_SUCCESS;
 }
 
-std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
+bool DescriptorPool::can_free_descriptor_sets() const
 {
-	// Create a new pool
-	if (pools.size() <= search_index)
+	return free_descriptor_sets;
+}
+
+DescriptorPoolStats DescriptorPool::get_stats() const
+{
+	DescriptorPoolStats stats;
+
+	stats.pool_count          = to_u32(pools.size());
+	stats.set_count           = to_u32(set_pool_mapping.size());
+	stats.peak_set_count      = peak_set_count;
+	stats.allocation_failures = allocation_failures;
+
+	for (auto max_sets : pools_max_sets)
 	{
-		VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+		stats.max_sets += max_sets;
+	}
 
-		create_info.poolSizeCount = to_u32(pool_sizes.size());
-		create_info.pPoolSizes    = pool_sizes.data();
-		create_info.maxSets       = pool_max_sets;
+	return stats;
+}
 
-		// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
-		create_info.flags = 0;
+void DescriptorPool::set_usage_hints_enabled(bool enabled)
+{
+	usage_hints_enabled = enabled;
+}
+
+void DescriptorPool::load_usage_hints()
+{
+	if (!usage_hints_enabled)
+	{
+		return;
+	}
 
-		// Check descriptor set layout and enable the required flags
-		auto &binding_flags = descriptor_set_layout->get_binding_flags();
-		for (auto binding_flag : binding_flags)
+	std::vector<uint8_t> data;
+
+	try
+	{
+		auto fs       = vkb::filesystem::get();
+		auto filename = fs->temp_directory() / DESCRIPTOR_POOL_USAGE_FILENAME;
+
+		if (!fs->is_file(filename))
 		{
-			if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
-			{
-				create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
-			}
+			return;
 		}
 
-		VkDescriptorPool handle = VK_NULL_HANDLE;
+		data = fs->read_file_binary(filename);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to read descriptor pool usage: {}", e.what());
+		return;
+	}
+
+	std::istringstream is{std::string{data.begin(), data.end()}};
+
+	uint32_t magic{0};
+	uint32_t version{0};
+	size_t   entry_count{0};
+	read(is, magic, version, entry_count);
+
+	if (is.fail() || magic != DESCRIPTOR_POOL_USAGE_MAGIC || version != DESCRIPTOR_POOL_USAGE_VERSION)
+	{
+		LOGW("Ignoring stale descriptor pool usage");
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(usage_mutex);
 
-		// Create the Vulkan descriptor pool
-		auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+	for (size_t i = 0; i < entry_count; i++)
+	{
+		size_t   key{0};
+		uint32_t set_count{0};
+		read(is, key, set_count);
 
-		if (result != VK_SUCCESS)
+		if (is.fail())
 		{
-			return 0;
+			LOGW("Ignoring truncated descriptor pool usage");
+			break;
 		}
 
-		// Store internally the Vulkan handle
-		pools.push_back(handle);
+		recorded_usage[key] = std::max(recorded_usage[key], set_count);
+	}
+}
 
-		// Add set count for the descriptor pool
-		pool_sets_count.push_back(0);
+void DescriptorPool::save_usage_hints()
+{
+	if (!usage_hints_enabled)
+	{
+		return;
+	}
 
-		return search_index;
+	std::ostringstream os;
+
+	{
+		std::lock_guard<std::mutex> guard(usage_mutex);
+
+		if (recorded_usage.empty())
+		{
+			return;
+		}
+
+		write(os, DESCRIPTOR_POOL_USAGE_MAGIC, DESCRIPTOR_POOL_USAGE_VERSION, recorded_usage.size());
+
+		for (auto &usage : recorded_usage)
+		{
+			write(os, usage.first, usage.second);
+		}
+	}
+
+	auto data_str = os.str();
+
+	try
+	{
+		auto fs = vkb::filesystem::get();
+		fs->write_file(fs->temp_directory() / DESCRIPTOR_POOL_USAGE_FILENAME, std::vector<uint8_t>{data_str.begin(), data_str.end()});
 	}
-	else if (pool_sets_count[search_index] < pool_max_sets)
+	catch (const std::exception &e)
+	{
+		// Pools are sized from their initial size next time
+		LOGW("Failed to write descriptor pool usage: {}", e.what());
+	}
+}
+
+std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
+{
+	// Keep allocating from the current pool until it is full
+	if (search_index < pools.size() && !pools_full[search_index] && pool_sets_count[search_index] < pools_max_sets[search_index])
 	{
 		return search_index;
 	}
 
-	// Increment pool index
-	return find_available_pool(++search_index);
+	// Then from pools which had sets freed, or which were reset
+	while (!available_pools.empty())
+	{
+		uint32_t available_index = available_pools.back();
+		available_pools.pop_back();
+
+		if (!pools_full[available_index] && pool_sets_count[available_index] < pools_max_sets[available_index])
+		{
+			return available_index;
+		}
+	}
+
+	// Create a new pool
+	return create_pool();
+}
+
+std::uint32_t DescriptorPool::create_pool()
+{
+	// Scale the descriptor counts of a set to the number of sets of the pool
+	std::vector<VkDescriptorPoolSize> scaled_pool_sizes{pool_sizes};
+	for (auto &pool_size : scaled_pool_sizes)
+	{
+		pool_size.descriptorCount *= pool_max_sets;
+	}
+
+	VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+
+	create_info.poolSizeCount = to_u32(scaled_pool_sizes.size());
+	create_info.pPoolSizes    = scaled_pool_sizes.data();
+	create_info.maxSets       = pool_max_sets;
+
+	// Only set FREE_DESCRIPTOR_SET_BIT if individual descriptor sets are going to be freed
+	create_info.flags = free_descriptor_sets ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0;
+
+	// Check descriptor set layout and enable the required flags
+	auto &binding_flags = descriptor_set_layout->get_binding_flags();
+	for (auto binding_flag : binding_flags)
+	{
+		if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
+		{
+			create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+		}
+	}
+
+	VkDescriptorPool handle = VK_NULL_HANDLE;
+
+	// Create the Vulkan descriptor pool
+	auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		LOGE("Failed to create a descriptor pool of {} sets: {}", pool_max_sets, to_string(result));
+		return to_u32(pools.size());
+	}
+
+	// Store internally the Vulkan handle
+	pools.push_back(handle);
+
+	// Add max sets and set count for the descriptor pool
+	pools_max_sets.push_back(pool_max_sets);
+	pool_sets_count.push_back(0);
+	pools_full.push_back(false);
+
+	// The next pool is twice as large, so that the number of pools grows logarithmically with the number of sets
+	pool_max_sets = std::min(pool_max_sets * 2, std::max(MAX_POOL_SIZE, pool_max_sets));
+
+	return to_u32(pools.size() - 1);
+}
+
+void DescriptorPool::record_usage()
+{
+	if (peak_set_count == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(usage_mutex);
+
+	auto &usage = recorded_usage[usage_key];
+	usage       = std::max(usage, peak_set_count);
 }
 }        // namespace vkb
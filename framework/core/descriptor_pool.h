@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
 
 #include "common/helpers.h"
@@ -28,16 +30,55 @@ class Device;
 class DescriptorSetLayout;
 
 /**
- * @brief Manages an array of fixed size VkDescriptorPool and is able to allocate descriptor sets
+ * @brief Statistics of a descriptor pool
+ */
+struct DescriptorPoolStats
+{
+	/// Number of Vulkan descriptor pools
+	uint32_t pool_count{0};
+
+	/// Total number of sets which can be allocated from the Vulkan descriptor pools
+	uint32_t max_sets{0};
+
+	/// Number of sets currently allocated
+	uint32_t set_count{0};
+
+	/// Highest number of sets allocated between two resets
+	uint32_t peak_set_count{0};
+
+	/// Number of failed vkAllocateDescriptorSets calls
+	uint32_t allocation_failures{0};
+};
+
+/**
+ * @brief Manages an array of VkDescriptorPool and is able to allocate descriptor sets
+ *
+ * Each Vulkan pool created is twice as large as the previous one, up to MAX_POOL_SIZE sets,
+ * and sets are allocated from the current pool until it is full. On reset, a pool which had to
+ * grow is replaced by a single pool large enough for the peak usage.
+ *
+ * The peak usage of each descriptor set layout is also recorded process-wide, and can be saved
+ * at the end of a run so that the next run creates pools of the right size from the start.
  */
 class DescriptorPool
 {
   public:
 	static const uint32_t MAX_SETS_PER_POOL = 16;
 
+	/// Maximum number of sets of a single Vulkan pool
+	static const uint32_t MAX_POOL_SIZE = 1024;
+
+	/**
+	 * @brief Creates a descriptor pool, the Vulkan pools are created on demand
+	 * @param device A valid Vulkan device
+	 * @param descriptor_set_layout The layout of the descriptor sets allocated from the pool
+	 * @param pool_size Number of sets to allocate for the first Vulkan pool, unless a larger usage was recorded
+	 * @param free_descriptor_sets True if individual descriptor sets are going to be freed
+	 */
 	DescriptorPool(Device &                   device,
 	               const DescriptorSetLayout &descriptor_set_layout,
-	               uint32_t                   pool_size = MAX_SETS_PER_POOL);
+	               uint32_t                   pool_size            = MAX_SETS_PER_POOL,
+	               bool                       free_descriptor_sets = false);
 
 	DescriptorPool(const DescriptorPool &) = delete;
 
@@ -59,30 +100,82 @@ class DescriptorPool
 
 	VkResult free(VkDescriptorSet descriptor_set);
 
+	/**
+	 * @brief Returns true if the pools are created with FREE_DESCRIPTOR_SET_BIT, so that free can reclaim a set
+	 */
+	bool can_free_descriptor_sets() const;
+
+	DescriptorPoolStats get_stats() const;
+
+	/**
+	 * @brief Enables or disables sizing new pools from the recorded usage, it is enabled by default
+	 */
+	static void set_usage_hints_enabled(bool enabled);
+
+	/**
+	 * @brief Loads the usage recorded by save_usage_hints in a previous run
+	 */
+	static void load_usage_hints();
+
+	/**
+	 * @brief Saves the peak usage recorded for each descriptor set layout so far
+	 */
+	static void save_usage_hints();
+
   private:
 	Device &device;
 
 	const DescriptorSetLayout *descriptor_set_layout{nullptr};
 
-	// Descriptor pool size
+	// Descriptor counts of a single set, for each descriptor type
 	std::vector<VkDescriptorPoolSize> pool_sizes;
 
-	// Number of sets to allocate for each pool
+	// Number of sets to allocate for the next pool
 	uint32_t pool_max_sets{0};
 
+	// Whether the pools are created with FREE_DESCRIPTOR_SET_BIT
+	bool free_descriptor_sets{false};
+
 	// Total descriptor pools created
 	std::vector<VkDescriptorPool> pools;
 
+	// Max sets of each pool
+	std::vector<uint32_t> pools_max_sets;
+
 	// Count sets for each pool
 	std::vector<uint32_t> pool_sets_count;
 
+	// Pools which failed an allocation before reaching their max sets, they are skipped until the next reset
+	std::vector<bool> pools_full;
+
+	// Pools other than the current one which have space left
+	std::vector<uint32_t> available_pools;
+
 	// Current pool index to allocate descriptor set
 	uint32_t pool_index{0};
 
 	// Map between descriptor set and pool index
 	std::unordered_map<VkDescriptorSet, uint32_t> set_pool_mapping;
 
-	// Find next pool index or create new pool
+	// Identifies the descriptor set layout across runs in the recorded usage
+	size_t usage_key{0};
+
+	uint32_t peak_set_count{0};
+
+	uint32_t allocation_failures{0};
+
+	// Find the pool to allocate from, creating a new pool if all are full
 	uint32_t find_available_pool(uint32_t pool_index);
+
+	// Create a new pool of pool_max_sets sets and grow the size of the next one
+	uint32_t create_pool();
+
+	void record_usage();
+
+	static std::atomic<bool> usage_hints_enabled;
+
+	static std::mutex usage_mutex;
+
+	static std::unordered_map<size_t, uint32_t> recorded_usage;
 };
 }        // namespace vkb
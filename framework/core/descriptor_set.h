@@ -83,6 +83,8 @@ class DescriptorSet
 
 	const DescriptorSetLayout &get_layout() const;
 
+	DescriptorPool &get_descriptor_pool() const;
+
 	VkDescriptorSet get_handle() const;
 
 	BindingMap<VkDescriptorBufferInfo> &get_buffer_infos();
@@ -67,6 +67,13 @@ class DescriptorSetLayout
 
 	std::unique_ptr<VkDescriptorSetLayoutBinding> get_layout_binding(const std::string &name) const;
 
+	/**
+	 * @brief Looks up a binding without copying it
+	 * @param binding_index The binding index
+	 * @return The layout binding, or nullptr if the layout does not have this binding
+	 */
+	const VkDescriptorSetLayoutBinding *find_layout_binding(const uint32_t binding_index) const;
+
 	const std::vector<VkDescriptorBindingFlagsEXT> &get_binding_flags() const;
 
 	VkDescriptorBindingFlagsEXT get_layout_binding_flag(const uint32_t binding_index) const;
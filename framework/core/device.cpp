@@ -18,6 +18,8 @@
 
 #include "device.h"
 
+#include "upload_manager.h"
+
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
 
@@ -106,6 +108,32 @@ Device::Device(PhysicalDevice                        &gpu,
 		}
 	}
 
+	// Timeline semaphores track submissions without fences, see submit_and_track.
+	// The features of Vulkan 1.2 can't be chained with the ones of the extension it promoted
+	bool enable_timeline_semaphores = false;
+	if (is_extension_supported(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) &&
+	    !gpu.has_extension_features(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES))
+	{
+		auto timeline_semaphore_features =
+		    gpu.get_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR);
+
+		if (timeline_semaphore_features.timelineSemaphore)
+		{
+			gpu.add_extension_features<VkPhysicalDeviceTimelineSemaphoreFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR)
+			    .timelineSemaphore = VK_TRUE;
+
+			auto requested_it = std::find_if(requested_extensions.begin(),
+			                                 requested_extensions.end(),
+			                                 [](auto const &extension) { return strcmp(extension.first, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0; });
+			if (requested_it == requested_extensions.end())
+			{
+				enabled_extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+			}
+			enable_timeline_semaphores = true;
+			LOGI("Timeline semaphores enabled");
+		}
+	}
+
 	// Check that extensions are supported before trying to create the device
 	std::vector<const char *> unsupported_extensions{};
 	for (auto &extension : requested_extensions)
@@ -186,6 +214,17 @@ Device::Device(PhysicalDevice                        &gpu,
 		}
 	}
 
+	if (enable_timeline_semaphores)
+	{
+		for (auto &queue_family : queues)
+		{
+			for (auto &queue : queue_family)
+			{
+				timeline_semaphores.emplace(queue.get_handle(), std::make_unique<TimelineSemaphore>(*this));
+			}
+		}
+	}
+
 	prepare_memory_allocator();
 
 	command_pool = std::make_unique<CommandPool>(*this, get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0).get_family_index());
@@ -202,10 +241,18 @@ Device::Device(PhysicalDevice &gpu, VkDevice &vulkan_device, VkSurfaceKHR surfac
 
 Device::~Device()
 {
+	// Background jobs of the cache create objects with the device, they complete before anything is destroyed
+	resource_cache.wait_for_warmup();
+	resource_cache.wait_for_pipeline_compiles();
+
+	// Pending uploads are waited for, while the queues and the allocator are still alive
+	upload_manager.reset();
+
 	resource_cache.clear();
 
 	command_pool.reset();
 	fence_pool.reset();
+	timeline_semaphores.clear();
 
 	vkb::allocated::shutdown();
 
@@ -343,6 +390,11 @@ void Device::add_queue(size_t global_index, uint32_t family_index, VkQueueFamily
 		queues.resize(global_index + 1);
 	}
 	queues[global_index].emplace_back(*this, family_index, properties, can_present, 0);
+
+	if (has_timeline_semaphores())
+	{
+		timeline_semaphores.emplace(queues[global_index].back().get_handle(), std::make_unique<TimelineSemaphore>(*this));
+	}
 }
 
 uint32_t Device::get_num_queues_for_queue_family(uint32_t queue_family_index)
@@ -550,8 +602,57 @@ VkResult Device::wait_idle() const
 	return vkDeviceWaitIdle(get_handle());
 }
 
+bool Device::has_timeline_semaphores() const
+{
+	return !timeline_semaphores.empty();
+}
+
+TimelineSemaphore &Device::get_timeline_semaphore(const Queue &queue) const
+{
+	auto it = timeline_semaphores.find(queue.get_handle());
+
+	if (it == timeline_semaphores.end())
+	{
+		throw std::runtime_error("No timeline semaphore for the queue, timeline semaphores are not supported");
+	}
+
+	return *it->second;
+}
+
+uint64_t Device::submit_and_track(const Queue &queue, const VkSubmitInfo &submit_info, VkFence fence)
+{
+	return get_timeline_semaphore(queue).submit(queue.get_handle(), submit_info, fence);
+}
+
+uint64_t Device::submit_and_track(const Queue &queue, const CommandBuffer &command_buffer)
+{
+	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &command_buffer.get_handle();
+
+	return submit_and_track(queue, submit_info);
+}
+
+bool Device::is_complete(const Queue &queue, uint64_t value) const
+{
+	return get_timeline_semaphore(queue).is_complete(value);
+}
+
+void Device::wait_for(const Queue &queue, uint64_t value) const
+{
+	VK_CHECK(get_timeline_semaphore(queue).wait(value));
+}
+
 ResourceCache &Device::get_resource_cache()
 {
 	return resource_cache;
 }
+
+UploadManager &Device::get_upload_manager()
+{
+	std::call_once(upload_manager_created, [this]() { upload_manager = std::make_unique<UploadManager>(*this); });
+
+	return *upload_manager;
+}
 }        // namespace vkb
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "common/helpers.h"
 #include "common/vk_common.h"
 #include "core/command_buffer.h"
@@ -40,9 +42,12 @@
 #include "rendering/pipeline_state.h"
 #include "rendering/render_target.h"
 #include "resource_cache.h"
+#include "timeline_semaphore.h"
 
 namespace vkb
 {
+class UploadManager;
+
 struct DriverVersion
 {
 	uint16_t major;
@@ -210,8 +215,51 @@ class Device : public vkb::core::VulkanResourceC<VkDevice>
 
 	VkResult wait_idle() const;
 
+	/**
+	 * @return True if the timeline semaphore feature is enabled, in which case submissions can be tracked with submit_and_track
+	 */
+	bool has_timeline_semaphores() const;
+
+	/**
+	 * @brief Returns the timeline semaphore tracking the submissions to a queue
+	 *        An error is raised if timeline semaphores are not supported
+	 */
+	TimelineSemaphore &get_timeline_semaphore(const Queue &queue) const;
+
+	/**
+	 * @brief Submits work to a queue, and tracks its completion with the timeline semaphore of the queue
+	 * @param queue The queue to submit to
+	 * @param submit_info The work to submit, it must not chain a VkTimelineSemaphoreSubmitInfo
+	 * @param fence An optional fence to signal as well
+	 * @return The value reached by the timeline semaphore of the queue once the work is complete
+	 */
+	uint64_t submit_and_track(const Queue &queue, const VkSubmitInfo &submit_info, VkFence fence = VK_NULL_HANDLE);
+
+	/**
+	 * @brief Submits a command buffer to a queue, and tracks its completion with the timeline semaphore of the queue
+	 * @return The value reached by the timeline semaphore of the queue once the command buffer completed
+	 */
+	uint64_t submit_and_track(const Queue &queue, const CommandBuffer &command_buffer);
+
+	/**
+	 * @return True if the work tracked with a value returned by submit_and_track completed, without blocking
+	 */
+	bool is_complete(const Queue &queue, uint64_t value) const;
+
+	/**
+	 * @brief Waits for the work tracked with a value returned by submit_and_track to complete
+	 */
+	void wait_for(const Queue &queue, uint64_t value) const;
+
 	ResourceCache &get_resource_cache();
 
+	/**
+	 * @brief Returns the upload manager of the device, created on first use
+	 *        It uploads data to device local resources, on a dedicated transfer queue if there is one
+	 *        Safe to call from several threads, the manager is only created once
+	 */
+	UploadManager &get_upload_manager();
+
   private:
 	const PhysicalDevice &gpu;
 
@@ -230,5 +278,12 @@ class Device : public vkb::core::VulkanResourceC<VkDevice>
 	std::unique_ptr<FencePool> fence_pool;
 
 	ResourceCache resource_cache;
+
+	/// A timeline semaphore for each queue, if the timeline semaphore feature is enabled
+	std::unordered_map<VkQueue, std::unique_ptr<TimelineSemaphore>> timeline_semaphores;
+
+	std::once_flag upload_manager_created;
+
+	std::unique_ptr<UploadManager> upload_manager;
 };
 }        // namespace vkb
@@ -48,6 +48,12 @@ class HPPDescriptorSetLayout;
 class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 {
   public:
+	/// Size of the inline push constant storage, it matches vkb::CommandBuffer::MAX_PUSH_CONSTANTS_SIZE
+	static constexpr uint32_t MAX_PUSH_CONSTANTS_SIZE = 256;
+
+	/// Maximum number of dynamic offsets passed when binding a descriptor set, it matches vkb::CommandBuffer::MAX_DYNAMIC_OFFSETS
+	static constexpr uint32_t MAX_DYNAMIC_OFFSETS = 32;
+
 	struct RenderPassBinding
 	{
 		const vkb::core::HPPRenderPass  *render_pass;
@@ -140,27 +146,18 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	                                          const std::vector<vkb::common::HPPLoadStoreInfo>               &load_store_infos,
 	                                          const std::vector<std::unique_ptr<vkb::rendering::SubpassCpp>> &subpasses);
 	void                      image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier) const;
-	void                      next_subpass();
+	void                      next_subpass(vk::SubpassContents contents = vk::SubpassContents::eInline);
 
 	/**
 	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
 	 * @param values The byte data to store
 	 */
 	void push_constants(const std::vector<uint8_t> &values);
+	void push_constants(const uint8_t *data, uint32_t size);
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), to_u32(sizeof(T)));
 	}
 
 	/**
@@ -198,18 +195,35 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	/**
 	 * @brief Flushes the command buffer, pushing the new changes
 	 * @param pipeline_bind_point The type of pipeline we want to flush
+	 * @return False if no pipeline is available yet and the next command must be skipped,
+	 *         which only happens with asynchronous pipeline compilation
 	 */
-	void flush(vk::PipelineBindPoint pipeline_bind_point);
+	bool flush(vk::PipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Flush the descriptor set state
 	 */
 	void flush_descriptor_state(vk::PipelineBindPoint pipeline_bind_point);
 
+	/**
+	 * @brief Binds the descriptor set of a resource set if it is dirty or its layout changed
+	 */
+	void flush_resource_set(vk::PipelineBindPoint pipeline_bind_point, uint32_t descriptor_set_id, const vkb::HPPResourceSet &resource_set, bool layout_changed);
+
+	/**
+	 * @brief Builds the descriptor writes of a resource set for the bindings present in a descriptor set layout
+	 *        Dynamic buffer offsets are left out, they are passed when binding the descriptor set
+	 */
+	void collect_descriptor_infos(const vkb::core::HPPDescriptorSetLayout &descriptor_set_layout,
+	                              const vkb::HPPResourceSet               &resource_set,
+	                              BindingMap<vk::DescriptorBufferInfo>    &buffer_infos,
+	                              BindingMap<vk::DescriptorImageInfo>     &image_infos) const;
+
 	/**
 	 * @brief Flush the pipeline state
+	 * @return False if no pipeline could be bound
 	 */
-	void flush_pipeline_state(vk::PipelineBindPoint pipeline_bind_point);
+	bool flush_pipeline_state(vk::PipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Flush the push constant state
@@ -230,8 +244,9 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	RenderPassBinding                current_render_pass     = {};
 	vkb::rendering::HPPPipelineState pipeline_state          = {};
 	vkb::HPPResourceBindingState     resource_binding_state  = {};
-	std::vector<uint8_t>             stored_push_constants   = {};
-	uint32_t                         max_push_constants_size = {};
+	std::array<uint8_t, MAX_PUSH_CONSTANTS_SIZE> stored_push_constants      = {};
+	uint32_t                                     stored_push_constants_size = {};
+	uint32_t                                     max_push_constants_size    = {};
 	vk::Extent2D                     last_framebuffer_extent = {};
 	vk::Extent2D                     last_render_area_extent = {};
 
@@ -239,7 +254,7 @@ class HPPCommandBuffer : public vkb::core::VulkanResourceCpp<vk::CommandBuffer>
 	// that contain update after bind, as they wont be implicitly updated
 	bool update_after_bind = false;
 
-	std::unordered_map<uint32_t, vkb::core::HPPDescriptorSetLayout const *> descriptor_set_layout_binding_state;
+	BindingTable<vkb::core::HPPDescriptorSetLayout const *, vkb::HPPResourceBindingState::MAX_SETS> descriptor_set_layout_binding_state;
 };
 
 template <class T>
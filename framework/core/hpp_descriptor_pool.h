@@ -34,6 +34,7 @@ class HPPDevice;
 class HPPDescriptorPool : private vkb::DescriptorPool
 {
   public:
+	using vkb::DescriptorPool::get_stats;
 	using vkb::DescriptorPool::reset;
 
 	HPPDescriptorPool(vkb::core::HPPDevice &device, const vkb::core::HPPDescriptorSetLayout &descriptor_set_layout, uint32_t pool_size = MAX_SETS_PER_POOL) :
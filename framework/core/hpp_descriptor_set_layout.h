@@ -60,6 +60,11 @@ class HPPDescriptorSetLayout : private vkb::DescriptorSetLayout
 		    reinterpret_cast<vk::DescriptorSetLayoutBinding *>(vkb::DescriptorSetLayout::get_layout_binding(binding_index).release()));
 	}
 
+	const vk::DescriptorSetLayoutBinding *find_layout_binding(const uint32_t binding_index) const
+	{
+		return reinterpret_cast<vk::DescriptorSetLayoutBinding const *>(vkb::DescriptorSetLayout::find_layout_binding(binding_index));
+	}
+
 	vk::DescriptorBindingFlagsEXT get_layout_binding_flag(const uint32_t binding_index) const
 	{
 		return static_cast<vk::DescriptorBindingFlagsEXT>(vkb::DescriptorSetLayout::get_layout_binding_flag(binding_index));
@@ -19,6 +19,7 @@
 
 #include <common/hpp_error.h>
 #include <core/hpp_command_pool.h>
+#include <upload_manager.h>
 
 namespace vkb
 {
@@ -178,10 +179,17 @@ HPPDevice::HPPDevice(vkb::core::HPPPhysicalDevice               &gpu,
 
 HPPDevice::~HPPDevice()
 {
+	// Background jobs of the cache create objects with the device, they complete before anything is destroyed
+	resource_cache.wait_for_warmup();
+	resource_cache.wait_for_pipeline_compiles();
+
+	upload_manager.reset();
+
 	resource_cache.clear();
 
 	command_pool.reset();
 	fence_pool.reset();
+	timeline_semaphores.clear();
 
 	vkb::allocated::shutdown();
 
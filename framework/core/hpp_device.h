@@ -25,10 +25,13 @@
 #include <core/hpp_queue.h>
 #include <hpp_fence_pool.h>
 #include <hpp_resource_cache.h>
+#include <timeline_semaphore.h>
 #include <vulkan/vulkan.hpp>
 
 namespace vkb
 {
+class UploadManager;
+
 namespace core
 {
 class HPPBuffer;
@@ -144,6 +147,12 @@ class HPPDevice : public vkb::core::VulkanResourceCpp<vk::Device>
 	std::unique_ptr<vkb::HPPFencePool> fence_pool;
 
 	vkb::HPPResourceCache resource_cache;
+
+	/// A timeline semaphore for each queue, only created by vkb::Device, kept for layout compatibility
+	std::unordered_map<VkQueue, std::unique_ptr<vkb::TimelineSemaphore>> timeline_semaphores;
+
+	/// Only created by vkb::Device, kept for layout compatibility
+	std::unique_ptr<vkb::UploadManager> upload_manager;
 };
 }        // namespace core
 }        // namespace vkb
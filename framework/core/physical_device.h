@@ -144,6 +144,14 @@ class PhysicalDevice
 		return *static_cast<T *>(it->second.get());
 	}
 
+	/**
+	 * @return True if an extension features struct was added to the structure chain used for device creation
+	 */
+	bool has_extension_features(VkStructureType type) const
+	{
+		return extension_features.find(type) != extension_features.end();
+	}
+
 	/**
 	 * @brief Request an optional features flag
 	 *
@@ -21,6 +21,7 @@
 #include "device.h"
 #include "filesystem/legacy.h"
 #include "glsl_compiler.h"
+#include "shader_cache.h"
 #include "spirv_reflection.h"
 
 namespace vkb
@@ -101,23 +102,32 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const Sh
 
 	// Precompile source into the final spirv bytecode
 	auto glsl_final_source = precompile_shader(source);
+	auto glsl_bytes        = convert_to_bytes(glsl_final_source);
 
-	// Compile the GLSL source
-	GLSLCompiler glsl_compiler;
+	// A warm start skips both compilation and reflection
+	auto cache_key = ShaderCache::compute_key(stage, glsl_bytes, entry_point, shader_variant);
 
-	if (!glsl_compiler.compile_to_spirv(stage, convert_to_bytes(glsl_final_source), entry_point, shader_variant, spirv, info_log))
+	if (!ShaderCache::load(cache_key, spirv, resources))
 	{
-		LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
-		LOGE("{}", info_log);
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
-	}
+		// Compile the GLSL source
+		GLSLCompiler glsl_compiler;
 
-	SPIRVReflection spirv_reflection;
+		if (!glsl_compiler.compile_to_spirv(stage, glsl_bytes, entry_point, shader_variant, spirv, info_log))
+		{
+			LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
+			LOGE("{}", info_log);
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
 
-	// Reflect all shader resources
-	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
-	{
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		SPIRVReflection spirv_reflection;
+
+		// Reflect all shader resources
+		if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
+		{
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		ShaderCache::store(cache_key, spirv, resources);
 	}
 
 	// Generate a unique id, determined by source and variant
@@ -17,6 +17,8 @@
 
 #include "frustum.h"
 
+#include <algorithm>
+
 namespace vkb
 {
 void Frustum::update(const glm::mat4 &matrix)
@@ -41,10 +43,11 @@ void Frustum::update(const glm::mat4 &matrix)
 	planes[BOTTOM].z = matrix[2].w + matrix[2].y;
 	planes[BOTTOM].w = matrix[3].w + matrix[3].y;
 
-	planes[BACK].x = matrix[0].w + matrix[0].z;
-	planes[BACK].y = matrix[1].w + matrix[1].z;
-	planes[BACK].z = matrix[2].w + matrix[2].z;
-	planes[BACK].w = matrix[3].w + matrix[3].z;
+	// Clip space depth goes from 0 to 1 (GLM_FORCE_DEPTH_ZERO_TO_ONE), so the near plane is z >= 0
+	planes[BACK].x = matrix[0].z;
+	planes[BACK].y = matrix[1].z;
+	planes[BACK].z = matrix[2].z;
+	planes[BACK].w = matrix[3].z;
 
 	planes[FRONT].x = matrix[0].w - matrix[0].z;
 	planes[FRONT].y = matrix[1].w - matrix[1].z;
@@ -69,6 +72,33 @@ bool Frustum::check_sphere(glm::vec3 pos, float radius)
 	}
 	return true;
 }
+
+bool Frustum::check_box(const glm::vec3 &center, const glm::vec3 &extent) const
+{
+	for (auto &plane : planes)
+	{
+		// Distance to the plane of the corner furthest along its normal
+		float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w <= -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void Frustum::check_boxes(const BoxArray &boxes, size_t begin, size_t end, uint8_t *visible) const
+{
+	std::array<std::array<float, 4>, 6> plane_coefficients;
+	for (size_t i = 0; i < planes.size(); i++)
+	{
+		plane_coefficients[i] = {planes[i].x, planes[i].y, planes[i].z, planes[i].w};
+	}
+
+	boxes.check_planes(plane_coefficients.data(), plane_coefficients.size(), begin, end, visible);
+}
+
 const std::array<glm::vec4, 6> &Frustum::get_planes() const
 {
 	return planes;
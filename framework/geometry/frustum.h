@@ -18,10 +18,12 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "common/error.h"
 
 #include "common/glm_common.h"
+#include "core/util/box_array.hpp"
 
 namespace vkb
 {
@@ -55,6 +57,22 @@ class Frustum
 	 */
 	bool check_sphere(glm::vec3 pos, float radius);
 
+	/**
+	 * @brief Checks if an axis aligned box intersects the Frustum
+	 * @param center The center of the box
+	 * @param extent The half size of the box
+	 */
+	bool check_box(const glm::vec3 &center, const glm::vec3 &extent) const;
+
+	/**
+	 * @brief Checks which boxes of a range intersect the Frustum, see BoxArray::check_planes
+	 * @param boxes The boxes to check
+	 * @param begin The first box of the range
+	 * @param end The end of the range
+	 * @param visible One value per box of the range, set to 1 if the box intersects the frustum or 0 otherwise
+	 */
+	void check_boxes(const BoxArray &boxes, size_t begin, size_t end, uint8_t *visible) const;
+
 	const std::array<glm::vec4, 6> &get_planes() const;
 
   private:
@@ -95,6 +95,16 @@ void GLSLCompiler::reset_target_environment()
 	GLSLCompiler::env_target_language_version = static_cast<glslang::EShTargetLanguageVersion>(0);
 }
 
+glslang::EShTargetLanguage GLSLCompiler::get_target_language()
+{
+	return GLSLCompiler::env_target_language;
+}
+
+glslang::EShTargetLanguageVersion GLSLCompiler::get_target_language_version()
+{
+	return GLSLCompiler::env_target_language_version;
+}
+
 bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     const std::vector<uint8_t> &glsl_source,
                                     const std::string          &entry_point,
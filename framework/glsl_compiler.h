@@ -51,6 +51,16 @@ class GLSLCompiler
 	 */
 	static void reset_target_environment();
 
+	/**
+	 * @brief Get the glslang target language currently used when generating code
+	 */
+	static glslang::EShTargetLanguage get_target_language();
+
+	/**
+	 * @brief Get the glslang target language version currently used when generating code
+	 */
+	static glslang::EShTargetLanguageVersion get_target_language_version();
+
 	/**
 	 * @brief Compiles GLSL to SPIRV code
 	 * @param stage The Vulkan shader stage flag
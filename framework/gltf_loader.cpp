@@ -34,6 +34,7 @@
 #include "common/vk_common.h"
 #include "core/device.h"
 #include "core/image.h"
+#include "core/util/job_system.hpp"
 #include "core/util/logging.hpp"
 #include "filesystem/legacy.h"
 #include "scene_graph/components/camera.h"
@@ -50,8 +51,7 @@
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
 #include "scene_graph/scripts/animation.h"
-
-#include <ctpl_stl.h>
+#include "upload_manager.h"
 
 namespace vkb
 {
@@ -285,23 +285,8 @@ inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uin
 	return result;
 }
 
-inline void upload_image_to_gpu(CommandBuffer &command_buffer, vkb::core::BufferC &staging_buffer, sg::Image &image)
+inline void upload_image_to_gpu(UploadManager &upload_manager, sg::Image &image)
 {
-	// Clean up the image data, as they are copied in the staging buffer
-	image.clear_data();
-
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.src_access_mask = 0;
-		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
-	}
-
 	// Create a buffer image copy for every mip level
 	auto &mipmaps = image.get_mipmaps();
 
@@ -319,19 +304,14 @@ inline void upload_image_to_gpu(CommandBuffer &command_buffer, vkb::core::Buffer
 		copy_region.imageExtent               = mipmap.extent;
 	}
 
-	command_buffer.copy_buffer_to_image(staging_buffer, image.get_vk_image(), buffer_copy_regions);
+	upload_manager.upload_image(image.get_vk_image().get_handle(),
+	                            image.get_format(),
+	                            image.get_data(),
+	                            buffer_copy_regions,
+	                            image.get_vk_image_view().get_subresource_range());
 
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
-	}
+	// Clean up the image data, as they are copied in the staging memory
+	image.clear_data();
 }
 
 inline void prepare_meshlets(std::vector<Meshlet> &meshlets, std::unique_ptr<vkb::sg::SubMesh> &submesh, std::vector<unsigned char> &index_data)
@@ -551,82 +531,60 @@ sg::Scene GLTFLoader::load_scene(int scene_index, VkBufferUsageFlags additional_
 	timer.start();
 
 	// Load images
-	auto thread_count = std::thread::hardware_concurrency();
-	thread_count      = thread_count == 0 ? 1 : thread_count;
-	ctpl::thread_pool thread_pool(thread_count);
+	auto &job_system = JobSystem::get();
+
+	auto &upload_manager = device.get_upload_manager();
 
 	auto image_count = to_u32(model.images.size());
 
-	std::vector<std::future<std::unique_ptr<sg::Image>>> image_component_futures;
+	// Each job fills its own slot, images are then uploaded in order as soon as they are parsed
+	std::vector<std::unique_ptr<sg::Image>> parsed_images(image_count);
+
+	std::vector<JobSystem::JobHandle> image_jobs;
 	for (size_t image_index = 0; image_index < image_count; image_index++)
 	{
-		auto fut = thread_pool.push(
-		    [this, image_index](size_t) {
-			    auto image = parse_image(model.images[image_index]);
-
-			    LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
+		image_jobs.push_back(job_system.schedule([this, image_index, &parsed_images]() {
+			parsed_images[image_index] = parse_image(model.images[image_index]);
 
-			    return image;
-		    });
-
-		image_component_futures.push_back(std::move(fut));
+			LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
+		}));
 	}
 
 	std::vector<std::unique_ptr<sg::Image>> image_components;
 
-	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
-	// double the amount of memory (all the images and all the corresponding buffers).
-	// This helps keep memory footprint lower which is helpful on smaller devices.
-	size_t image_index = 0;
-	while (image_index < image_count)
+	try
 	{
-		std::vector<vkb::core::BufferC> transient_buffers;
-
-		auto &command_buffer = device.request_command_buffer();
-
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
-
-		size_t batch_size = 0;
-
-		// Deal with 64MB of image data at a time to keep memory footprint low
-		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
+		// Upload images to GPU as soon as they are parsed. The upload manager reuses a fixed amount of
+		// staging memory, which keeps the memory footprint low without stalling the device.
+		for (size_t image_index = 0; image_index < image_count; image_index++)
 		{
-			// Wait for this image to complete loading, then stage for upload
-			image_components.push_back(image_component_futures[image_index].get());
-
-			auto &image = image_components[image_index];
+			job_system.wait(image_jobs[image_index]);
+			image_components.push_back(std::move(parsed_images[image_index]));
 
-			core::Buffer stage_buffer = vkb::core::BufferC::create_staging_buffer(device, image->get_data());
-
-			batch_size += image->get_data().size();
-
-			upload_image_to_gpu(command_buffer, stage_buffer, *image);
-
-			transient_buffers.push_back(std::move(stage_buffer));
-
-			image_index++;
+			upload_image_to_gpu(upload_manager, *image_components[image_index]);
 		}
 
-		command_buffer.end();
-
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-		queue.submit(command_buffer, device.request_fence());
-
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
-		device.wait_idle();
-
-		// Remove the staging buffers for the batch we just processed
-		transient_buffers.clear();
+		// Later submissions to the graphics queue are ordered after the uploads
+		upload_manager.flush();
+	}
+	catch (...)
+	{
+		// The jobs still running write to this stack frame
+		try
+		{
+			job_system.wait(image_jobs);
+		}
+		catch (...)
+		{
+		}
+		throw;
 	}
 
 	scene.set_components(std::move(image_components));
 
 	auto elapsed_time = timer.stop();
 
-	LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
+	LOGI("Time spent loading images: {} seconds across {} workers.", vkb::to_string(elapsed_time), job_system.get_worker_count());
 
 	// Load textures
 	auto images                  = scene.get_components<sg::Image>();
@@ -1105,13 +1063,7 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 
 	auto submesh = std::make_unique<sg::SubMesh>();
 
-	std::vector<vkb::core::BufferC> transient_buffers;
-
-	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	auto &command_buffer = device.request_command_buffer();
-
-	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	auto &upload_manager = device.get_upload_manager();
 
 	assert(index < model.meshes.size());
 	auto &gltf_mesh = model.meshes[index];
@@ -1188,19 +1140,15 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 			aligned_vertex_data.push_back(vert);
 		}
 
-		vkb::core::BufferC stage_buffer = vkb::core::BufferC::create_staging_buffer(device, aligned_vertex_data);
-
 		vkb::core::BufferC buffer{device,
 		                          aligned_vertex_data.size() * sizeof(AlignedVertex),
 		                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 		                          VMA_MEMORY_USAGE_GPU_ONLY};
 
-		command_buffer.copy_buffer(stage_buffer, buffer, aligned_vertex_data.size() * sizeof(AlignedVertex));
+		upload_manager.upload_buffer(buffer, aligned_vertex_data.data(), aligned_vertex_data.size() * sizeof(AlignedVertex));
 
 		auto pair = std::make_pair("vertex_buffer", std::move(buffer));
 		submesh->vertex_buffers.insert(std::move(pair));
-
-		transient_buffers.push_back(std::move(stage_buffer));
 	}
 	else
 	{
@@ -1231,19 +1179,15 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 			vertex_data.push_back(vert);
 		}
 
-		vkb::core::BufferC stage_buffer = vkb::core::BufferC::create_staging_buffer(device, vertex_data);
-
 		vkb::core::BufferC buffer{device,
 		                          vertex_data.size() * sizeof(Vertex),
 		                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 		                          VMA_MEMORY_USAGE_GPU_ONLY};
 
-		command_buffer.copy_buffer(stage_buffer, buffer, vertex_data.size() * sizeof(Vertex));
+		upload_manager.upload_buffer(buffer, vertex_data.data(), vertex_data.size() * sizeof(Vertex));
 
 		auto pair = std::make_pair("vertex_buffer", std::move(buffer));
 		submesh->vertex_buffers.insert(std::move(pair));
-
-		transient_buffers.push_back(std::move(stage_buffer));
 	}
 
 	if (gltf_primitive.indices >= 0)
@@ -1288,39 +1232,26 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 			// vertex_indices and index_buffer are used for meshlets now
 			submesh->vertex_indices = static_cast<uint32_t>(meshlets.size());
 
-			vkb::core::BufferC stage_buffer = vkb::core::BufferC::create_staging_buffer(device, meshlets);
-
 			submesh->index_buffer = std::make_unique<vkb::core::BufferC>(device,
 			                                                             meshlets.size() * sizeof(Meshlet),
 			                                                             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 			                                                             VMA_MEMORY_USAGE_GPU_ONLY);
 
-			command_buffer.copy_buffer(stage_buffer, *submesh->index_buffer, meshlets.size() * sizeof(Meshlet));
-
-			transient_buffers.push_back(std::move(stage_buffer));
+			upload_manager.upload_buffer(*submesh->index_buffer, meshlets.data(), meshlets.size() * sizeof(Meshlet));
 		}
 		else
 		{
-			vkb::core::BufferC stage_buffer = vkb::core::BufferC::create_staging_buffer(device, index_data);
-
 			submesh->index_buffer = std::make_unique<vkb::core::BufferC>(device,
 			                                                             index_data.size(),
 			                                                             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 			                                                             VMA_MEMORY_USAGE_GPU_ONLY);
 
-			command_buffer.copy_buffer(stage_buffer, *submesh->index_buffer, index_data.size());
-
-			transient_buffers.push_back(std::move(stage_buffer));
+			upload_manager.upload_buffer(*submesh->index_buffer, index_data.data(), index_data.size());
 		}
 	}
 
-	command_buffer.end();
-
-	queue.submit(command_buffer, device.request_fence());
-
-	device.get_fence_pool().wait();
-	device.get_fence_pool().reset();
-	device.get_command_pool().reset_pool();
+	// Later submissions to the graphics queue are ordered after the uploads
+	upload_manager.flush();
 
 	return std::move(submesh);
 }
@@ -18,6 +18,7 @@
 
 #include "gui.h"
 
+#include <algorithm>
 #include <map>
 #include <numeric>
 
@@ -259,11 +260,11 @@ Gui::Gui(VulkanSampleC &sample_, const Window &window, const Stats *stats, const
 
 	if (explicit_update)
 	{
-		vertex_buffer = std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), 1, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
-		vertex_buffer->set_debug_name("GUI vertex buffer");
+		vertex_buffers.push_back(std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), 1, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU));
+		vertex_buffers.back()->set_debug_name("GUI vertex buffer");
 
-		index_buffer = std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), 1, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
-		index_buffer->set_debug_name("GUI index buffer");
+		index_buffers.push_back(std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), 1, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU));
+		index_buffers.back()->set_debug_name("GUI index buffer");
 	}
 }
 
@@ -386,10 +387,18 @@ void Gui::update(const float delta_time)
 	ImGui::Render();
 }
 
-bool Gui::update_buffers()
+void Gui::set_buffer_count(size_t count)
 {
+	// New sets are allocated by the next update
+	vertex_buffers.resize(std::max<size_t>(count, 1));
+	index_buffers.resize(std::max<size_t>(count, 1));
+}
+
+bool Gui::update_buffers(size_t buffer_index, const std::function<void()> &wait_for_buffers)
+{
+	assert(buffer_index < vertex_buffers.size() && "The buffer index exceeds the buffer count");
+
 	ImDrawData *draw_data = ImGui::GetDrawData();
-	bool        updated   = false;
 
 	if (!draw_data)
 	{
@@ -404,40 +413,50 @@ bool Gui::update_buffers()
 		return false;
 	}
 
-	if ((vertex_buffer->get_handle() == VK_NULL_HANDLE) || (vertex_buffer_size != last_vertex_buffer_size))
+	bool reallocate = (vertex_buffer_size != last_vertex_buffer_size) || (index_buffer_size != last_index_buffer_size) ||
+	                  std::any_of(vertex_buffers.begin(), vertex_buffers.end(), [](auto &buffer) { return !buffer; });
+
+	if (reallocate)
 	{
+		if (wait_for_buffers)
+		{
+			wait_for_buffers();
+		}
+
 		last_vertex_buffer_size = vertex_buffer_size;
-		updated                 = true;
+		last_index_buffer_size  = index_buffer_size;
 
-		vertex_buffer.reset();
-		vertex_buffer = std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), vertex_buffer_size,
-		                                                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-		                                                     VMA_MEMORY_USAGE_GPU_TO_CPU);
-		vertex_buffer->set_debug_name("GUI vertex buffer");
+		for (size_t i = 0; i < vertex_buffers.size(); ++i)
+		{
+			vertex_buffers[i] = std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), vertex_buffer_size,
+			                                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			                                                         VMA_MEMORY_USAGE_GPU_TO_CPU);
+			vertex_buffers[i]->set_debug_name("GUI vertex buffer");
+
+			index_buffers[i] = std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), index_buffer_size,
+			                                                        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+			                                                        VMA_MEMORY_USAGE_GPU_TO_CPU);
+			index_buffers[i]->set_debug_name("GUI index buffer");
+		}
 	}
 
-	if ((index_buffer->get_handle() == VK_NULL_HANDLE) || (index_buffer_size != last_index_buffer_size))
-	{
-		last_index_buffer_size = index_buffer_size;
-		updated                = true;
-
-		index_buffer.reset();
-		index_buffer = std::make_unique<vkb::core::BufferC>(sample.get_render_context().get_device(), index_buffer_size,
-		                                                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-		                                                    VMA_MEMORY_USAGE_GPU_TO_CPU);
-		index_buffer->set_debug_name("GUI index buffer");
-	}
+	// Command buffers recorded after a reallocation draw the current data from every set
+	size_t first_index = reallocate ? 0 : buffer_index;
+	size_t last_index  = reallocate ? vertex_buffers.size() - 1 : buffer_index;
 
-	// Upload data
-	upload_draw_data(draw_data, vertex_buffer->map(), index_buffer->map());
+	for (size_t i = first_index; i <= last_index; ++i)
+	{
+		// Upload data
+		upload_draw_data(draw_data, vertex_buffers[i]->map(), index_buffers[i]->map());
 
-	vertex_buffer->flush();
-	index_buffer->flush();
+		vertex_buffers[i]->flush();
+		index_buffers[i]->flush();
 
-	vertex_buffer->unmap();
-	index_buffer->unmap();
+		vertex_buffers[i]->unmap();
+		index_buffers[i]->unmap();
+	}
 
-	return updated;
+	return reallocate;
 }
 
 void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame)
@@ -588,10 +607,10 @@ void Gui::draw(CommandBuffer &command_buffer)
 	else
 	{
 		std::vector<std::reference_wrapper<const vkb::core::BufferC>> buffers;
-		buffers.push_back(*vertex_buffer);
+		buffers.push_back(*vertex_buffers[0]);
 		command_buffer.bind_vertex_buffers(0, buffers, {0});
 
-		command_buffer.bind_index_buffer(*index_buffer, 0, VK_INDEX_TYPE_UINT16);
+		command_buffer.bind_index_buffer(*index_buffers[0], 0, VK_INDEX_TYPE_UINT16);
 	}
 
 	// Render commands
@@ -651,7 +670,7 @@ void Gui::draw(CommandBuffer &command_buffer)
 	}
 }
 
-void Gui::draw(VkCommandBuffer command_buffer)
+void Gui::draw(VkCommandBuffer command_buffer, size_t buffer_index)
 {
 	if (!visible)
 	{
@@ -663,7 +682,8 @@ void Gui::draw(VkCommandBuffer command_buffer)
 	int32_t     vertex_offset = 0;
 	int32_t     index_offset  = 0;
 
-	if ((!draw_data) || (draw_data->CmdListsCount == 0))
+	// A set added by set_buffer_count holds no data until the next update
+	if ((!draw_data) || (draw_data->CmdListsCount == 0) || !vertex_buffers[buffer_index])
 	{
 		return;
 	}
@@ -679,10 +699,12 @@ void Gui::draw(VkCommandBuffer command_buffer)
 
 	VkDeviceSize offsets[1] = {0};
 
-	VkBuffer vertex_buffer_handle = vertex_buffer->get_handle();
+	assert(buffer_index < vertex_buffers.size() && "The buffer index exceeds the buffer count");
+
+	VkBuffer vertex_buffer_handle = vertex_buffers[buffer_index]->get_handle();
 	vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer_handle, offsets);
 
-	VkBuffer index_buffer_handle = index_buffer->get_handle();
+	VkBuffer index_buffer_handle = index_buffers[buffer_index]->get_handle();
 	vkCmdBindIndexBuffer(command_buffer, index_buffer_handle, 0, VK_INDEX_TYPE_UINT16);
 
 	for (int32_t i = 0; i < draw_data->CmdListsCount; i++)
@@ -176,7 +176,20 @@ class Gui
 	 */
 	void update(const float delta_time);
 
-	bool update_buffers();
+	/**
+	 * @brief Sets the number of vertex and index buffer sets, one for each command buffer drawing the Gui,
+	 *        so that writing the draw data of a frame does not overwrite the data read by the frames in flight
+	 */
+	void set_buffer_count(size_t count);
+
+	/**
+	 * @brief Uploads the draw data to a set of vertex and index buffers
+	 *        If the size of the draw data changed, all the sets are reallocated and written, otherwise only the given set is written.
+	 * @param buffer_index Index of the set to write
+	 * @param wait_for_buffers Called before the buffers are reallocated, so that the GPU can be done with all the sets
+	 * @return True if the buffers were reallocated, the command buffers drawing the Gui must then be recorded again
+	 */
+	bool update_buffers(size_t buffer_index = 0, const std::function<void()> &wait_for_buffers = {});
 
 	/**
 	 * @brief Draws the Gui
@@ -187,8 +200,9 @@ class Gui
 	/**
 	 * @brief Draws the Gui
 	 * @param command_buffer Command buffer to register draw-commands
+	 * @param buffer_index Index of the set of vertex and index buffers to draw from
 	 */
-	void draw(VkCommandBuffer command_buffer);
+	void draw(VkCommandBuffer command_buffer, size_t buffer_index = 0);
 
 	/**
 	 * @brief Shows an overlay top window with app info and maybe stats
@@ -272,13 +286,14 @@ class Gui
 
 	VulkanSampleC &sample;
 
-	std::unique_ptr<vkb::core::BufferC> vertex_buffer;
+	// Vertex and index buffers of each set, see set_buffer_count
+	std::vector<std::unique_ptr<vkb::core::BufferC>> vertex_buffers;
 
-	std::unique_ptr<vkb::core::BufferC> index_buffer;
+	std::vector<std::unique_ptr<vkb::core::BufferC>> index_buffers;
 
-	size_t last_vertex_buffer_size;
+	size_t last_vertex_buffer_size{0};
 
-	size_t last_index_buffer_size;
+	size_t last_index_buffer_size{0};
 
 	///  Scale factor to apply due to a difference between the window and GL pixel sizes
 	float content_scale_factor{1.0f};
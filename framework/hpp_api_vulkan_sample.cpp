@@ -33,16 +33,11 @@ bool HPPApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 
 	depth_format = vkb::common::get_suitable_depth_format(get_device().get_gpu().get_handle());
 
-	// Create synchronization objects
-	// Create a semaphore used to synchronize image presentation
-	// Ensures that the current swapchain render target has completed presentation and has been released by the presentation engine, ready for rendering
-	semaphores.acquired_image_ready = get_device().get_handle().createSemaphore({});
-	// Create a semaphore used to synchronize command submission
-	// Ensures that the image is not presented until all commands have been sumbitted and executed
-	semaphores.render_complete = get_device().get_handle().createSemaphore({});
+	// Create the semaphores and fences used to keep several frames in flight
+	create_frame_synchronization_primitives();
 
 	// Set up submit info structure
-	// Semaphores will stay the same during application lifetime
+	// The submit info points to the semaphores of the current frame, which are updated by prepare_frame
 	// Command buffer submission info is set by each example
 	submit_info                   = vk::SubmitInfo();
 	submit_info.pWaitDstStageMask = &submit_pipeline_stages;
@@ -71,6 +66,7 @@ bool HPPApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 void HPPApiVulkanSample::prepare_gui()
 {
 	create_gui(*window, nullptr, 15.0f, true);
+	get_gui().set_buffer_count(draw_cmd_buffers.size());
 	get_gui().prepare(pipeline_cache,
 	                  render_pass,
 	                  {static_cast<VkPipelineShaderStageCreateInfo>(load_shader("uioverlay/uioverlay.vert", vk::ShaderStageFlagBits::eVertex)),
@@ -450,13 +446,8 @@ void HPPApiVulkanSample::update_overlay(float delta_time, const std::function<vo
 
 		get_gui().show_simple_window(get_name(), fps, [this, additional_ui]() { on_update_ui_overlay(get_gui().get_drawer()); });
 
+		// The GUI buffers are written by prepare_frame, once the GPU is done with the buffers of the acquired image
 		get_gui().update(delta_time);
-
-		if (get_gui().update_buffers() || get_gui().get_drawer().is_dirty())
-		{
-			rebuild_command_buffers();
-			get_gui().get_drawer().clear();
-		}
 	}
 }
 
@@ -467,12 +458,22 @@ void HPPApiVulkanSample::draw_ui(const vk::CommandBuffer command_buffer)
 		command_buffer.setViewport(0, vk::Viewport(0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f));
 		command_buffer.setScissor(0, vk::Rect2D({0, 0}, extent));
 
-		get_gui().draw(command_buffer);
+		// The command buffer of a swapchain image draws from the GUI buffers of that image
+		auto   it           = std::find(draw_cmd_buffers.begin(), draw_cmd_buffers.end(), command_buffer);
+		size_t buffer_index = (it != draw_cmd_buffers.end()) ? std::distance(draw_cmd_buffers.begin(), it) : current_buffer;
+
+		get_gui().draw(command_buffer, buffer_index);
 	}
 }
 
 void HPPApiVulkanSample::prepare_frame()
 {
+	// Wait for the GPU to be done with the last frame which used the synchronization objects of this frame
+	vk::Device device = get_device().get_handle();
+	(void) device.waitForFences(frame_fences[frame_index], true, std::numeric_limits<uint64_t>::max());
+
+	semaphores.acquired_image_ready = frame_acquired_semaphores[frame_index];
+
 	if (get_render_context().has_swapchain())
 	{
 		handle_surface_changes();
@@ -492,10 +493,50 @@ void HPPApiVulkanSample::prepare_frame()
 		// VK_SUBOPTIMAL_KHR is a success code and means that acquire was successful and semaphore is signaled but image is suboptimal
 		// allow rendering frame to suboptimal swapchain as otherwise we would have to manually unsignal semaphore and acquire image again
 	}
+
+	// The swapchain may have more images than the surface reported at prepare time
+	while (image_render_semaphores.size() <= current_buffer)
+	{
+		image_render_semaphores.push_back(device.createSemaphore({}));
+	}
+	if (image_fences.size() <= current_buffer)
+	{
+		image_fences.resize(current_buffer + 1);
+	}
+
+	// Images may be acquired out of order: the command buffer of this image can only be submitted again
+	// once the frame which last rendered to it is complete
+	if (image_fences[current_buffer] && image_fences[current_buffer] != frame_fences[frame_index])
+	{
+		(void) device.waitForFences(image_fences[current_buffer], true, std::numeric_limits<uint64_t>::max());
+	}
+	image_fences[current_buffer] = frame_fences[frame_index];
+
+	semaphores.render_complete = image_render_semaphores[current_buffer];
+
+	if (has_gui())
+	{
+		get_gui().set_buffer_count(draw_cmd_buffers.size());
+
+		// Reallocating the GUI buffers replaces the buffers of all the images, including those still in flight
+		if (get_gui().update_buffers(current_buffer, [this]() { wait_for_frames_in_flight(); }) || get_gui().get_drawer().is_dirty())
+		{
+			rebuild_command_buffers();
+			get_gui().get_drawer().clear();
+		}
+	}
 }
 
 void HPPApiVulkanSample::submit_frame()
 {
+	// Signal the fence of this frame once the work submitted to the queue so far is complete.
+	// A submission without batches is ordered after all the previous submissions to the queue
+	vk::Fence frame_fence = frame_fences[frame_index];
+	get_device().get_handle().resetFences(frame_fence);
+	queue.submit({}, frame_fence);
+
+	frame_index = (frame_index + 1) % frame_lag;
+
 	if (get_render_context().has_swapchain())
 	{
 		const auto &queue = get_device().get_queue_by_present(0);
@@ -539,10 +580,110 @@ void HPPApiVulkanSample::submit_frame()
 		}
 	}
 
-	// DO NOT USE
-	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
-	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	get_device().get_queue_by_present(0).get_handle().waitIdle();
+	if (wait_idle_per_frame)
+	{
+		// DO NOT USE
+		// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
+		// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
+		get_device().get_queue_by_present(0).get_handle().waitIdle();
+	}
+	else if (frame_lag == 1)
+	{
+		// Without frames in flight, samples may update the resources used by the frame as soon as it is submitted
+		(void) get_device().get_handle().waitForFences(frame_fence, true, std::numeric_limits<uint64_t>::max());
+	}
+}
+
+void HPPApiVulkanSample::set_frame_lag(uint32_t lag)
+{
+	assert(frame_fences.empty() && "The frame lag must be set before prepare");
+	frame_lag = std::max(lag, 1u);
+}
+
+uint32_t HPPApiVulkanSample::get_frame_lag() const
+{
+	return frame_lag;
+}
+
+uint32_t HPPApiVulkanSample::get_frame_index() const
+{
+	return frame_index;
+}
+
+void HPPApiVulkanSample::wait_for_frames_in_flight()
+{
+	if (!frame_fences.empty())
+	{
+		(void) get_device().get_handle().waitForFences(frame_fences, true, std::numeric_limits<uint64_t>::max());
+	}
+}
+
+void HPPApiVulkanSample::create_frame_uniform_buffers(std::vector<std::unique_ptr<vkb::core::BufferCpp>> &buffers, vk::DeviceSize size)
+{
+	buffers.clear();
+	for (size_t i = 0; i < draw_cmd_buffers.size(); ++i)
+	{
+		buffers.push_back(std::make_unique<vkb::core::BufferCpp>(get_device(), size, vk::BufferUsageFlagBits::eUniformBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU));
+	}
+}
+
+vkb::core::BufferCpp &HPPApiVulkanSample::get_frame_uniform_buffer(std::vector<std::unique_ptr<vkb::core::BufferCpp>> &buffers)
+{
+	assert(current_buffer < buffers.size());
+	return *buffers[current_buffer];
+}
+
+void HPPApiVulkanSample::create_frame_synchronization_primitives()
+{
+	vk::Device device = get_device().get_handle();
+
+	// Semaphores used to synchronize image presentation
+	// Ensure that the current swapchain render target has completed presentation and has been released by the presentation engine, ready for rendering.
+	// Fences are created signaled, as no frame is in flight yet
+	for (uint32_t i = 0; i < frame_lag; ++i)
+	{
+		frame_acquired_semaphores.push_back(device.createSemaphore({}));
+		frame_fences.push_back(device.createFence(vk::FenceCreateInfo(vk::FenceCreateFlagBits::eSignaled)));
+	}
+
+	// Semaphores used to synchronize command submission
+	// Ensure that an image is not presented until all commands have been sumbitted and executed.
+	// A semaphore waited on by a presentation can only be reused once the image is acquired again, hence one per image
+	size_t image_count = std::max<size_t>(get_render_context().get_render_frames().size(), 1);
+	for (size_t i = 0; i < image_count; ++i)
+	{
+		image_render_semaphores.push_back(device.createSemaphore({}));
+	}
+	image_fences.resize(image_render_semaphores.size());
+
+	frame_index                     = 0;
+	semaphores.acquired_image_ready = frame_acquired_semaphores[0];
+	semaphores.render_complete      = image_render_semaphores[0];
+}
+
+void HPPApiVulkanSample::destroy_frame_synchronization_primitives()
+{
+	vk::Device device = get_device().get_handle();
+
+	for (auto &semaphore : frame_acquired_semaphores)
+	{
+		device.destroySemaphore(semaphore);
+	}
+	for (auto &fence : frame_fences)
+	{
+		device.destroyFence(fence);
+	}
+	for (auto &semaphore : image_render_semaphores)
+	{
+		device.destroySemaphore(semaphore);
+	}
+	frame_acquired_semaphores.clear();
+	frame_fences.clear();
+	image_render_semaphores.clear();
+	image_fences.clear();
+
+	semaphores.acquired_image_ready = nullptr;
+	semaphores.render_complete      = nullptr;
 }
 
 HPPApiVulkanSample::~HPPApiVulkanSample()
@@ -579,8 +720,7 @@ HPPApiVulkanSample::~HPPApiVulkanSample()
 
 		device.destroyCommandPool(cmd_pool);
 
-		device.destroySemaphore(semaphores.acquired_image_ready);
-		device.destroySemaphore(semaphores.render_complete);
+		destroy_frame_synchronization_primitives();
 		for (auto &fence : wait_fences)
 		{
 			device.destroyFence(fence);
@@ -596,6 +736,9 @@ void HPPApiVulkanSample::build_command_buffers()
 
 void HPPApiVulkanSample::rebuild_command_buffers()
 {
+	// The command buffers may still be in use by the frames in flight
+	wait_for_frames_in_flight();
+
 	get_device().get_handle().resetCommandPool(cmd_pool);
 	build_command_buffers();
 }
@@ -139,6 +139,48 @@ class HPPApiVulkanSample : public vkb::VulkanSampleCpp
 	// Synchronization fences
 	std::vector<vk::Fence> wait_fences;
 
+	/**
+	 * @brief If true, submit_frame waits for the queue to be idle at the end of every frame
+	 *        This makes synchronization trivial, at the cost of serializing the CPU and the GPU.
+	 *        Otherwise up to frame_lag frames are in flight, and prepare_frame waits for the GPU to be done with the
+	 *        semaphores and the command buffer of the frame about to be prepared
+	 */
+	bool wait_idle_per_frame = false;
+
+	/**
+	 * @brief Sets the maximum number of frames in flight, it must be called before prepare
+	 *        With the default lag of 1, submit_frame waits for the frame to complete, without waiting for the queue to be idle.
+	 *        A sample opting in to a larger lag must not write resources read by a frame in flight, see create_frame_uniform_buffers
+	 */
+	void set_frame_lag(uint32_t lag);
+
+	uint32_t get_frame_lag() const;
+
+	/**
+	 * @return The index of the frame being prepared, between 0 and the frame lag
+	 */
+	uint32_t get_frame_index() const;
+
+	/**
+	 * @brief Waits for the GPU to complete all the frames in flight
+	 *        Command buffers or resources shared by frames can be modified afterwards
+	 */
+	void wait_for_frames_in_flight();
+
+	/**
+	 * @brief Creates a host visible uniform buffer for each command buffer of draw_cmd_buffers
+	 *        Uniforms written every frame should go to the buffer returned by get_frame_uniform_buffer once prepare_frame returned,
+	 *        as a single buffer may still be read by a previous frame in flight
+	 * @param buffers The vector to fill with the buffers
+	 * @param size The size of each buffer
+	 */
+	void create_frame_uniform_buffers(std::vector<std::unique_ptr<vkb::core::BufferCpp>> &buffers, vk::DeviceSize size);
+
+	/**
+	 * @return The buffer matching the command buffer of the current swapchain image
+	 */
+	vkb::core::BufferCpp &get_frame_uniform_buffer(std::vector<std::unique_ptr<vkb::core::BufferCpp>> &buffers);
+
 	/**
 	 * @brief Creates a vulkan sampler
 	 * @param address_mode The samplers address mode
@@ -352,8 +394,31 @@ class HPPApiVulkanSample : public vkb::VulkanSampleCpp
 	virtual void prepare_gui();
 
   private:
+	/**
+	 * @brief Creates the semaphores and fences of the frames in flight
+	 */
+	void create_frame_synchronization_primitives();
+
+	void destroy_frame_synchronization_primitives();
+
 	/** brief Indicates that the view (position, rotation) has changed and buffers containing camera matrices need to be updated */
 	bool view_updated = false;
+
+	// Maximum number of frames in flight
+	uint32_t frame_lag = 1;
+
+	// Index of the frame being prepared
+	uint32_t frame_index = 0;
+
+	// Semaphores used to acquire an image, and fences signaled once the GPU is done with a frame, for each frame in flight
+	std::vector<vk::Semaphore> frame_acquired_semaphores;
+	std::vector<vk::Fence>     frame_fences;
+
+	// Semaphores signaled once rendering to an image is complete, for each swapchain image
+	std::vector<vk::Semaphore> image_render_semaphores;
+
+	// Fence of the last frame which rendered to each swapchain image
+	std::vector<vk::Fence> image_fences;
 	// Destination dimensions for resizing the window
 	vk::Extent2D dest_extent;
 	bool         resizing = false;
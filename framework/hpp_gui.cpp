@@ -21,6 +21,7 @@
 #include <core/hpp_command_pool.h>
 #include <imgui_internal.h>
 
+#include <algorithm>
 #include <numeric>
 
 namespace vkb
@@ -234,19 +235,19 @@ HPPGui::HPPGui(VulkanSampleCpp &sample_, const vkb::Window &window, const vkb::s
 	{
 		auto &device = sample.get_render_context().get_device();
 
-		vertex_buffer =
+		vertex_buffers.push_back(
 		    vkb::core::BufferBuilderCpp(1)
 		        .with_usage(vk::BufferUsageFlagBits::eVertexBuffer)
 		        .with_vma_usage(VMA_MEMORY_USAGE_GPU_TO_CPU)
 		        .with_debug_name("GUI vertex buffer")
-		        .build_unique(device);
+		        .build_unique(device));
 
-		index_buffer =
+		index_buffers.push_back(
 		    vkb::core::BufferBuilderCpp(1)
 		        .with_usage(vk::BufferUsageFlagBits::eIndexBuffer)
 		        .with_vma_usage(VMA_MEMORY_USAGE_GPU_TO_CPU)
 		        .with_debug_name("GUI index buffer")
-		        .build_unique(device);
+		        .build_unique(device));
 	}
 }
 
@@ -355,10 +356,18 @@ void HPPGui::update(const float delta_time)
 	ImGui::Render();
 }
 
-bool HPPGui::update_buffers()
+void HPPGui::set_buffer_count(size_t count)
 {
+	// New sets are allocated by the next update
+	vertex_buffers.resize(std::max<size_t>(count, 1));
+	index_buffers.resize(std::max<size_t>(count, 1));
+}
+
+bool HPPGui::update_buffers(size_t buffer_index, const std::function<void()> &wait_for_buffers)
+{
+	assert(buffer_index < vertex_buffers.size() && "The buffer index exceeds the buffer count");
+
 	ImDrawData *draw_data = ImGui::GetDrawData();
-	bool        updated   = false;
 
 	if (!draw_data)
 	{
@@ -373,38 +382,50 @@ bool HPPGui::update_buffers()
 		return false;
 	}
 
-	if ((!vertex_buffer->get_handle()) || (vertex_buffer_size != last_vertex_buffer_size))
+	bool reallocate = (vertex_buffer_size != last_vertex_buffer_size) || (index_buffer_size != last_index_buffer_size) ||
+	                  std::any_of(vertex_buffers.begin(), vertex_buffers.end(), [](auto &buffer) { return !buffer; });
+
+	if (reallocate)
 	{
+		if (wait_for_buffers)
+		{
+			wait_for_buffers();
+		}
+
 		last_vertex_buffer_size = vertex_buffer_size;
-		updated                 = true;
+		last_index_buffer_size  = index_buffer_size;
 
-		vertex_buffer = std::make_unique<vkb::core::BufferCpp>(sample.get_render_context().get_device(), vertex_buffer_size,
-		                                                       vk::BufferUsageFlagBits::eVertexBuffer,
-		                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
-		vertex_buffer->set_debug_name("GUI vertex buffer");
+		for (size_t i = 0; i < vertex_buffers.size(); ++i)
+		{
+			vertex_buffers[i] = std::make_unique<vkb::core::BufferCpp>(sample.get_render_context().get_device(), vertex_buffer_size,
+			                                                           vk::BufferUsageFlagBits::eVertexBuffer,
+			                                                           VMA_MEMORY_USAGE_GPU_TO_CPU);
+			vertex_buffers[i]->set_debug_name("GUI vertex buffer");
+
+			index_buffers[i] = std::make_unique<vkb::core::BufferCpp>(sample.get_render_context().get_device(), index_buffer_size,
+			                                                          vk::BufferUsageFlagBits::eIndexBuffer,
+			                                                          VMA_MEMORY_USAGE_GPU_TO_CPU);
+			index_buffers[i]->set_debug_name("GUI index buffer");
+		}
 	}
 
-	if ((!index_buffer->get_handle()) || (index_buffer_size != last_index_buffer_size))
-	{
-		last_index_buffer_size = index_buffer_size;
-		updated                = true;
-
-		index_buffer = std::make_unique<vkb::core::BufferCpp>(sample.get_render_context().get_device(), index_buffer_size,
-		                                                      vk::BufferUsageFlagBits::eIndexBuffer,
-		                                                      VMA_MEMORY_USAGE_GPU_TO_CPU);
-		index_buffer->set_debug_name("GUI index buffer");
-	}
+	// Command buffers recorded after a reallocation draw the current data from every set
+	size_t first_index = reallocate ? 0 : buffer_index;
+	size_t last_index  = reallocate ? vertex_buffers.size() - 1 : buffer_index;
 
-	// Upload data
-	upload_draw_data(draw_data, vertex_buffer->map(), index_buffer->map());
+	for (size_t i = first_index; i <= last_index; ++i)
+	{
+		// Upload data
+		upload_draw_data(draw_data, vertex_buffers[i]->map(), index_buffers[i]->map());
 
-	vertex_buffer->flush();
-	index_buffer->flush();
+		vertex_buffers[i]->flush();
+		index_buffers[i]->flush();
 
-	vertex_buffer->unmap();
-	index_buffer->unmap();
+		vertex_buffers[i]->unmap();
+		index_buffers[i]->unmap();
+	}
 
-	return updated;
+	return reallocate;
 }
 
 void HPPGui::update_buffers(vkb::core::HPPCommandBuffer &command_buffer) const
@@ -545,10 +566,10 @@ void HPPGui::draw(vkb::core::HPPCommandBuffer &command_buffer)
 	else
 	{
 		std::vector<std::reference_wrapper<const vkb::core::BufferCpp>> buffers;
-		buffers.push_back(*vertex_buffer);
+		buffers.push_back(*vertex_buffers[0]);
 		command_buffer.bind_vertex_buffers(0, buffers, {0});
 
-		command_buffer.bind_index_buffer(*index_buffer, 0, vk::IndexType::eUint16);
+		command_buffer.bind_index_buffer(*index_buffers[0], 0, vk::IndexType::eUint16);
 	}
 
 	// Render commands
@@ -608,16 +629,19 @@ void HPPGui::draw(vkb::core::HPPCommandBuffer &command_buffer)
 	}
 }
 
-void HPPGui::draw(vk::CommandBuffer command_buffer) const
+void HPPGui::draw(vk::CommandBuffer command_buffer, size_t buffer_index) const
 {
 	if (!visible)
 	{
 		return;
 	}
 
+	assert(buffer_index < vertex_buffers.size() && "The buffer index exceeds the buffer count");
+
 	ImDrawData *draw_data = ImGui::GetDrawData();
 
-	if ((!draw_data) || (draw_data->CmdListsCount == 0))
+	// A set added by set_buffer_count holds no data until the next update
+	if ((!draw_data) || (draw_data->CmdListsCount == 0) || !vertex_buffers[buffer_index])
 	{
 		return;
 	}
@@ -631,9 +655,9 @@ void HPPGui::draw(vk::CommandBuffer command_buffer) const
 	command_buffer.pushConstants<glm::mat4>(pipeline_layout->get_handle(), vk::ShaderStageFlagBits::eVertex, 0, push_transform);
 
 	vk::DeviceSize offset = 0;
-	command_buffer.bindVertexBuffers(0, vertex_buffer->get_handle(), offset);
+	command_buffer.bindVertexBuffers(0, vertex_buffers[buffer_index]->get_handle(), offset);
 
-	command_buffer.bindIndexBuffer(index_buffer->get_handle(), 0, vk::IndexType::eUint16);
+	command_buffer.bindIndexBuffer(index_buffers[buffer_index]->get_handle(), 0, vk::IndexType::eUint16);
 
 	int32_t vertex_offset = 0;
 	int32_t index_offset  = 0;
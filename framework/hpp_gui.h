@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <functional>
 #include <imgui.h>
 
 #include "core/hpp_command_buffer.h"
@@ -150,7 +151,20 @@ class HPPGui
 	 */
 	void update(float delta_time);
 
-	bool update_buffers();
+	/**
+	 * @brief Sets the number of vertex and index buffer sets, one for each command buffer drawing the HPPGui,
+	 *        so that writing the draw data of a frame does not overwrite the data read by the frames in flight
+	 */
+	void set_buffer_count(size_t count);
+
+	/**
+	 * @brief Uploads the draw data to a set of vertex and index buffers
+	 *        If the size of the draw data changed, all the sets are reallocated and written, otherwise only the given set is written.
+	 * @param buffer_index Index of the set to write
+	 * @param wait_for_buffers Called before the buffers are reallocated, so that the GPU can be done with all the sets
+	 * @return True if the buffers were reallocated, the command buffers drawing the HPPGui must then be recorded again
+	 */
+	bool update_buffers(size_t buffer_index = 0, const std::function<void()> &wait_for_buffers = {});
 
 	/**
 	 * @brief Draws the HPPGui
@@ -161,8 +175,9 @@ class HPPGui
 	/**
 	 * @brief Draws the HPPGui
 	 * @param command_buffer Command buffer to register draw-commands
+	 * @param buffer_index Index of the set of vertex and index buffers to draw from
 	 */
-	void draw(vk::CommandBuffer command_buffer) const;
+	void draw(vk::CommandBuffer command_buffer, size_t buffer_index = 0) const;
 
 	/**
 	 * @brief Shows an overlay top window with app info and maybe stats
@@ -260,8 +275,8 @@ class HPPGui
   private:
 	PushConstBlock                           push_const_block;
 	VulkanSampleCpp                         &sample;
-	std::unique_ptr<vkb::core::BufferCpp>    vertex_buffer;
-	std::unique_ptr<vkb::core::BufferCpp>    index_buffer;
+	std::vector<std::unique_ptr<vkb::core::BufferCpp>> vertex_buffers;        // Vertex buffer of each set, see set_buffer_count
+	std::vector<std::unique_ptr<vkb::core::BufferCpp>> index_buffers;         // Index buffer of each set
 	size_t                                   last_vertex_buffer_size = 0;
 	size_t                                   last_index_buffer_size  = 0;
 	float                                    content_scale_factor    = 1.0f;        // Scale factor to apply due to a difference between the window and GL pixel sizes
@@ -41,12 +41,20 @@ struct HPPResourceInfo
 class HPPResourceSet : private vkb::ResourceSet
 {
   public:
+	using vkb::ResourceSet::get_hash;
 	using vkb::ResourceSet::is_dirty;
+	using vkb::ResourceSet::is_offset_only_dirty;
+	using vkb::ResourceSet::MAX_BINDINGS;
 
   public:
-	const BindingMap<HPPResourceInfo> &get_resource_bindings() const
+	const BindingTable<std::vector<HPPResourceInfo>, MAX_BINDINGS> &get_resource_bindings() const
 	{
-		return reinterpret_cast<BindingMap<HPPResourceInfo> const &>(vkb::ResourceSet::get_resource_bindings());
+		return reinterpret_cast<BindingTable<std::vector<HPPResourceInfo>, MAX_BINDINGS> const &>(vkb::ResourceSet::get_resource_bindings());
+	}
+
+	vk::DescriptorSet get_descriptor_set() const
+	{
+		return static_cast<vk::DescriptorSet>(vkb::ResourceSet::get_descriptor_set());
 	}
 };
 
@@ -55,6 +63,7 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
   public:
 	using vkb::ResourceBindingState::clear_dirty;
 	using vkb::ResourceBindingState::is_dirty;
+	using vkb::ResourceBindingState::MAX_SETS;
 	using vkb::ResourceBindingState::reset;
 
   public:
@@ -84,9 +93,14 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
 		vkb::ResourceBindingState::bind_input(reinterpret_cast<vkb::core::ImageView const &>(image_view), set, binding, array_element);
 	}
 
-	const std::unordered_map<uint32_t, vkb::HPPResourceSet> &get_resource_sets()
+	void set_descriptor_set(uint32_t set, vk::DescriptorSet descriptor_set)
+	{
+		vkb::ResourceBindingState::set_descriptor_set(set, static_cast<VkDescriptorSet>(descriptor_set));
+	}
+
+	const BindingTable<vkb::HPPResourceSet, MAX_SETS> &get_resource_sets()
 	{
-		return reinterpret_cast<std::unordered_map<uint32_t, vkb::HPPResourceSet> const &>(vkb::ResourceBindingState::get_resource_sets());
+		return reinterpret_cast<BindingTable<vkb::HPPResourceSet, MAX_SETS> const &>(vkb::ResourceBindingState::get_resource_sets());
 	}
 };
 }        // namespace vkb
@@ -23,6 +23,7 @@
 #include <core/hpp_render_pass.h>
 #include <hpp_resource_record.h>
 #include <hpp_resource_replay.h>
+#include <resource_cache.h>
 #include <vulkan/vulkan.hpp>
 
 namespace vkb
@@ -31,6 +32,7 @@ namespace core
 {
 class HPPDescriptorPool;
 class HPPDescriptorSetLayout;
+class HPPDevice;
 class HPPImageView;
 }        // namespace core
 
@@ -57,62 +59,126 @@ struct HPPResourceCacheState
 };
 
 /**
- * @brief vulkan.hpp version of the vkb::ResourceCache class
+ * @brief facade class around vkb::ResourceCache, providing a vulkan.hpp-based interface
  *
  * See vkb::ResourceCache for documentation
  */
-class HPPResourceCache
+class HPPResourceCache : private vkb::ResourceCache
 {
   public:
-	HPPResourceCache(vkb::core::HPPDevice &device);
-
-	HPPResourceCache(const HPPResourceCache &)            = delete;
-	HPPResourceCache(HPPResourceCache &&)                 = delete;
-	HPPResourceCache &operator=(const HPPResourceCache &) = delete;
-	HPPResourceCache &operator=(HPPResourceCache &&)      = delete;
-
-	void                               clear();
-	void                               clear_framebuffers();
-	void                               clear_pipelines();
-	const HPPResourceCacheState       &get_internal_state() const;
-	vkb::core::HPPComputePipeline     &request_compute_pipeline(vkb::rendering::HPPPipelineState &pipeline_state);
-	vkb::core::HPPDescriptorSet       &request_descriptor_set(vkb::core::HPPDescriptorSetLayout          &descriptor_set_layout,
-	                                                          const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
-	                                                          const BindingMap<vk::DescriptorImageInfo>  &image_infos);
+	using vkb::ResourceCache::begin_frame;
+	using vkb::ResourceCache::clear;
+	using vkb::ResourceCache::clear_framebuffers;
+	using vkb::ResourceCache::clear_pipelines;
+	using vkb::ResourceCache::get_pending_pipeline_count;
+	using vkb::ResourceCache::is_async_graphics_pipelines;
+	using vkb::ResourceCache::is_concurrent_mode;
+	using vkb::ResourceCache::serialize;
+	using vkb::ResourceCache::set_concurrent_mode;
+	using vkb::ResourceCache::set_descriptor_set_capacity;
+	using vkb::ResourceCache::set_framebuffer_capacity;
+	using vkb::ResourceCache::wait_for_pipeline_compiles;
+	using vkb::ResourceCache::wait_for_warmup;
+	using vkb::ResourceCache::warmup;
+	using vkb::ResourceCache::warmup_async;
+
+	HPPResourceCache(vkb::core::HPPDevice &device) :
+	    vkb::ResourceCache(reinterpret_cast<vkb::Device &>(device))
+	{}
+
+	const HPPResourceCacheState &get_internal_state() const
+	{
+		return reinterpret_cast<HPPResourceCacheState const &>(vkb::ResourceCache::get_internal_state());
+	}
+
+	vkb::core::HPPComputePipeline &request_compute_pipeline(vkb::rendering::HPPPipelineState &pipeline_state)
+	{
+		return reinterpret_cast<vkb::core::HPPComputePipeline &>(
+		    vkb::ResourceCache::request_compute_pipeline(reinterpret_cast<vkb::PipelineState &>(pipeline_state)));
+	}
+
+	vkb::core::HPPDescriptorSet &request_descriptor_set(vkb::core::HPPDescriptorSetLayout          &descriptor_set_layout,
+	                                                    const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
+	                                                    const BindingMap<vk::DescriptorImageInfo>  &image_infos)
+	{
+		return reinterpret_cast<vkb::core::HPPDescriptorSet &>(
+		    vkb::ResourceCache::request_descriptor_set(reinterpret_cast<vkb::DescriptorSetLayout &>(descriptor_set_layout),
+		                                               reinterpret_cast<BindingMap<VkDescriptorBufferInfo> const &>(buffer_infos),
+		                                               reinterpret_cast<BindingMap<VkDescriptorImageInfo> const &>(image_infos)));
+	}
+
 	vkb::core::HPPDescriptorSetLayout &request_descriptor_set_layout(const uint32_t                                   set_index,
 	                                                                 const std::vector<vkb::core::HPPShaderModule *> &shader_modules,
-	                                                                 const std::vector<vkb::core::HPPShaderResource> &set_resources);
-	vkb::core::HPPFramebuffer         &request_framebuffer(const vkb::rendering::HPPRenderTarget &render_target, const vkb::core::HPPRenderPass &render_pass);
-	vkb::core::HPPGraphicsPipeline    &request_graphics_pipeline(vkb::rendering::HPPPipelineState &pipeline_state);
-	vkb::core::HPPPipelineLayout      &request_pipeline_layout(const std::vector<vkb::core::HPPShaderModule *> &shader_modules);
-	vkb::core::HPPRenderPass          &request_render_pass(const std::vector<vkb::rendering::HPPAttachment> &attachments,
-	                                                       const std::vector<vkb::common::HPPLoadStoreInfo> &load_store_infos,
-	                                                       const std::vector<vkb::core::HPPSubpassInfo>     &subpasses);
-	vkb::core::HPPShaderModule        &request_shader_module(
-	           vk::ShaderStageFlagBits stage, const vkb::core::HPPShaderSource &glsl_source, const vkb::core::HPPShaderVariant &shader_variant = {});
-	std::vector<uint8_t> serialize();
-	void                 set_pipeline_cache(vk::PipelineCache pipeline_cache);
+	                                                                 const std::vector<vkb::core::HPPShaderResource> &set_resources)
+	{
+		return reinterpret_cast<vkb::core::HPPDescriptorSetLayout &>(
+		    vkb::ResourceCache::request_descriptor_set_layout(set_index,
+		                                                      reinterpret_cast<std::vector<vkb::ShaderModule *> const &>(shader_modules),
+		                                                      reinterpret_cast<std::vector<vkb::ShaderResource> const &>(set_resources)));
+	}
+
+	vkb::core::HPPFramebuffer &request_framebuffer(const vkb::rendering::HPPRenderTarget &render_target, const vkb::core::HPPRenderPass &render_pass)
+	{
+		return reinterpret_cast<vkb::core::HPPFramebuffer &>(
+		    vkb::ResourceCache::request_framebuffer(reinterpret_cast<vkb::RenderTarget const &>(render_target),
+		                                            reinterpret_cast<vkb::RenderPass const &>(render_pass)));
+	}
+
+	vkb::core::HPPGraphicsPipeline &request_graphics_pipeline(vkb::rendering::HPPPipelineState &pipeline_state)
+	{
+		return reinterpret_cast<vkb::core::HPPGraphicsPipeline &>(
+		    vkb::ResourceCache::request_graphics_pipeline(reinterpret_cast<vkb::PipelineState &>(pipeline_state)));
+	}
+
+	vkb::core::HPPGraphicsPipeline *request_graphics_pipeline_async(vkb::rendering::HPPPipelineState &pipeline_state)
+	{
+		return reinterpret_cast<vkb::core::HPPGraphicsPipeline *>(
+		    vkb::ResourceCache::request_graphics_pipeline_async(reinterpret_cast<vkb::PipelineState &>(pipeline_state)));
+	}
+
+	vkb::core::HPPGraphicsPipeline *request_fallback_graphics_pipeline(const vkb::rendering::HPPPipelineState &pipeline_state)
+	{
+		return reinterpret_cast<vkb::core::HPPGraphicsPipeline *>(
+		    vkb::ResourceCache::request_fallback_graphics_pipeline(reinterpret_cast<vkb::PipelineState const &>(pipeline_state)));
+	}
+
+	vkb::core::HPPPipelineLayout &request_pipeline_layout(const std::vector<vkb::core::HPPShaderModule *> &shader_modules)
+	{
+		return reinterpret_cast<vkb::core::HPPPipelineLayout &>(
+		    vkb::ResourceCache::request_pipeline_layout(reinterpret_cast<std::vector<vkb::ShaderModule *> const &>(shader_modules)));
+	}
+
+	vkb::core::HPPRenderPass &request_render_pass(const std::vector<vkb::rendering::HPPAttachment> &attachments,
+	                                              const std::vector<vkb::common::HPPLoadStoreInfo> &load_store_infos,
+	                                              const std::vector<vkb::core::HPPSubpassInfo>     &subpasses)
+	{
+		return reinterpret_cast<vkb::core::HPPRenderPass &>(
+		    vkb::ResourceCache::request_render_pass(reinterpret_cast<std::vector<vkb::Attachment> const &>(attachments),
+		                                            reinterpret_cast<std::vector<vkb::LoadStoreInfo> const &>(load_store_infos),
+		                                            reinterpret_cast<std::vector<vkb::SubpassInfo> const &>(subpasses)));
+	}
+
+	vkb::core::HPPShaderModule &request_shader_module(
+	    vk::ShaderStageFlagBits stage, const vkb::core::HPPShaderSource &glsl_source, const vkb::core::HPPShaderVariant &shader_variant = {})
+	{
+		return reinterpret_cast<vkb::core::HPPShaderModule &>(
+		    vkb::ResourceCache::request_shader_module(static_cast<VkShaderStageFlagBits>(stage),
+		                                              reinterpret_cast<vkb::ShaderSource const &>(glsl_source),
+		                                              reinterpret_cast<vkb::ShaderVariant const &>(shader_variant)));
+	}
+
+	void set_pipeline_cache(vk::PipelineCache pipeline_cache)
+	{
+		vkb::ResourceCache::set_pipeline_cache(static_cast<VkPipelineCache>(pipeline_cache));
+	}
 
 	/// @brief Update those descriptor sets referring to old views
 	/// @param old_views Old image views referred by descriptor sets
 	/// @param new_views New image views to be referred
-	void update_descriptor_sets(const std::vector<vkb::core::HPPImageView> &old_views, const std::vector<vkb::core::HPPImageView> &new_views);
-
-	void warmup(const std::vector<uint8_t> &data);
-
-  private:
-	vkb::core::HPPDevice  &device;
-	vkb::HPPResourceRecord recorder                    = {};
-	vkb::HPPResourceReplay replayer                    = {};
-	vk::PipelineCache      pipeline_cache              = nullptr;
-	HPPResourceCacheState  state                       = {};
-	std::mutex             descriptor_set_mutex        = {};
-	std::mutex             pipeline_layout_mutex       = {};
-	std::mutex             shader_module_mutex         = {};
-	std::mutex             descriptor_set_layout_mutex = {};
-	std::mutex             graphics_pipeline_mutex     = {};
-	std::mutex             render_pass_mutex           = {};
-	std::mutex             compute_pipeline_mutex      = {};
-	std::mutex             framebuffer_mutex           = {};
+	void update_descriptor_sets(const std::vector<vkb::core::HPPImageView> &old_views, const std::vector<vkb::core::HPPImageView> &new_views)
+	{
+		vkb::ResourceCache::update_descriptor_sets(reinterpret_cast<std::vector<vkb::core::ImageView> const &>(old_views),
+		                                           reinterpret_cast<std::vector<vkb::core::ImageView> const &>(new_views));
+	}
 };
 }        // namespace vkb
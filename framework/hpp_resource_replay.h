@@ -32,9 +32,9 @@ class HPPResourceRecord;
 class HPPResourceReplay : private vkb::ResourceReplay
 {
   public:
-	void play(vkb::HPPResourceCache &resource_cache, vkb::HPPResourceRecord &recorder)
+	void play(vkb::HPPResourceCache &resource_cache, const std::vector<uint8_t> &data, bool parallel = false)
 	{
-		vkb::ResourceReplay::play(reinterpret_cast<vkb::ResourceCache &>(resource_cache), reinterpret_cast<vkb::ResourceRecord &>(recorder));
+		vkb::ResourceReplay::play(reinterpret_cast<vkb::ResourceCache &>(resource_cache), data, parallel);
 	}
 };
 }        // namespace vkb
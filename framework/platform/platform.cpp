@@ -28,11 +28,13 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include "core/descriptor_pool.h"
 #include "core/util/logging.hpp"
 #include "force_close/force_close.h"
 #include "glsl_compiler.h"
 #include "platform/parsers/CLI11.h"
 #include "platform/plugins/plugin.h"
+#include "shader_cache.h"
 #include "vulkan_sample.h"
 
 namespace vkb
@@ -108,6 +110,13 @@ ExitCode Platform::initialize(const std::vector<Plugin *> &plugins)
 		return ExitCode::NoSample;
 	}
 
+	DescriptorPool::load_usage_hints();
+
+	job_system = std::make_unique<JobSystem>();
+	JobSystem::set_instance(job_system.get());
+
+	LOGI("Job system started with {} workers", job_system->get_worker_count());
+
 	create_window(window_properties);
 
 	if (!window)
@@ -259,6 +268,24 @@ void Platform::terminate(ExitCode code)
 	active_app.reset();
 	window.reset();
 
+	if (job_system)
+	{
+		std::string busy_times;
+		for (size_t i = 0; i < job_system->get_worker_count(); i++)
+		{
+			busy_times += fmt::format("{}{:.3f}", i == 0 ? "" : ", ", std::chrono::duration<float>(job_system->get_busy_time(i)).count());
+		}
+		LOGI("Job system busy time per worker (seconds): {}", busy_times);
+
+		JobSystem::set_instance(nullptr);
+		job_system.reset();
+	}
+
+	LOGI("Shader cache: {} hits, {} misses", ShaderCache::get_hit_count(), ShaderCache::get_miss_count());
+
+	// Descriptor pools record their usage when destroyed, along with the application
+	DescriptorPool::save_usage_hints();
+
 	spdlog::drop_all();
 
 	on_platform_close();
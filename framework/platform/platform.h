@@ -28,6 +28,7 @@
 #include "common/optional.h"
 #include "common/utils.h"
 #include "common/vk_common.h"
+#include "core/util/job_system.hpp"
 #include "platform/application.h"
 #include "platform/parser.h"
 #include "platform/plugins/plugin.h"
@@ -142,6 +143,9 @@ class Platform
 
 	std::unordered_map<Hook, std::vector<Plugin *>> hooks;
 
+	/// Declared before the application so that it outlives the jobs the application schedules
+	std::unique_ptr<JobSystem> job_system{nullptr};
+
 	std::unique_ptr<Window> window{nullptr};
 
 	std::unique_ptr<Application> active_app{nullptr};
@@ -0,0 +1,185 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gpu_profiler.h"
+
+#include <algorithm>
+
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+GpuProfiler::GpuProfiler(Device &device) :
+    device{device}
+{
+	timestamp_period = device.get_gpu().get_properties().limits.timestampPeriod;
+
+	uint32_t valid_bits = device.get_suitable_graphics_queue().get_properties().timestampValidBits;
+
+	supported      = valid_bits > 0 && timestamp_period > 0.0f;
+	timestamp_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+
+	if (!supported)
+	{
+		LOGW("GPU profiler disabled, the graphics queue does not support timestamps");
+	}
+}
+
+bool GpuProfiler::is_supported() const
+{
+	return supported;
+}
+
+void GpuProfiler::set_enabled(bool enabled_)
+{
+	enabled = enabled_;
+}
+
+bool GpuProfiler::is_enabled() const
+{
+	return supported && enabled;
+}
+
+void GpuProfiler::begin_frame(uint32_t frame_index)
+{
+	if (!is_enabled())
+	{
+		active_frame = nullptr;
+		return;
+	}
+
+	if (frame_index >= frames.size())
+	{
+		frames.resize(frame_index + 1);
+	}
+
+	auto &frame = frames[frame_index];
+
+	if (!frame.query_pool)
+	{
+		VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_info.queryCount = MAX_SCOPES_PER_FRAME * 2;
+
+		frame.query_pool = std::make_unique<QueryPool>(device, query_pool_info);
+	}
+	else if (!frame.scope_names.empty())
+	{
+		resolve(frame);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	frame.scope_names.clear();
+	active_frame = &frame;
+}
+
+uint32_t GpuProfiler::reserve_scopes(CommandBuffer &command_buffer, const std::vector<std::string> &names)
+{
+	if (!is_enabled() || names.empty())
+	{
+		return INVALID_SCOPE;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!active_frame)
+	{
+		return INVALID_SCOPE;
+	}
+
+	auto first_scope = to_u32(active_frame->scope_names.size());
+
+	// Passes beyond the capacity of the pool are not timed
+	if (first_scope + names.size() > MAX_SCOPES_PER_FRAME)
+	{
+		return INVALID_SCOPE;
+	}
+
+	active_frame->scope_names.insert(active_frame->scope_names.end(), names.begin(), names.end());
+
+	command_buffer.reset_query_pool(*active_frame->query_pool, first_scope * 2, to_u32(names.size()) * 2);
+
+	return first_scope;
+}
+
+void GpuProfiler::begin_scope(CommandBuffer &command_buffer, uint32_t scope)
+{
+	if (scope != INVALID_SCOPE)
+	{
+		command_buffer.write_timestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, *active_frame->query_pool, scope * 2);
+	}
+}
+
+void GpuProfiler::end_scope(CommandBuffer &command_buffer, uint32_t scope)
+{
+	if (scope != INVALID_SCOPE)
+	{
+		command_buffer.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *active_frame->query_pool, scope * 2 + 1);
+	}
+}
+
+std::vector<GpuProfiler::PassTime> GpuProfiler::get_pass_times() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return pass_times;
+}
+
+void GpuProfiler::resolve(FrameQueries &frame)
+{
+	auto query_count = to_u32(frame.scope_names.size()) * 2;
+
+	std::vector<uint64_t> timestamps(query_count);
+
+	// The frame completed, so the results are available unless a command buffer was never submitted
+	auto result = frame.query_pool->get_results(0, query_count,
+	                                            timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t),
+	                                            VK_QUERY_RESULT_64_BIT);
+
+	if (result != VK_SUCCESS)
+	{
+		return;
+	}
+
+	std::vector<PassTime> frame_pass_times;
+
+	for (size_t i = 0; i < frame.scope_names.size(); i++)
+	{
+		uint64_t ticks    = (timestamps[i * 2 + 1] - timestamps[i * 2]) & timestamp_mask;
+		auto     gpu_time = std::chrono::nanoseconds{static_cast<int64_t>(static_cast<double>(ticks) * timestamp_period)};
+
+		auto it = std::find_if(frame_pass_times.begin(), frame_pass_times.end(),
+		                       [&name = frame.scope_names[i]](const PassTime &pass_time) { return pass_time.name == name; });
+
+		if (it != frame_pass_times.end())
+		{
+			it->gpu_time += gpu_time;
+		}
+		else
+		{
+			frame_pass_times.push_back({frame.scope_names[i], gpu_time});
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	pass_times = std::move(frame_pass_times);
+}
+}        // namespace vkb
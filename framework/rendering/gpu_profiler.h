@@ -0,0 +1,148 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "core/query_pool.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+
+/**
+ * @brief Measures the GPU time of named passes with timestamp queries
+ *
+ * Each frame in flight has its own query pool. The timestamps written during a frame are read back
+ * once the RenderContext begins the next frame using the same pool, after waiting for it to complete,
+ * so reading them never stalls. The results are therefore a few frames old.
+ *
+ * RenderPipeline times each of its subpasses and PostProcessingPipeline each of its passes,
+ * using their debug names. The RenderContext owns the profiler, see RenderContext::get_gpu_profiler.
+ */
+class GpuProfiler
+{
+  public:
+	struct PassTime
+	{
+		std::string name;
+
+		/// Sum of the GPU time of all the passes with this name in the frame
+		std::chrono::nanoseconds gpu_time;
+	};
+
+	/// Returned by reserve_scopes when the passes are not timed
+	static constexpr uint32_t INVALID_SCOPE = ~0u;
+
+	/// Maximum number of timed passes in a frame
+	static constexpr uint32_t MAX_SCOPES_PER_FRAME = 128;
+
+	GpuProfiler(Device &device);
+
+	GpuProfiler(const GpuProfiler &) = delete;
+
+	GpuProfiler(GpuProfiler &&) = delete;
+
+	GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+	GpuProfiler &operator=(GpuProfiler &&) = delete;
+
+	/**
+	 * @return True if the graphics queue supports timestamps
+	 */
+	bool is_supported() const;
+
+	/**
+	 * @brief Enables or disables the profiler, it is enabled by default if supported
+	 */
+	void set_enabled(bool enabled);
+
+	bool is_enabled() const;
+
+	/**
+	 * @brief Reads back the timestamps of the previous use of a frame, which must be complete
+	 *        Called by the RenderContext once it waited for the frame
+	 * @param frame_index The index of the frame which becomes active
+	 */
+	void begin_frame(uint32_t frame_index);
+
+	/**
+	 * @brief Reserves the timestamps of consecutive passes in the active frame, and resets them
+	 *        Must be recorded outside of a render pass, before the timestamps are written
+	 * @param command_buffer The command buffer to record the reset into
+	 * @param names The name of each pass
+	 * @return The scope of the first pass, the others follow, or INVALID_SCOPE if the passes are not timed
+	 */
+	uint32_t reserve_scopes(CommandBuffer &command_buffer, const std::vector<std::string> &names);
+
+	/**
+	 * @brief Writes the timestamp starting a pass, does nothing for INVALID_SCOPE
+	 */
+	void begin_scope(CommandBuffer &command_buffer, uint32_t scope);
+
+	/**
+	 * @brief Writes the timestamp ending a pass, does nothing for INVALID_SCOPE
+	 */
+	void end_scope(CommandBuffer &command_buffer, uint32_t scope);
+
+	/**
+	 * @return The GPU time of each pass of the last frame read back, in the order they were first recorded
+	 */
+	std::vector<PassTime> get_pass_times() const;
+
+  private:
+	struct FrameQueries
+	{
+		std::unique_ptr<QueryPool> query_pool;
+
+		/// Name of each scope reserved in the frame, scope i uses queries 2 * i and 2 * i + 1
+		std::vector<std::string> scope_names;
+	};
+
+	void resolve(FrameQueries &frame);
+
+	Device &device;
+
+	bool supported{false};
+
+	bool enabled{true};
+
+	/// Nanoseconds per timestamp tick
+	float timestamp_period{1.0f};
+
+	/// Bits of the timestamps which are valid
+	uint64_t timestamp_mask{0};
+
+	std::vector<FrameQueries> frames;
+
+	/// Frame in which scopes are reserved, null before the first begin_frame
+	FrameQueries *active_frame{nullptr};
+
+	std::vector<PassTime> pass_times;
+
+	/// Guards the reservations, which can be made from any recording thread, and the pass times
+	mutable std::mutex mutex;
+};
+}        // namespace vkb
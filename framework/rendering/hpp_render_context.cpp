@@ -32,7 +32,7 @@ HPPRenderContext::HPPRenderContext(vkb::core::HPPDevice                    &devi
                                    vk::PresentModeKHR                       present_mode,
                                    std::vector<vk::PresentModeKHR> const   &present_mode_priority_list,
                                    std::vector<vk::SurfaceFormatKHR> const &surface_format_priority_list) :
-    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height}
+    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height}, gpu_profiler{std::make_unique<vkb::GpuProfiler>(reinterpret_cast<vkb::Device &>(device))}
 {
 	if (surface)
 	{
@@ -50,11 +50,41 @@ HPPRenderContext::HPPRenderContext(vkb::core::HPPDevice                    &devi
 	}
 }
 
+HPPRenderContext::~HPPRenderContext()
+{
+	for (auto semaphore : image_render_semaphores)
+	{
+		device.get_handle().destroySemaphore(semaphore);
+	}
+}
+
+void HPPRenderContext::set_frames_in_flight(uint32_t count)
+{
+	assert(!prepared && "The number of frames in flight must be set before preparing the HPPRenderContext");
+	frames_in_flight = count;
+}
+
 void HPPRenderContext::prepare(size_t thread_count, vkb::rendering::HPPRenderTarget::CreateFunc create_render_target_func)
 {
 	device.get_handle().waitIdle();
 
-	if (swapchain)
+	if (frames_in_flight > 0)
+	{
+		if (swapchain)
+		{
+			surface_extent = swapchain->get_extent();
+		}
+
+		this->create_render_target_func = create_render_target_func;
+
+		for (uint32_t i = 0; i < frames_in_flight; i++)
+		{
+			frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, nullptr, thread_count));
+		}
+
+		create_image_render_targets();
+	}
+	else if (swapchain)
 	{
 		surface_extent = swapchain->get_extent();
 
@@ -165,10 +195,56 @@ void HPPRenderContext::update_swapchain(const vk::Extent2D &extent, const vk::Su
 	recreate();
 }
 
+void HPPRenderContext::create_image_render_targets()
+{
+	image_render_targets.clear();
+
+	if (swapchain)
+	{
+		vk::Extent2D swapchain_extent = swapchain->get_extent();
+		vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
+
+		for (auto &image_handle : swapchain->get_images())
+		{
+			vkb::core::HPPImage swapchain_image{device, image_handle, extent, swapchain->get_format(), swapchain->get_usage()};
+			image_render_targets.push_back(create_render_target_func(std::move(swapchain_image)));
+		}
+
+		while (image_render_semaphores.size() < image_render_targets.size())
+		{
+			image_render_semaphores.push_back(device.get_handle().createSemaphore({}));
+		}
+	}
+	else
+	{
+		auto color_image = vkb::core::HPPImage{device,
+		                                       vk::Extent3D{surface_extent.width, surface_extent.height, 1},
+		                                       DEFAULT_VK_FORMAT,
+		                                       vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+		                                       VMA_MEMORY_USAGE_GPU_ONLY};
+
+		image_render_targets.push_back(create_render_target_func(std::move(color_image)));
+	}
+
+	// Frames render to the first image until they are used again
+	active_image_index = 0;
+	for (auto &frame : frames)
+	{
+		frame->set_render_target(*image_render_targets[0]);
+	}
+}
+
 void HPPRenderContext::recreate()
 {
 	LOGI("Recreated swapchain");
 
+	if (frames_in_flight > 0)
+	{
+		create_image_render_targets();
+		device.get_resource_cache().clear_framebuffers();
+		return;
+	}
+
 	vk::Extent2D swapchain_extent = swapchain->get_extent();
 	vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
 
@@ -263,7 +339,15 @@ void HPPRenderContext::submit(const std::vector<vkb::core::HPPCommandBuffer *> &
 	if (swapchain)
 	{
 		assert(acquired_semaphore && "We do not have acquired_semaphore, it was probably consumed?\n");
-		render_semaphore = submit(queue, command_buffers, acquired_semaphore, vk::PipelineStageFlagBits::eColorAttachmentOutput);
+		if (frames_in_flight > 0)
+		{
+			render_semaphore =
+			    submit(queue, command_buffers, acquired_semaphore, vk::PipelineStageFlagBits::eColorAttachmentOutput, image_render_semaphores[active_image_index]);
+		}
+		else
+		{
+			render_semaphore = submit(queue, command_buffers, acquired_semaphore, vk::PipelineStageFlagBits::eColorAttachmentOutput);
+		}
 	}
 	else
 	{
@@ -291,10 +375,13 @@ void HPPRenderContext::begin_frame()
 
 	if (swapchain)
 	{
+		// Frames bound to swapchain images are selected by the acquired image
+		uint32_t &image_index = frames_in_flight > 0 ? active_image_index : active_frame_index;
+
 		vk::Result result;
 		try
 		{
-			std::tie(result, active_frame_index) = swapchain->acquire_next_image(acquired_semaphore);
+			std::tie(result, image_index) = swapchain->acquire_next_image(acquired_semaphore);
 		}
 		catch (vk::OutOfDateKHRError & /*err*/)
 		{
@@ -315,8 +402,8 @@ void HPPRenderContext::begin_frame()
 			{
 				// Need to destroy and reallocate acquired_semaphore since it may have already been signaled
 				device.get_handle().destroySemaphore(acquired_semaphore);
-				acquired_semaphore                   = prev_frame.request_semaphore_with_ownership();
-				std::tie(result, active_frame_index) = swapchain->acquire_next_image(acquired_semaphore);
+				acquired_semaphore            = prev_frame.request_semaphore_with_ownership();
+				std::tie(result, image_index) = swapchain->acquire_next_image(acquired_semaphore);
 			}
 		}
 
@@ -327,25 +414,49 @@ void HPPRenderContext::begin_frame()
 		}
 	}
 
+	if (frames_in_flight > 0)
+	{
+		// Otherwise frames are used in turn, and render to the acquired image
+		active_frame_index = (active_frame_index + 1) % static_cast<uint32_t>(frames.size());
+		frames[active_frame_index]->set_render_target(*image_render_targets[active_image_index]);
+	}
+
 	// Now the frame is active again
 	frame_active = true;
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	// Work is submitted in order, so all frames up to the one last recorded with this render frame completed
+	frame_numbers.resize(frames.size(), 0);
+	completed_frame_number            = std::max(completed_frame_number, frame_numbers[active_frame_index]);
+	frame_numbers[active_frame_index] = ++frame_number;
+
+	device.get_resource_cache().begin_frame(frame_number, completed_frame_number);
+
+	// The timestamps of the previous use of the frame can be read back, now that it completed
+	gpu_profiler->begin_frame(active_frame_index);
 }
 
 vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue                        &queue,
                                        const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers,
                                        vk::Semaphore                                     wait_semaphore,
                                        vk::PipelineStageFlags                            wait_pipeline_stage)
+{
+	return submit(queue, command_buffers, wait_semaphore, wait_pipeline_stage, get_active_frame().request_semaphore());
+}
+
+vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue                        &queue,
+                                       const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers,
+                                       vk::Semaphore                                     wait_semaphore,
+                                       vk::PipelineStageFlags                            wait_pipeline_stage,
+                                       vk::Semaphore                                     signal_semaphore)
 {
 	std::vector<vk::CommandBuffer> cmd_buf_handles(command_buffers.size(), nullptr);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const vkb::core::HPPCommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
 	vkb::rendering::HPPRenderFrame &frame = get_active_frame();
 
-	vk::Semaphore signal_semaphore = frame.request_semaphore();
-
 	vk::SubmitInfo submit_info(nullptr, nullptr, cmd_buf_handles, signal_semaphore);
 	if (wait_semaphore)
 	{
@@ -353,6 +464,8 @@ vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue
 		submit_info.pWaitDstStageMask = &wait_pipeline_stage;
 	}
 
+	frame.flush_buffer_allocations();
+
 	vk::Fence fence = frame.request_fence();
 
 	queue.get_handle().submit(submit_info, fence);
@@ -369,6 +482,8 @@ void HPPRenderContext::submit(const vkb::core::HPPQueue &queue, const std::vecto
 
 	vk::SubmitInfo submit_info(nullptr, nullptr, cmd_buf_handles);
 
+	frame.flush_buffer_allocations();
+
 	vk::Fence fence = frame.request_fence();
 
 	queue.get_handle().submit(submit_info, fence);
@@ -385,8 +500,21 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 
 	if (swapchain)
 	{
+		if (frames_in_flight > 0 && semaphore && semaphore != image_render_semaphores[active_image_index])
+		{
+			// A semaphore of the frame may be recycled before the presentation engine is done waiting on it,
+			// forward the signal to the semaphore of the image
+			vk::PipelineStageFlags wait_stage = vk::PipelineStageFlagBits::eAllCommands;
+			vk::SubmitInfo         submit_info(semaphore, wait_stage, nullptr, image_render_semaphores[active_image_index]);
+
+			queue.get_handle().submit(submit_info, get_active_frame().request_fence());
+
+			semaphore = image_render_semaphores[active_image_index];
+		}
+
 		vk::SwapchainKHR   vk_swapchain = swapchain->get_handle();
-		vk::PresentInfoKHR present_info(semaphore, vk_swapchain, active_frame_index);
+		uint32_t           image_index  = get_active_image_index();
+		vk::PresentInfoKHR present_info(semaphore, vk_swapchain, image_index);
 
 		vk::DisplayPresentInfoKHR disp_present_info;
 		if (device.is_extension_supported(VK_KHR_DISPLAY_SWAPCHAIN_EXTENSION_NAME) &&
@@ -465,11 +593,22 @@ vkb::core::HPPDevice &HPPRenderContext::get_device()
 	return device;
 }
 
+vkb::GpuProfiler &HPPRenderContext::get_gpu_profiler()
+{
+	return *gpu_profiler;
+}
+
 void HPPRenderContext::recreate_swapchain()
 {
 	device.get_handle().waitIdle();
 	device.get_resource_cache().clear_framebuffers();
 
+	if (frames_in_flight > 0)
+	{
+		create_image_render_targets();
+		return;
+	}
+
 	vk::Extent2D swapchain_extent = swapchain->get_extent();
 	vk::Extent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
 
@@ -506,6 +645,11 @@ uint32_t HPPRenderContext::get_active_frame_index() const
 	return active_frame_index;
 }
 
+uint32_t HPPRenderContext::get_active_image_index() const
+{
+	return frames_in_flight > 0 ? active_image_index : active_frame_index;
+}
+
 std::vector<std::unique_ptr<vkb::rendering::HPPRenderFrame>> &HPPRenderContext::get_render_frames()
 {
 	return frames;
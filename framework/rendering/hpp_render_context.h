@@ -21,6 +21,7 @@
 #include <core/hpp_device.h>
 #include <core/hpp_swapchain.h>
 #include <platform/window.h>
+#include <rendering/gpu_profiler.h>
 #include <rendering/hpp_render_frame.h>
 
 namespace vkb
@@ -59,12 +60,18 @@ class HPPRenderContext
 
 	HPPRenderContext(HPPRenderContext &&) = delete;
 
-	virtual ~HPPRenderContext() = default;
+	virtual ~HPPRenderContext();
 
 	HPPRenderContext &operator=(const HPPRenderContext &) = delete;
 
 	HPPRenderContext &operator=(HPPRenderContext &&) = delete;
 
+	/**
+	 * @brief Sets the number of frames in flight independently of the number of swapchain images, it must be called before prepare
+	 * @param count The number of RenderFrames, 0 to create a RenderFrame per swapchain image
+	 */
+	void set_frames_in_flight(uint32_t count);
+
 	/**
 	 * @brief Prepares the RenderFrames for rendering
 	 * @param thread_count The number of threads in the application, necessary to allocate this many resource pools for each RenderFrame
@@ -181,6 +188,8 @@ class HPPRenderContext
 
 	vkb::core::HPPDevice &get_device();
 
+	vkb::GpuProfiler &get_gpu_profiler();
+
 	/**
 	 * @brief Returns the format that the RenderTargets are created with within the HPPRenderContext
 	 */
@@ -192,6 +201,12 @@ class HPPRenderContext
 
 	uint32_t get_active_frame_index() const;
 
+	/**
+	 * @return The index of the swapchain image acquired for the active frame
+	 *         It is the active frame index, unless frames in flight are set with set_frames_in_flight
+	 */
+	uint32_t get_active_image_index() const;
+
 	std::vector<std::unique_ptr<HPPRenderFrame>> &get_render_frames();
 
 	/**
@@ -209,6 +224,18 @@ class HPPRenderContext
 	vk::Extent2D surface_extent;
 
   private:
+	/**
+	 * @brief Creates the render targets and the render semaphores of the swapchain images,
+	 *        if frames are not bound to swapchain images
+	 */
+	void create_image_render_targets();
+
+	vk::Semaphore submit(const vkb::core::HPPQueue                        &queue,
+	                     const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers,
+	                     vk::Semaphore                                     wait_semaphore,
+	                     vk::PipelineStageFlags                            wait_pipeline_stage,
+	                     vk::Semaphore                                     signal_semaphore);
+
 	vkb::core::HPPDevice &device;
 
 	const vkb::Window &window;
@@ -232,11 +259,35 @@ class HPPRenderContext
 	/// Whether a frame is active or not
 	bool frame_active{false};
 
+	/// Number of the current frame, increasing with each begin_frame
+	uint64_t frame_number{0};
+
+	/// Number of the last frame whose GPU work is known to be complete
+	uint64_t completed_frame_number{0};
+
+	/// Number of the last frame recorded with each render frame
+	std::vector<uint64_t> frame_numbers;
+
 	HPPRenderTarget::CreateFunc create_render_target_func = HPPRenderTarget::DEFAULT_CREATE_FUNC;
 
 	vk::SurfaceTransformFlagBitsKHR pre_transform{vk::SurfaceTransformFlagBitsKHR::eIdentity};
 
 	size_t thread_count{1};
+
+	/// Number of frames requested with set_frames_in_flight, 0 if frames are bound to swapchain images
+	uint32_t frames_in_flight{0};
+
+	/// Index of the swapchain image acquired for the active frame, if frames are not bound to swapchain images
+	uint32_t active_image_index{0};
+
+	/// Render targets of the swapchain images, if frames are not bound to swapchain images
+	std::vector<std::unique_ptr<HPPRenderTarget>> image_render_targets;
+
+	/// Semaphores signaled once rendering to each swapchain image is complete, if frames are not bound to swapchain images.
+	/// A semaphore waited on by a presentation can only be reused once its image is acquired again
+	std::vector<vk::Semaphore> image_render_semaphores;
+
+	std::unique_ptr<vkb::GpuProfiler> gpu_profiler;
 };
 
 }        // namespace rendering
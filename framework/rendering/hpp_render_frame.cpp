@@ -81,6 +81,24 @@ vkb::BufferAllocationCpp HPPRenderFrame::allocate_buffer(const vk::BufferUsageFl
 	return buffer_block->allocate(to_u32(size));
 }
 
+void HPPRenderFrame::flush_buffer_allocations()
+{
+	if (buffer_allocation_strategy != BufferAllocationStrategy::RingBuffer)
+	{
+		return;
+	}
+
+	for (auto &buffer_pools_per_usage : buffer_pools)
+	{
+		for (auto &buffer_pool : buffer_pools_per_usage.second)
+		{
+			buffer_pool.first.collect_flush_ranges(buffer_flush_batch);
+		}
+	}
+
+	buffer_flush_batch.flush();
+}
+
 void HPPRenderFrame::clear_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
@@ -154,6 +172,27 @@ std::vector<std::unique_ptr<vkb::core::HPPCommandPool>> &HPPRenderFrame::get_com
 	return command_pool_it->second;
 }
 
+vkb::DescriptorPoolStats HPPRenderFrame::get_descriptor_pool_stats() const
+{
+	vkb::DescriptorPoolStats stats;
+
+	for (auto &desc_pools_per_thread : descriptor_pools)
+	{
+		for (auto &desc_pool : *desc_pools_per_thread)
+		{
+			auto pool_stats = desc_pool.second.get_stats();
+
+			stats.pool_count += pool_stats.pool_count;
+			stats.max_sets += pool_stats.max_sets;
+			stats.set_count += pool_stats.set_count;
+			stats.peak_set_count += pool_stats.peak_set_count;
+			stats.allocation_failures += pool_stats.allocation_failures;
+		}
+	}
+
+	return stats;
+}
+
 vkb::core::HPPDevice &HPPRenderFrame::get_device()
 {
 	return device;
@@ -166,12 +205,12 @@ const vkb::HPPFencePool &HPPRenderFrame::get_fence_pool() const
 
 vkb::rendering::HPPRenderTarget &HPPRenderFrame::get_render_target()
 {
-	return *swapchain_render_target;
+	return borrowed_render_target ? *borrowed_render_target : *swapchain_render_target;
 }
 
 vkb::rendering::HPPRenderTarget const &HPPRenderFrame::get_render_target() const
 {
-	return *swapchain_render_target;
+	return borrowed_render_target ? *borrowed_render_target : *swapchain_render_target;
 }
 
 const vkb::HPPSemaphorePool &HPPRenderFrame::get_semaphore_pool() const
@@ -238,6 +277,50 @@ vk::DescriptorSet HPPRenderFrame::request_descriptor_set(const vkb::core::HPPDes
 	}
 }
 
+vk::DescriptorSet HPPRenderFrame::request_descriptor_set(size_t                                      key,
+                                                         const vkb::core::HPPDescriptorSetLayout    &descriptor_set_layout,
+                                                         const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
+                                                         const BindingMap<vk::DescriptorImageInfo>  &image_infos,
+                                                         bool                                        update_after_bind,
+                                                         size_t                                      thread_index)
+{
+	if (descriptor_management_strategy != DescriptorManagementStrategy::StoreInCache)
+	{
+		return request_descriptor_set(descriptor_set_layout, buffer_infos, image_infos, update_after_bind, thread_index);
+	}
+
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	assert(thread_index < descriptor_pools.size());
+	auto &descriptor_pool = vkb::common::request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
+
+	std::vector<uint32_t> bindings_to_update;
+	if (update_after_bind)
+	{
+		bindings_to_update = collect_bindings_to_update(descriptor_set_layout, buffer_infos, image_infos);
+	}
+
+	assert(thread_index < descriptor_sets.size());
+	auto &descriptor_set = vkb::common::request_resource_with_hash(
+	    device, nullptr, *descriptor_sets[thread_index], key, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	descriptor_set.update(bindings_to_update);
+	return descriptor_set.get_handle();
+}
+
+vk::DescriptorSet HPPRenderFrame::find_descriptor_set(size_t key, size_t thread_index) const
+{
+	if (descriptor_management_strategy != DescriptorManagementStrategy::StoreInCache)
+	{
+		return nullptr;
+	}
+
+	assert(thread_index < descriptor_sets.size());
+	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+
+	auto descriptor_set_it = thread_descriptor_sets.find(key);
+	return descriptor_set_it != thread_descriptor_sets.end() ? descriptor_set_it->second.get_handle() : nullptr;
+}
+
 vk::Fence HPPRenderFrame::request_fence()
 {
 	return fence_pool.request_fence();
@@ -255,6 +338,13 @@ vk::Semaphore HPPRenderFrame::request_semaphore_with_ownership()
 
 void HPPRenderFrame::reset()
 {
+	// A single wait for the last value is enough for each queue, as submissions complete in order
+	for (auto &timeline_value : timeline_values)
+	{
+		VK_CHECK(timeline_value.first->wait(timeline_value.second));
+	}
+	timeline_values.clear();
+
 	VK_CHECK(fence_pool.wait());
 
 	fence_pool.reset();
@@ -267,10 +357,17 @@ void HPPRenderFrame::reset()
 		}
 	}
 
+	bool coalesced_buffer_blocks = false;
+
 	for (auto &buffer_pools_per_usage : buffer_pools)
 	{
 		for (auto &buffer_pool : buffer_pools_per_usage.second)
 		{
+			if (buffer_allocation_strategy == BufferAllocationStrategy::RingBuffer && buffer_pool.first.coalesce_blocks())
+			{
+				coalesced_buffer_blocks = true;
+			}
+
 			buffer_pool.first.reset();
 			buffer_pool.second = nullptr;
 		}
@@ -278,7 +375,7 @@ void HPPRenderFrame::reset()
 
 	semaphore_pool.reset();
 
-	if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectly)
+	if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectly || coalesced_buffer_blocks)
 	{
 		clear_descriptors();
 	}
@@ -286,7 +383,17 @@ void HPPRenderFrame::reset()
 
 void HPPRenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_strategy)
 {
+	flush_buffer_allocations();
+
 	buffer_allocation_strategy = new_strategy;
+
+	for (auto &buffer_pools_per_usage : buffer_pools)
+	{
+		for (auto &buffer_pool : buffer_pools_per_usage.second)
+		{
+			buffer_pool.first.set_deferred_flush(new_strategy == BufferAllocationStrategy::RingBuffer);
+		}
+	}
 }
 
 void HPPRenderFrame::set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy)
@@ -304,9 +411,20 @@ void HPPRenderFrame::update_descriptor_sets(size_t thread_index)
 	}
 }
 
+size_t HPPRenderFrame::get_thread_count() const
+{
+	return thread_count;
+}
+
 void HPPRenderFrame::update_render_target(std::unique_ptr<vkb::rendering::HPPRenderTarget> &&render_target)
 {
 	swapchain_render_target = std::move(render_target);
+	borrowed_render_target  = nullptr;
+}
+
+void HPPRenderFrame::set_render_target(vkb::rendering::HPPRenderTarget &render_target)
+{
+	borrowed_render_target = &render_target;
 }
 
 }        // namespace rendering
@@ -29,7 +29,8 @@ namespace rendering
 enum class BufferAllocationStrategy
 {
 	OneAllocationPerBuffer,
-	MultipleAllocationsPerBuffer
+	MultipleAllocationsPerBuffer,
+	RingBuffer
 };
 
 enum class DescriptorManagementStrategy
@@ -67,6 +68,8 @@ class HPPRenderFrame
 	HPPRenderFrame &operator=(HPPRenderFrame &&)      = delete;
 
 	void                                   clear_descriptors();
+	vk::DescriptorSet                      find_descriptor_set(size_t key, size_t thread_index = 0) const;
+	vkb::DescriptorPoolStats               get_descriptor_pool_stats() const;
 	vkb::core::HPPDevice                  &get_device();
 	const vkb::HPPFencePool               &get_fence_pool() const;
 	vkb::rendering::HPPRenderTarget       &get_render_target();
@@ -78,6 +81,12 @@ class HPPRenderFrame
 	                                                              const BindingMap<vk::DescriptorImageInfo>  &image_infos,
 	                                                              bool                                        update_after_bind,
 	                                                              size_t                                      thread_index = 0);
+	vk::DescriptorSet                      request_descriptor_set(size_t                                      key,
+	                                                              const vkb::core::HPPDescriptorSetLayout    &descriptor_set_layout,
+	                                                              const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
+	                                                              const BindingMap<vk::DescriptorImageInfo>  &image_infos,
+	                                                              bool                                        update_after_bind,
+	                                                              size_t                                      thread_index = 0);
 	vk::Fence                              request_fence();
 	vk::Semaphore                          request_semaphore();
 	vk::Semaphore                          request_semaphore_with_ownership();
@@ -91,6 +100,12 @@ class HPPRenderFrame
 	 */
 	vkb::BufferAllocationCpp allocate_buffer(vk::BufferUsageFlags usage, vk::DeviceSize size, size_t thread_index = 0);
 
+	/**
+	 * @brief With the ring buffer strategy, flushes all the non-coherent ranges allocated since the previous flush
+	 *        in a single vmaFlushAllocations call. Must be called before submitting work reading them.
+	 */
+	void flush_buffer_allocations();
+
 	/**
 	 * @brief Requests a command buffer to the command pool of the active frame
 	 *        A frame should be active at the moment of requesting it
@@ -124,11 +139,23 @@ class HPPRenderFrame
 	 */
 	void update_render_target(std::unique_ptr<vkb::rendering::HPPRenderTarget> &&render_target);
 
+	/**
+	 * @brief Makes the frame render to a render target it does not own, until the next update_render_target
+	 *        Used by the HPPRenderContext when frames are not bound to a swapchain image
+	 * @param render_target The render target of the swapchain image acquired for the frame
+	 */
+	void set_render_target(vkb::rendering::HPPRenderTarget &render_target);
+
 	/**
 	 * @brief Updates all the descriptor sets in the current frame at a specific thread index
 	 */
 	void update_descriptor_sets(size_t thread_index = 0);
 
+	/**
+	 * @return The number of threads the frame holds command, descriptor and buffer pools for
+	 */
+	size_t get_thread_count() const;
+
   private:
 	/**
 	 * @brief Retrieve the frame's command pool(s)
@@ -171,11 +198,19 @@ class HPPRenderFrame
 
 	std::unique_ptr<vkb::rendering::HPPRenderTarget> swapchain_render_target;
 
+	/// Render target owned by the HPPRenderContext, used instead of swapchain_render_target if set
+	vkb::rendering::HPPRenderTarget *borrowed_render_target = nullptr;
+
+	/// Last value signaled by the submissions of the frame, for each timeline semaphore, see vkb::RenderFrame::submit
+	std::vector<std::pair<vkb::TimelineSemaphore *, uint64_t>> timeline_values;
+
 	BufferAllocationStrategy buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<vk::BufferUsageFlags, std::vector<std::pair<vkb::BufferPoolCpp, vkb::BufferBlockCpp *>>> buffer_pools;
+
+	vkb::BufferFlushBatch buffer_flush_batch;
 };
 }        // namespace rendering
 }        // namespace vkb
@@ -46,6 +46,22 @@ class HPPRenderPipeline : private vkb::RenderPipeline
 		                          reinterpret_cast<vkb::RenderTarget &>(render_target),
 		                          static_cast<VkSubpassContents>(contents));
 	}
+
+	void draw_in_last_subpass(vkb::core::HPPCommandBuffer &command_buffer, const std::function<void(vkb::core::HPPCommandBuffer &)> &record)
+	{
+		vkb::RenderPipeline::draw_in_last_subpass(reinterpret_cast<vkb::CommandBuffer &>(command_buffer),
+		                                          [&record](vkb::CommandBuffer &cmd_buf) { record(reinterpret_cast<vkb::core::HPPCommandBuffer &>(cmd_buf)); });
+	}
+
+	void set_thread_count(uint32_t count)
+	{
+		vkb::RenderPipeline::set_thread_count(count);
+	}
+
+	uint32_t get_thread_count() const
+	{
+		return vkb::RenderPipeline::get_thread_count();
+	}
 };
 }        // namespace rendering
 }        // namespace vkb
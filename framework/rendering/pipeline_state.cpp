@@ -17,6 +17,8 @@
 
 #include "pipeline_state.h"
 
+#include "common/resource_caching.h"
+
 bool operator==(const VkVertexInputAttributeDescription &lhs, const VkVertexInputAttributeDescription &rhs)
 {
 	return std::tie(lhs.binding, lhs.format, lhs.location, lhs.offset) == std::tie(rhs.binding, rhs.format, rhs.location, rhs.offset);
@@ -84,6 +86,146 @@ bool operator!=(const vkb::ColorBlendState &lhs, const vkb::ColorBlendState &rhs
 
 namespace vkb
 {
+namespace
+{
+size_t hash_pipeline_layout(const PipelineLayout *pipeline_layout)
+{
+	size_t result = 0;
+
+	if (pipeline_layout)
+	{
+		hash_combine(result, pipeline_layout->get_handle());
+
+		for (auto shader_module : pipeline_layout->get_shader_modules())
+		{
+			hash_combine(result, shader_module->get_id());
+		}
+	}
+
+	return result;
+}
+
+size_t hash_render_pass(const RenderPass *render_pass)
+{
+	size_t result = 0;
+
+	// For graphics only
+	if (render_pass)
+	{
+		hash_combine(result, render_pass->get_handle());
+	}
+
+	return result;
+}
+
+// VkPipelineVertexInputStateCreateInfo
+size_t hash_state(const VertexInputState &vertex_input_state)
+{
+	size_t result = 0;
+
+	for (auto &attribute : vertex_input_state.attributes)
+	{
+		hash_combine(result, attribute);
+	}
+
+	for (auto &binding : vertex_input_state.bindings)
+	{
+		hash_combine(result, binding);
+	}
+
+	return result;
+}
+
+// VkPipelineInputAssemblyStateCreateInfo
+size_t hash_state(const InputAssemblyState &input_assembly_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, input_assembly_state.primitive_restart_enable);
+	hash_combine(result, static_cast<std::underlying_type<VkPrimitiveTopology>::type>(input_assembly_state.topology));
+
+	return result;
+}
+
+// VkPipelineRasterizationStateCreateInfo
+size_t hash_state(const RasterizationState &rasterization_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, rasterization_state.cull_mode);
+	hash_combine(result, rasterization_state.depth_bias_enable);
+	hash_combine(result, rasterization_state.depth_clamp_enable);
+	hash_combine(result, static_cast<std::underlying_type<VkFrontFace>::type>(rasterization_state.front_face));
+	hash_combine(result, static_cast<std::underlying_type<VkPolygonMode>::type>(rasterization_state.polygon_mode));
+	hash_combine(result, rasterization_state.rasterizer_discard_enable);
+
+	return result;
+}
+
+// VkPipelineViewportStateCreateInfo
+size_t hash_state(const ViewportState &viewport_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, viewport_state.viewport_count);
+	hash_combine(result, viewport_state.scissor_count);
+
+	return result;
+}
+
+// VkPipelineMultisampleStateCreateInfo
+size_t hash_state(const MultisampleState &multisample_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, multisample_state.alpha_to_coverage_enable);
+	hash_combine(result, multisample_state.alpha_to_one_enable);
+	hash_combine(result, multisample_state.min_sample_shading);
+	hash_combine(result, static_cast<std::underlying_type<VkSampleCountFlagBits>::type>(multisample_state.rasterization_samples));
+	hash_combine(result, multisample_state.sample_shading_enable);
+	hash_combine(result, multisample_state.sample_mask);
+
+	return result;
+}
+
+// VkPipelineDepthStencilStateCreateInfo
+size_t hash_state(const DepthStencilState &depth_stencil_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, depth_stencil_state.back);
+	hash_combine(result, depth_stencil_state.depth_bounds_test_enable);
+	hash_combine(result, static_cast<std::underlying_type<VkCompareOp>::type>(depth_stencil_state.depth_compare_op));
+	hash_combine(result, depth_stencil_state.depth_test_enable);
+	hash_combine(result, depth_stencil_state.depth_write_enable);
+	hash_combine(result, depth_stencil_state.front);
+	hash_combine(result, depth_stencil_state.stencil_test_enable);
+
+	return result;
+}
+
+// VkPipelineColorBlendStateCreateInfo
+size_t hash_state(const ColorBlendState &color_blend_state)
+{
+	size_t result = 0;
+
+	hash_combine(result, static_cast<std::underlying_type<VkLogicOp>::type>(color_blend_state.logic_op));
+	hash_combine(result, color_blend_state.logic_op_enable);
+
+	for (auto &attachment : color_blend_state.attachments)
+	{
+		hash_combine(result, attachment);
+	}
+
+	return result;
+}
+
+size_t hash_state(const SpecializationConstantState &specialization_constant_state)
+{
+	return std::hash<SpecializationConstantState>{}(specialization_constant_state);
+}
+}        // namespace
+
 void SpecializationConstantState::reset()
 {
 	if (dirty)
@@ -128,6 +270,11 @@ const std::map<uint32_t, std::vector<uint8_t>> &SpecializationConstantState::get
 	return specialization_constant_state;
 }
 
+PipelineState::PipelineState()
+{
+	reset();
+}
+
 void PipelineState::reset()
 {
 	clear_dirty();
@@ -151,54 +298,67 @@ void PipelineState::reset()
 	color_blend_state = {};
 
 	subpass_index = {0U};
+
+	pipeline_layout_hash         = 0U;
+	render_pass_hash             = 0U;
+	specialization_constant_hash = hash_state(specialization_constant_state);
+	vertex_input_hash            = hash_state(vertex_input_state);
+	input_assembly_hash          = hash_state(input_assembly_state);
+	rasterization_hash           = hash_state(rasterization_state);
+	viewport_hash                = hash_state(viewport_state);
+	multisample_hash             = hash_state(multisample_state);
+	depth_stencil_hash           = hash_state(depth_stencil_state);
+	color_blend_hash             = hash_state(color_blend_state);
+
+	update_hash();
 }
 
 void PipelineState::set_pipeline_layout(PipelineLayout &new_pipeline_layout)
 {
-	if (pipeline_layout)
+	if (pipeline_layout && pipeline_layout->get_handle() == new_pipeline_layout.get_handle())
 	{
-		if (pipeline_layout->get_handle() != new_pipeline_layout.get_handle())
-		{
-			pipeline_layout = &new_pipeline_layout;
-
-			dirty = true;
-		}
+		return;
 	}
-	else
-	{
-		pipeline_layout = &new_pipeline_layout;
 
-		dirty = true;
-	}
+	pipeline_layout = &new_pipeline_layout;
+
+	pipeline_layout_hash = hash_pipeline_layout(pipeline_layout);
+	update_hash();
+
+	dirty = true;
 }
 
 void PipelineState::set_render_pass(const RenderPass &new_render_pass)
 {
-	if (render_pass)
+	if (render_pass && render_pass->get_handle() == new_render_pass.get_handle())
 	{
-		if (render_pass->get_handle() != new_render_pass.get_handle())
-		{
-			render_pass = &new_render_pass;
-
-			dirty = true;
-		}
+		return;
 	}
-	else
-	{
-		render_pass = &new_render_pass;
 
-		dirty = true;
-	}
+	render_pass = &new_render_pass;
+
+	render_pass_hash = hash_render_pass(render_pass);
+	update_hash();
+
+	dirty = true;
 }
 
 void PipelineState::set_specialization_constant(uint32_t constant_id, const std::vector<uint8_t> &data)
 {
-	specialization_constant_state.set_constant(constant_id, data);
+	auto &constants   = specialization_constant_state.get_specialization_constant_state();
+	auto  constant_it = constants.find(constant_id);
 
-	if (specialization_constant_state.is_dirty())
+	if (constant_it != constants.end() && constant_it->second == data)
 	{
-		dirty = true;
+		return;
 	}
+
+	specialization_constant_state.set_constant(constant_id, data);
+
+	specialization_constant_hash = hash_state(specialization_constant_state);
+	update_hash();
+
+	dirty = true;
 }
 
 void PipelineState::set_vertex_input_state(const VertexInputState &new_vertex_input_state)
@@ -207,6 +367,9 @@ void PipelineState::set_vertex_input_state(const VertexInputState &new_vertex_in
 	{
 		vertex_input_state = new_vertex_input_state;
 
+		vertex_input_hash = hash_state(vertex_input_state);
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -217,6 +380,9 @@ void PipelineState::set_input_assembly_state(const InputAssemblyState &new_input
 	{
 		input_assembly_state = new_input_assembly_state;
 
+		input_assembly_hash = hash_state(input_assembly_state);
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -227,6 +393,9 @@ void PipelineState::set_rasterization_state(const RasterizationState &new_raster
 	{
 		rasterization_state = new_rasterization_state;
 
+		rasterization_hash = hash_state(rasterization_state);
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -237,6 +406,9 @@ void PipelineState::set_viewport_state(const ViewportState &new_viewport_state)
 	{
 		viewport_state = new_viewport_state;
 
+		viewport_hash = hash_state(viewport_state);
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -247,6 +419,9 @@ void PipelineState::set_multisample_state(const MultisampleState &new_multisampl
 	{
 		multisample_state = new_multisample_state;
 
+		multisample_hash = hash_state(multisample_state);
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -257,6 +432,9 @@ void PipelineState::set_depth_stencil_state(const DepthStencilState &new_depth_s
 	{
 		depth_stencil_state = new_depth_stencil_state;
 
+		depth_stencil_hash = hash_state(depth_stencil_state);
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -267,6 +445,9 @@ void PipelineState::set_color_blend_state(const ColorBlendState &new_color_blend
 	{
 		color_blend_state = new_color_blend_state;
 
+		color_blend_hash = hash_state(color_blend_state);
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -277,6 +458,8 @@ void PipelineState::set_subpass_index(uint32_t new_subpass_index)
 	{
 		subpass_index = new_subpass_index;
 
+		update_hash();
+
 		dirty = true;
 	}
 }
@@ -337,6 +520,11 @@ uint32_t PipelineState::get_subpass_index() const
 	return subpass_index;
 }
 
+size_t PipelineState::get_hash() const
+{
+	return hash;
+}
+
 bool PipelineState::is_dirty() const
 {
 	return dirty || specialization_constant_state.is_dirty();
@@ -347,4 +535,21 @@ void PipelineState::clear_dirty()
 	dirty = false;
 	specialization_constant_state.clear_dirty();
 }
+
+void PipelineState::update_hash()
+{
+	hash = 0U;
+
+	hash_combine(hash, pipeline_layout_hash);
+	hash_combine(hash, render_pass_hash);
+	hash_combine(hash, specialization_constant_hash);
+	hash_combine(hash, subpass_index);
+	hash_combine(hash, vertex_input_hash);
+	hash_combine(hash, input_assembly_hash);
+	hash_combine(hash, viewport_hash);
+	hash_combine(hash, rasterization_hash);
+	hash_combine(hash, multisample_hash);
+	hash_combine(hash, depth_stencil_hash);
+	hash_combine(hash, color_blend_hash);
+}
 }        // namespace vkb
@@ -170,9 +170,18 @@ inline void SpecializationConstantState::set_constant<bool>(std::uint32_t consta
 	set_constant(constant_id, to_bytes(static_cast<std::uint32_t>(data)));
 }
 
+/**
+ * @brief Tracks the state used to create a pipeline
+ *
+ * Each sub-state is hashed when its setter changes it, and the hashes are combined into
+ * a key identifying the whole state. Looking up a pipeline thus costs a single hash lookup,
+ * instead of walking the full state on every draw.
+ */
 class PipelineState
 {
   public:
+	PipelineState();
+
 	void reset();
 
 	void set_pipeline_layout(PipelineLayout &pipeline_layout);
@@ -219,11 +228,19 @@ class PipelineState
 
 	uint32_t get_subpass_index() const;
 
+	/**
+	 * @return The hash of the whole state, kept up to date by the setters
+	 */
+	size_t get_hash() const;
+
 	bool is_dirty() const;
 
 	void clear_dirty();
 
   private:
+	/// Combines the sub-state hashes into the state hash
+	void update_hash();
+
 	bool dirty{false};
 
 	PipelineLayout *pipeline_layout{nullptr};
@@ -247,5 +264,27 @@ class PipelineState
 	ColorBlendState color_blend_state{};
 
 	uint32_t subpass_index{0U};
+
+	size_t pipeline_layout_hash{0U};
+
+	size_t render_pass_hash{0U};
+
+	size_t specialization_constant_hash{0U};
+
+	size_t vertex_input_hash{0U};
+
+	size_t input_assembly_hash{0U};
+
+	size_t rasterization_hash{0U};
+
+	size_t viewport_hash{0U};
+
+	size_t multisample_hash{0U};
+
+	size_t depth_stencil_hash{0U};
+
+	size_t color_blend_hash{0U};
+
+	size_t hash{0U};
 };
 }        // namespace vkb
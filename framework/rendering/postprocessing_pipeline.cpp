@@ -28,14 +28,26 @@ PostProcessingPipeline::PostProcessingPipeline(RenderContext &render_context, Sh
 
 void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &default_render_target)
 {
+	std::vector<std::string> pass_names;
+	for (size_t i = 0; i < passes.size(); i++)
+	{
+		if (passes[i]->debug_name.empty())
+		{
+			passes[i]->debug_name = fmt::format("PPP pass #{}", i);
+		}
+		pass_names.push_back(passes[i]->debug_name);
+	}
+
+	auto &gpu_profiler = render_context->get_gpu_profiler();
+
+	uint32_t first_scope = gpu_profiler.reserve_scopes(command_buffer, pass_names);
+
 	for (current_pass_index = 0; current_pass_index < passes.size(); current_pass_index++)
 	{
 		auto &pass = *passes[current_pass_index];
 
-		if (pass.debug_name.empty())
-		{
-			pass.debug_name = fmt::format("PPP pass #{}", current_pass_index);
-		}
+		uint32_t scope = first_scope == GpuProfiler::INVALID_SCOPE ? GpuProfiler::INVALID_SCOPE : first_scope + to_u32(current_pass_index);
+
 		ScopedDebugLabel marker{command_buffer, pass.debug_name.c_str()};
 
 		if (!pass.prepared)
@@ -53,8 +65,13 @@ void PostProcessingPipeline::draw(CommandBuffer &command_buffer, RenderTarget &d
 			pass.pre_draw();
 		}
 
+		// Passes begin and end their own render pass, if any
+		gpu_profiler.begin_scope(command_buffer, scope);
+
 		pass.draw(command_buffer, default_render_target);
 
+		gpu_profiler.end_scope(command_buffer, scope);
+
 		if (pass.post_draw)
 		{
 			ScopedDebugLabel marker{command_buffer, "Post-draw"};
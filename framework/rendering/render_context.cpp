@@ -29,7 +29,7 @@ RenderContext::RenderContext(Device                                &device,
                              VkPresentModeKHR                       present_mode,
                              const std::vector<VkPresentModeKHR>   &present_mode_priority_list,
                              const std::vector<VkSurfaceFormatKHR> &surface_format_priority_list) :
-    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height}
+    device{device}, window{window}, queue{device.get_suitable_graphics_queue()}, surface_extent{window.get_extent().width, window.get_extent().height}, gpu_profiler{std::make_unique<GpuProfiler>(device)}
 {
 	if (surface != VK_NULL_HANDLE)
 	{
@@ -49,11 +49,41 @@ RenderContext::RenderContext(Device                                &device,
 	}
 }
 
+RenderContext::~RenderContext()
+{
+	for (auto semaphore : image_render_semaphores)
+	{
+		vkDestroySemaphore(device.get_handle(), semaphore, nullptr);
+	}
+}
+
+void RenderContext::set_frames_in_flight(uint32_t count)
+{
+	assert(!prepared && "The number of frames in flight must be set before preparing the RenderContext");
+	frames_in_flight = count;
+}
+
 void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create_render_target_func)
 {
 	device.wait_idle();
 
-	if (swapchain)
+	if (frames_in_flight > 0)
+	{
+		if (swapchain)
+		{
+			surface_extent = swapchain->get_extent();
+		}
+
+		this->create_render_target_func = create_render_target_func;
+
+		for (uint32_t i = 0; i < frames_in_flight; i++)
+		{
+			frames.emplace_back(std::make_unique<RenderFrame>(device, nullptr, thread_count));
+		}
+
+		create_image_render_targets();
+	}
+	else if (swapchain)
 	{
 		surface_extent = swapchain->get_extent();
 
@@ -190,10 +220,63 @@ void RenderContext::update_swapchain(const VkImageCompressionFlagsEXT compressio
 	recreate();
 }
 
+void RenderContext::create_image_render_targets()
+{
+	image_render_targets.clear();
+
+	if (swapchain)
+	{
+		VkExtent2D swapchain_extent = swapchain->get_extent();
+		VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
+
+		for (auto &image_handle : swapchain->get_images())
+		{
+			core::Image swapchain_image{device, image_handle,
+			                            extent,
+			                            swapchain->get_format(),
+			                            swapchain->get_usage()};
+
+			image_render_targets.push_back(create_render_target_func(std::move(swapchain_image)));
+		}
+
+		VkSemaphoreCreateInfo create_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+		while (image_render_semaphores.size() < image_render_targets.size())
+		{
+			VkSemaphore semaphore{VK_NULL_HANDLE};
+			VK_CHECK(vkCreateSemaphore(device.get_handle(), &create_info, nullptr, &semaphore));
+			image_render_semaphores.push_back(semaphore);
+		}
+	}
+	else
+	{
+		auto color_image = core::Image{device,
+		                               VkExtent3D{surface_extent.width, surface_extent.height, 1},
+		                               DEFAULT_VK_FORMAT,
+		                               VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+		                               VMA_MEMORY_USAGE_GPU_ONLY};
+
+		image_render_targets.push_back(create_render_target_func(std::move(color_image)));
+	}
+
+	// Frames render to the first image until they are used again
+	active_image_index = 0;
+	for (auto &frame : frames)
+	{
+		frame->set_render_target(*image_render_targets[0]);
+	}
+}
+
 void RenderContext::recreate()
 {
 	LOGI("Recreated swapchain");
 
+	if (frames_in_flight > 0)
+	{
+		create_image_render_targets();
+		device.get_resource_cache().clear_framebuffers();
+		return;
+	}
+
 	VkExtent2D swapchain_extent = swapchain->get_extent();
 	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
 
@@ -294,7 +377,14 @@ void RenderContext::submit(const std::vector<CommandBuffer *> &command_buffers)
 	if (swapchain)
 	{
 		assert(acquired_semaphore && "We do not have acquired_semaphore, it was probably consumed?\n");
-		render_semaphore = submit(queue, command_buffers, acquired_semaphore, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		if (frames_in_flight > 0)
+		{
+			render_semaphore = submit(queue, command_buffers, acquired_semaphore, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, image_render_semaphores[active_image_index]);
+		}
+		else
+		{
+			render_semaphore = submit(queue, command_buffers, acquired_semaphore, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		}
 	}
 	else
 	{
@@ -323,7 +413,10 @@ void RenderContext::begin_frame()
 
 	if (swapchain)
 	{
-		auto result = swapchain->acquire_next_image(active_frame_index, acquired_semaphore, VK_NULL_HANDLE);
+		// Frames bound to swapchain images are selected by the acquired image
+		uint32_t &image_index = frames_in_flight > 0 ? active_image_index : active_frame_index;
+
+		auto result = swapchain->acquire_next_image(image_index, acquired_semaphore, VK_NULL_HANDLE);
 
 		if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
@@ -340,7 +433,7 @@ void RenderContext::begin_frame()
 				// Need to destroy and reallocate acquired_semaphore since it may have already been signaled
 				vkDestroySemaphore(device.get_handle(), acquired_semaphore, nullptr);
 				acquired_semaphore = prev_frame.request_semaphore_with_ownership();
-				result             = swapchain->acquire_next_image(active_frame_index, acquired_semaphore, VK_NULL_HANDLE);
+				result             = swapchain->acquire_next_image(image_index, acquired_semaphore, VK_NULL_HANDLE);
 			}
 		}
 
@@ -351,22 +444,42 @@ void RenderContext::begin_frame()
 		}
 	}
 
+	if (frames_in_flight > 0)
+	{
+		// Otherwise frames are used in turn, and render to the acquired image
+		active_frame_index = (active_frame_index + 1) % to_u32(frames.size());
+		frames[active_frame_index]->set_render_target(*image_render_targets[active_image_index]);
+	}
+
 	// Now the frame is active again
 	frame_active = true;
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	// Work is submitted in order, so all frames up to the one last recorded with this render frame completed
+	frame_numbers.resize(frames.size(), 0);
+	completed_frame_number            = std::max(completed_frame_number, frame_numbers[active_frame_index]);
+	frame_numbers[active_frame_index] = ++frame_number;
+
+	device.get_resource_cache().begin_frame(frame_number, completed_frame_number);
+
+	// The timestamps of the previous use of the frame can be read back, now that it completed
+	gpu_profiler->begin_frame(active_frame_index);
 }
 
 VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
+{
+	return submit(queue, command_buffers, wait_semaphore, wait_pipeline_stage, get_active_frame().request_semaphore());
+}
+
+VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage, VkSemaphore signal_semaphore)
 {
 	std::vector<VkCommandBuffer> cmd_buf_handles(command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(command_buffers.begin(), command_buffers.end(), cmd_buf_handles.begin(), [](const CommandBuffer *cmd_buf) { return cmd_buf->get_handle(); });
 
 	RenderFrame &frame = get_active_frame();
 
-	VkSemaphore signal_semaphore = frame.request_semaphore();
-
 	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
 
 	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
@@ -382,9 +495,7 @@ VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandB
 	submit_info.signalSemaphoreCount = 1;
 	submit_info.pSignalSemaphores    = &signal_semaphore;
 
-	VkFence fence = frame.request_fence();
-
-	VK_CHECK(queue.submit({submit_info}, fence));
+	frame.submit(queue, submit_info);
 
 	return signal_semaphore;
 }
@@ -401,9 +512,7 @@ void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *
 	submit_info.commandBufferCount = to_u32(cmd_buf_handles.size());
 	submit_info.pCommandBuffers    = cmd_buf_handles.data();
 
-	VkFence fence = frame.request_fence();
-
-	VK_CHECK(queue.submit({submit_info}, fence));
+	frame.submit(queue, submit_info);
 }
 
 void RenderContext::wait_frame()
@@ -418,6 +527,24 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 
 	if (swapchain)
 	{
+		if (frames_in_flight > 0 && semaphore != VK_NULL_HANDLE && semaphore != image_render_semaphores[active_image_index])
+		{
+			// A semaphore of the frame may be recycled before the presentation engine is done waiting on it,
+			// forward the signal to the semaphore of the image
+			VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+			VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+			submit_info.waitSemaphoreCount   = 1;
+			submit_info.pWaitSemaphores      = &semaphore;
+			submit_info.pWaitDstStageMask    = &wait_stage;
+			submit_info.signalSemaphoreCount = 1;
+			submit_info.pSignalSemaphores    = &image_render_semaphores[active_image_index];
+
+			get_active_frame().submit(queue, submit_info);
+
+			semaphore = image_render_semaphores[active_image_index];
+		}
+
 		VkSwapchainKHR vk_swapchain = swapchain->get_handle();
 
 		VkPresentInfoKHR present_info{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
@@ -426,7 +553,7 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 		present_info.pWaitSemaphores    = &semaphore;
 		present_info.swapchainCount     = 1;
 		present_info.pSwapchains        = &vk_swapchain;
-		present_info.pImageIndices      = &active_frame_index;
+		present_info.pImageIndices      = frames_in_flight > 0 ? &active_image_index : &active_frame_index;
 
 		VkDisplayPresentInfoKHR disp_present_info{};
 		if (device.is_extension_supported(VK_KHR_DISPLAY_SWAPCHAIN_EXTENSION_NAME) &&
@@ -504,11 +631,22 @@ Device &RenderContext::get_device()
 	return device;
 }
 
+GpuProfiler &RenderContext::get_gpu_profiler()
+{
+	return *gpu_profiler;
+}
+
 void RenderContext::recreate_swapchain()
 {
 	device.wait_idle();
 	device.get_resource_cache().clear_framebuffers();
 
+	if (frames_in_flight > 0)
+	{
+		create_image_render_targets();
+		return;
+	}
+
 	VkExtent2D swapchain_extent = swapchain->get_extent();
 	VkExtent3D extent{swapchain_extent.width, swapchain_extent.height, 1};
 
@@ -549,6 +687,11 @@ uint32_t RenderContext::get_active_frame_index() const
 	return active_frame_index;
 }
 
+uint32_t RenderContext::get_active_image_index() const
+{
+	return frames_in_flight > 0 ? active_image_index : active_frame_index;
+}
+
 std::vector<std::unique_ptr<RenderFrame>> &RenderContext::get_render_frames()
 {
 	return frames;
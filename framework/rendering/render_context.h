@@ -30,6 +30,7 @@
 #include "core/render_pass.h"
 #include "core/shader_module.h"
 #include "core/swapchain.h"
+#include "rendering/gpu_profiler.h"
 #include "rendering/pipeline_state.h"
 #include "rendering/render_frame.h"
 #include "rendering/render_target.h"
@@ -53,6 +54,10 @@ class Window;
  *
  * For offscreen rendering (no swapchain), the RenderContext can be given a valid Device, and
  * a width and height. A single RenderFrame will then be created.
+ *
+ * Alternatively, the number of frames in flight can be set with set_frames_in_flight. The RenderTargets
+ * and the semaphores signaled for presentation are then kept per swapchain image, while the frames,
+ * which own the command, buffer and descriptor pools, are used in turn whichever image is acquired.
  */
 class RenderContext
 {
@@ -82,12 +87,18 @@ class RenderContext
 
 	RenderContext(RenderContext &&) = delete;
 
-	virtual ~RenderContext() = default;
+	virtual ~RenderContext();
 
 	RenderContext &operator=(const RenderContext &) = delete;
 
 	RenderContext &operator=(RenderContext &&) = delete;
 
+	/**
+	 * @brief Sets the number of frames in flight independently of the number of swapchain images, it must be called before prepare
+	 * @param count The number of RenderFrames, 0 to create a RenderFrame per swapchain image
+	 */
+	void set_frames_in_flight(uint32_t count);
+
 	/**
 	 * @brief Prepares the RenderFrames for rendering
 	 * @param thread_count The number of threads in the application, necessary to allocate this many resource pools for each RenderFrame
@@ -208,6 +219,11 @@ class RenderContext
 
 	Device &get_device();
 
+	/**
+	 * @brief Returns the profiler timing the passes of the RenderPipelines and PostProcessingPipelines on the GPU
+	 */
+	GpuProfiler &get_gpu_profiler();
+
 	/**
 	 * @brief Returns the format that the RenderTargets are created with within the RenderContext
 	 */
@@ -219,6 +235,12 @@ class RenderContext
 
 	uint32_t get_active_frame_index() const;
 
+	/**
+	 * @return The index of the swapchain image acquired for the active frame
+	 *         It is the active frame index, unless frames in flight are set with set_frames_in_flight
+	 */
+	uint32_t get_active_image_index() const;
+
 	std::vector<std::unique_ptr<RenderFrame>> &get_render_frames();
 
 	/**
@@ -236,6 +258,14 @@ class RenderContext
 	VkExtent2D surface_extent;
 
   private:
+	/**
+	 * @brief Creates the render targets and the render semaphores of the swapchain images,
+	 *        if frames are not bound to swapchain images
+	 */
+	void create_image_render_targets();
+
+	VkSemaphore submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage, VkSemaphore signal_semaphore);
+
 	Device &device;
 
 	const Window &window;
@@ -259,11 +289,35 @@ class RenderContext
 	/// Whether a frame is active or not
 	bool frame_active{false};
 
+	/// Number of the current frame, increasing with each begin_frame
+	uint64_t frame_number{0};
+
+	/// Number of the last frame whose GPU work is known to be complete
+	uint64_t completed_frame_number{0};
+
+	/// Number of the last frame recorded with each render frame
+	std::vector<uint64_t> frame_numbers;
+
 	RenderTarget::CreateFunc create_render_target_func = RenderTarget::DEFAULT_CREATE_FUNC;
 
 	VkSurfaceTransformFlagBitsKHR pre_transform{VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR};
 
 	size_t thread_count{1};
+
+	/// Number of frames requested with set_frames_in_flight, 0 if frames are bound to swapchain images
+	uint32_t frames_in_flight{0};
+
+	/// Index of the swapchain image acquired for the active frame, if frames are not bound to swapchain images
+	uint32_t active_image_index{0};
+
+	/// Render targets of the swapchain images, if frames are not bound to swapchain images
+	std::vector<std::unique_ptr<RenderTarget>> image_render_targets;
+
+	/// Semaphores signaled once rendering to each swapchain image is complete, if frames are not bound to swapchain images.
+	/// A semaphore waited on by a presentation can only be reused once its image is acquired again
+	std::vector<VkSemaphore> image_render_semaphores;
+
+	std::unique_ptr<GpuProfiler> gpu_profiler;
 };
 
 }        // namespace vkb
@@ -60,10 +60,23 @@ Device &RenderFrame::get_device()
 void RenderFrame::update_render_target(std::unique_ptr<RenderTarget> &&render_target)
 {
 	swapchain_render_target = std::move(render_target);
+	borrowed_render_target  = nullptr;
+}
+
+void RenderFrame::set_render_target(RenderTarget &render_target)
+{
+	borrowed_render_target = &render_target;
 }
 
 void RenderFrame::reset()
 {
+	// A single wait for the last value is enough for each queue, as submissions complete in order
+	for (auto &timeline_value : timeline_values)
+	{
+		VK_CHECK(timeline_value.first->wait(timeline_value.second));
+	}
+	timeline_values.clear();
+
 	VK_CHECK(fence_pool.wait());
 
 	fence_pool.reset();
@@ -76,10 +89,18 @@ void RenderFrame::reset()
 		}
 	}
 
+	bool coalesced_buffer_blocks = false;
+
 	for (auto &buffer_pools_per_usage : buffer_pools)
 	{
 		for (auto &buffer_pool : buffer_pools_per_usage.second)
 		{
+			// The ring converges to a single block per pool, as the frame completed no block is in use anymore
+			if (buffer_allocation_strategy == BufferAllocationStrategy::RingBuffer && buffer_pool.first.coalesce_blocks())
+			{
+				coalesced_buffer_blocks = true;
+			}
+
 			buffer_pool.first.reset();
 			buffer_pool.second = nullptr;
 		}
@@ -87,7 +108,8 @@ void RenderFrame::reset()
 
 	semaphore_pool.reset();
 
-	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly)
+	// Descriptor sets of the frame may refer to the destroyed blocks
+	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly || coalesced_buffer_blocks)
 	{
 		clear_descriptors();
 	}
@@ -163,6 +185,31 @@ VkFence RenderFrame::request_fence()
 	return fence_pool.request_fence();
 }
 
+void RenderFrame::submit(const Queue &queue, const VkSubmitInfo &submit_info)
+{
+	flush_buffer_allocations();
+
+	if (!device.has_timeline_semaphores())
+	{
+		VK_CHECK(queue.submit({submit_info}, request_fence()));
+		return;
+	}
+
+	auto &timeline_semaphore = device.get_timeline_semaphore(queue);
+
+	uint64_t value = timeline_semaphore.submit(queue.get_handle(), submit_info);
+
+	auto it = std::find_if(timeline_values.begin(), timeline_values.end(), [&timeline_semaphore](auto &timeline_value) { return timeline_value.first == &timeline_semaphore; });
+	if (it != timeline_values.end())
+	{
+		it->second = value;
+	}
+	else
+	{
+		timeline_values.emplace_back(&timeline_semaphore, value);
+	}
+}
+
 const SemaphorePool &RenderFrame::get_semaphore_pool() const
 {
 	return semaphore_pool;
@@ -185,12 +232,12 @@ void RenderFrame::release_owned_semaphore(VkSemaphore semaphore)
 
 RenderTarget &RenderFrame::get_render_target()
 {
-	return *swapchain_render_target;
+	return borrowed_render_target ? *borrowed_render_target : *swapchain_render_target;
 }
 
 const RenderTarget &RenderFrame::get_render_target_const() const
 {
-	return *swapchain_render_target;
+	return borrowed_render_target ? *borrowed_render_target : *swapchain_render_target;
 }
 
 CommandBuffer &RenderFrame::request_command_buffer(const Queue &queue, CommandBuffer::ResetMode reset_mode, VkCommandBufferLevel level, size_t thread_index)
@@ -235,6 +282,50 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 	}
 }
 
+VkDescriptorSet RenderFrame::request_descriptor_set(size_t key, const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos, bool update_after_bind, size_t thread_index)
+{
+	if (descriptor_management_strategy != DescriptorManagementStrategy::StoreInCache)
+	{
+		return request_descriptor_set(descriptor_set_layout, buffer_infos, image_infos, update_after_bind, thread_index);
+	}
+
+	assert(thread_index < thread_count && "Thread index is out of bounds");
+
+	assert(thread_index < descriptor_pools.size());
+	auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
+
+	std::vector<uint32_t> bindings_to_update;
+	if (update_after_bind)
+	{
+		bindings_to_update = collect_bindings_to_update(descriptor_set_layout, buffer_infos, image_infos);
+	}
+
+	assert(thread_index < descriptor_sets.size());
+	auto &descriptor_set = request_resource_with_hash(device, nullptr, *descriptor_sets[thread_index], key, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	descriptor_set.update(bindings_to_update);
+	return descriptor_set.get_handle();
+}
+
+VkDescriptorSet RenderFrame::find_descriptor_set(size_t key, size_t thread_index) const
+{
+	if (descriptor_management_strategy != DescriptorManagementStrategy::StoreInCache)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	assert(thread_index < descriptor_sets.size());
+	auto &thread_descriptor_sets = *descriptor_sets[thread_index];
+
+	auto descriptor_set_it = thread_descriptor_sets.find(key);
+	if (descriptor_set_it == thread_descriptor_sets.end())
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	// Writes were applied when the descriptor set was requested, or are deferred to update_descriptor_sets with update after bind
+	return descriptor_set_it->second.get_handle();
+}
+
 void RenderFrame::update_descriptor_sets(size_t thread_index)
 {
 	assert(thread_index < descriptor_sets.size());
@@ -245,6 +336,11 @@ void RenderFrame::update_descriptor_sets(size_t thread_index)
 	}
 }
 
+size_t RenderFrame::get_thread_count() const
+{
+	return thread_count;
+}
+
 void RenderFrame::clear_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
@@ -261,9 +357,41 @@ void RenderFrame::clear_descriptors()
 	}
 }
 
+DescriptorPoolStats RenderFrame::get_descriptor_pool_stats() const
+{
+	DescriptorPoolStats stats;
+
+	for (auto &desc_pools_per_thread : descriptor_pools)
+	{
+		for (auto &desc_pool : *desc_pools_per_thread)
+		{
+			auto pool_stats = desc_pool.second.get_stats();
+
+			stats.pool_count += pool_stats.pool_count;
+			stats.max_sets += pool_stats.max_sets;
+			stats.set_count += pool_stats.set_count;
+			stats.peak_set_count += pool_stats.peak_set_count;
+			stats.allocation_failures += pool_stats.allocation_failures;
+		}
+	}
+
+	return stats;
+}
+
 void RenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_strategy)
 {
+	// Allocations made with the previous strategy may still need a flush
+	flush_buffer_allocations();
+
 	buffer_allocation_strategy = new_strategy;
+
+	for (auto &buffer_pools_per_usage : buffer_pools)
+	{
+		for (auto &buffer_pool : buffer_pools_per_usage.second)
+		{
+			buffer_pool.first.set_deferred_flush(new_strategy == BufferAllocationStrategy::RingBuffer);
+		}
+	}
 }
 
 void RenderFrame::set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy)
@@ -298,4 +426,22 @@ BufferAllocationC RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, c
 
 	return buffer_block->allocate(to_u32(size));
 }
+
+void RenderFrame::flush_buffer_allocations()
+{
+	if (buffer_allocation_strategy != BufferAllocationStrategy::RingBuffer)
+	{
+		return;
+	}
+
+	for (auto &buffer_pools_per_usage : buffer_pools)
+	{
+		for (auto &buffer_pool : buffer_pools_per_usage.second)
+		{
+			buffer_pool.first.collect_flush_ranges(buffer_flush_batch);
+		}
+	}
+
+	buffer_flush_batch.flush();
+}
 }        // namespace vkb
@@ -37,7 +37,10 @@ namespace vkb
 enum BufferAllocationStrategy
 {
 	OneAllocationPerBuffer,
-	MultipleAllocationsPerBuffer
+	MultipleAllocationsPerBuffer,
+	/// One persistently mapped buffer per usage and thread, reused every time the frame completed,
+	/// written in place and flushed once per submit (see RenderFrame::flush_buffer_allocations)
+	RingBuffer
 };
 
 enum DescriptorManagementStrategy
@@ -92,6 +95,13 @@ class RenderFrame
 
 	VkFence request_fence();
 
+	/**
+	 * @brief Submits work of the frame to a queue, reset waits for it to complete
+	 *        The submission is tracked with the timeline semaphore of the queue if the device supports them, otherwise with a fence of the frame.
+	 *        Buffer allocations are flushed first (see flush_buffer_allocations)
+	 */
+	void submit(const Queue &queue, const VkSubmitInfo &submit_info);
+
 	const SemaphorePool &get_semaphore_pool() const;
 
 	VkSemaphore request_semaphore();
@@ -104,6 +114,13 @@ class RenderFrame
 	 */
 	void update_render_target(std::unique_ptr<RenderTarget> &&render_target);
 
+	/**
+	 * @brief Makes the frame render to a render target it does not own, until the next update_render_target
+	 *        Used by the RenderContext when frames are not bound to a swapchain image
+	 * @param render_target The render target of the swapchain image acquired for the frame
+	 */
+	void set_render_target(RenderTarget &render_target);
+
 	RenderTarget &get_render_target();
 
 	const RenderTarget &get_render_target_const() const;
@@ -129,8 +146,32 @@ class RenderFrame
 	                                       bool                                      update_after_bind,
 	                                       size_t                                    thread_index = 0);
 
+	/**
+	 * @brief Same as request_descriptor_set, but the descriptor set is stored under a key computed by the caller
+	 * @param key Identifies the descriptor set layout and the resources written to the descriptor set
+	 */
+	VkDescriptorSet request_descriptor_set(size_t                                    key,
+	                                       const DescriptorSetLayout &               descriptor_set_layout,
+	                                       const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                                       const BindingMap<VkDescriptorImageInfo> & image_infos,
+	                                       bool                                      update_after_bind,
+	                                       size_t                                    thread_index = 0);
+
+	/**
+	 * @brief Looks up a descriptor set previously requested with a key, without building any descriptor info
+	 * @param key The key the descriptor set was requested with
+	 * @param thread_index Selects the thread's descriptor sets
+	 * @return The descriptor set, or VK_NULL_HANDLE if it was not found or descriptor sets are not stored in cache
+	 */
+	VkDescriptorSet find_descriptor_set(size_t key, size_t thread_index = 0) const;
+
 	void clear_descriptors();
 
+	/**
+	 * @return The statistics of all the descriptor pools of the frame, summed over threads and layouts
+	 */
+	DescriptorPoolStats get_descriptor_pool_stats() const;
+
 	/**
 	 * @brief Sets a new buffer allocation strategy
 	 * @param new_strategy The new buffer allocation strategy
@@ -151,11 +192,23 @@ class RenderFrame
 	 */
 	BufferAllocationC allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index = 0);
 
+	/**
+	 * @brief With the ring buffer strategy, flushes all the non-coherent ranges allocated since the previous flush
+	 *        in a single vmaFlushAllocations call. Must be called before submitting work reading them,
+	 *        submit does it already.
+	 */
+	void flush_buffer_allocations();
+
 	/**
 	 * @brief Updates all the descriptor sets in the current frame at a specific thread index
 	 */
 	void update_descriptor_sets(size_t thread_index = 0);
 
+	/**
+	 * @return The number of threads the frame holds command, descriptor and buffer pools for
+	 */
+	size_t get_thread_count() const;
+
   private:
 	Device &device;
 
@@ -185,11 +238,20 @@ class RenderFrame
 
 	std::unique_ptr<RenderTarget> swapchain_render_target;
 
+	/// Render target owned by the RenderContext, used instead of swapchain_render_target if set
+	RenderTarget *borrowed_render_target{nullptr};
+
+	/// Last value signaled by the submissions of the frame, for each timeline semaphore
+	std::vector<std::pair<TimelineSemaphore *, uint64_t>> timeline_values;
+
 	BufferAllocationStrategy     buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPoolC, BufferBlockC *>>> buffer_pools;
 
+	/// Reused by flush_buffer_allocations to avoid allocating on every submit
+	BufferFlushBatch buffer_flush_batch;
+
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
 };
 }        // namespace vkb
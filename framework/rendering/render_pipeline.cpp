@@ -17,6 +17,7 @@
 
 #include "render_pipeline.h"
 
+#include "core/util/job_system.hpp"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/material.h"
@@ -96,6 +97,34 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 		clear_value.push_back({0.0f, 0.0f, 0.0f, 1.0f});
 	}
 
+	// Callers recording their own secondary command buffers keep drawing the subpasses themselves
+	drawn_in_parallel = thread_count > 1 && contents == VK_SUBPASS_CONTENTS_INLINE;
+	render_extent     = render_target.get_extent();
+
+	// Timestamps can't be written in the primary command buffer inside a subpass with secondary contents,
+	// so subpasses drawn into secondary command buffers by the caller are not timed
+	bool timed = contents == VK_SUBPASS_CONTENTS_INLINE;
+
+	if (drawn_in_parallel)
+	{
+		contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+	}
+
+	// The timestamps of the subpasses are reset before the render pass begins
+	std::vector<std::string> subpass_names;
+	for (size_t i = 0; i < subpasses.size(); ++i)
+	{
+		if (subpasses[i]->get_debug_name().empty())
+		{
+			subpasses[i]->set_debug_name(fmt::format("RP subpass #{}", i));
+		}
+		subpass_names.push_back(subpasses[i]->get_debug_name());
+	}
+
+	auto &gpu_profiler = subpasses[0]->get_render_context().get_gpu_profiler();
+
+	uint32_t first_scope = timed ? gpu_profiler.reserve_scopes(command_buffer, subpass_names) : GpuProfiler::INVALID_SCOPE;
+
 	for (size_t i = 0; i < subpasses.size(); ++i)
 	{
 		active_subpass_index = i;
@@ -108,23 +137,175 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 		{
 			command_buffer.begin_render_pass(render_target, load_store, clear_value, subpasses, contents);
 		}
+		else if (drawn_in_parallel)
+		{
+			command_buffer.next_subpass(contents);
+		}
 		else
 		{
 			command_buffer.next_subpass();
 		}
 
-		if (subpass->get_debug_name().empty())
+		uint32_t scope = first_scope == GpuProfiler::INVALID_SCOPE ? GpuProfiler::INVALID_SCOPE : first_scope + to_u32(i);
+
+		if (drawn_in_parallel)
 		{
-			subpass->set_debug_name(fmt::format("RP subpass #{}", i));
+			draw_chunks(command_buffer, *subpass, scope);
 		}
-		ScopedDebugLabel subpass_debug_label{command_buffer, subpass->get_debug_name().c_str()};
+		else
+		{
+			gpu_profiler.begin_scope(command_buffer, scope);
+
+			{
+				ScopedDebugLabel subpass_debug_label{command_buffer, subpass->get_debug_name().c_str()};
 
-		subpass->draw(command_buffer);
+				subpass->draw(command_buffer);
+			}
+
+			gpu_profiler.end_scope(command_buffer, scope);
+		}
 	}
 
 	active_subpass_index = 0;
 }
 
+void RenderPipeline::draw_chunks(CommandBuffer &primary_command_buffer, vkb::rendering::SubpassC &subpass, uint32_t scope)
+{
+	auto &render_context = subpass.get_render_context();
+	auto &render_frame   = render_context.get_active_frame();
+	auto &gpu_profiler   = render_context.get_gpu_profiler();
+
+	uint32_t max_chunk_count = to_u32(std::min<size_t>(thread_count, render_frame.get_thread_count()));
+
+	// Subpasses which do not implement the chunk functions themselves are recorded whole, with their own draw
+	bool drawn_in_chunks = subpass.has_draw_chunks();
+
+	// Sorting and splitting the draw happens on the calling thread, chunks only read the result
+	uint32_t chunk_count = drawn_in_chunks ? std::clamp(subpass.prepare_draw_chunks(max_chunk_count), 1u, max_chunk_count) : 1;
+
+	// Command pools are created by the first request, so command buffers are all requested before recording
+	const auto &queue = primary_command_buffer.get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	std::vector<CommandBuffer *> secondary_command_buffers;
+	for (uint32_t i = 0; i < chunk_count; ++i)
+	{
+		secondary_command_buffers.push_back(&render_frame.request_command_buffer(queue, primary_command_buffer.get_reset_mode(), VK_COMMAND_BUFFER_LEVEL_SECONDARY, i));
+	}
+
+	auto record_chunk = [&](uint32_t chunk_index) {
+		auto &secondary_command_buffer = *secondary_command_buffers[chunk_index];
+
+		begin_secondary_command_buffer(secondary_command_buffer, primary_command_buffer);
+
+		// The chunks are executed in order, timestamps can't be written in the primary command buffer
+		if (chunk_index == 0)
+		{
+			gpu_profiler.begin_scope(secondary_command_buffer, scope);
+		}
+
+		{
+			ScopedDebugLabel subpass_debug_label{secondary_command_buffer, subpass.get_debug_name().c_str()};
+
+			if (drawn_in_chunks)
+			{
+				subpass.draw_chunk(secondary_command_buffer, chunk_index, chunk_index);
+			}
+			else
+			{
+				subpass.draw(secondary_command_buffer);
+			}
+		}
+
+		if (chunk_index == chunk_count - 1)
+		{
+			gpu_profiler.end_scope(secondary_command_buffer, scope);
+		}
+
+		secondary_command_buffer.end();
+	};
+
+	auto &job_system = JobSystem::get();
+
+	// Each chunk records with the pools of its own thread index, whichever worker runs it
+	std::vector<JobSystem::JobHandle> chunk_jobs;
+	for (uint32_t i = 1; i < chunk_count; ++i)
+	{
+		chunk_jobs.push_back(job_system.schedule([&record_chunk, i]() { record_chunk(i); }));
+	}
+
+	// The first chunk uses the pools of thread index 0, as the primary command buffer does
+	try
+	{
+		record_chunk(0);
+	}
+	catch (...)
+	{
+		// The other chunks reference this stack frame
+		try
+		{
+			job_system.wait(chunk_jobs);
+		}
+		catch (...)
+		{
+		}
+		throw;
+	}
+
+	job_system.wait(chunk_jobs);
+
+	primary_command_buffer.execute_commands(secondary_command_buffers);
+}
+
+void RenderPipeline::begin_secondary_command_buffer(CommandBuffer &secondary_command_buffer, CommandBuffer &primary_command_buffer) const
+{
+	secondary_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &primary_command_buffer);
+
+	// Dynamic state is not inherited from the primary command buffer
+	VkViewport viewport{};
+	viewport.width    = static_cast<float>(render_extent.width);
+	viewport.height   = static_cast<float>(render_extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	secondary_command_buffer.set_viewport(0, {viewport});
+
+	VkRect2D scissor{};
+	scissor.extent = render_extent;
+	secondary_command_buffer.set_scissor(0, {scissor});
+}
+
+void RenderPipeline::draw_in_last_subpass(CommandBuffer &command_buffer, const std::function<void(CommandBuffer &)> &record)
+{
+	if (!drawn_in_parallel)
+	{
+		record(command_buffer);
+		return;
+	}
+
+	auto &render_frame = subpasses.back()->get_render_context().get_active_frame();
+
+	const auto &queue = command_buffer.get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+	auto &secondary_command_buffer = render_frame.request_command_buffer(queue, command_buffer.get_reset_mode(), VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+	begin_secondary_command_buffer(secondary_command_buffer, command_buffer);
+
+	record(secondary_command_buffer);
+
+	secondary_command_buffer.end();
+
+	command_buffer.execute_commands(secondary_command_buffer);
+}
+
+void RenderPipeline::set_thread_count(uint32_t count)
+{
+	thread_count = std::max(count, 1u);
+}
+
+uint32_t RenderPipeline::get_thread_count() const
+{
+	return thread_count;
+}
+
 std::unique_ptr<vkb::rendering::SubpassC> &RenderPipeline::get_active_subpass()
 {
 	return subpasses[active_subpass_index];
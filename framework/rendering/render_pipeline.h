@@ -35,6 +35,14 @@ namespace vkb
  * GeometrySubpass -> Processes Scene for Shaders, use by itself if shader requires no lighting
  * ForwardSubpass -> Binds lights at the beginning of a GeometrySubpass to create Forward Rendering, should be used with most default shaders
  * LightingSubpass -> Holds a Global Light uniform, Can be combined with GeometrySubpass to create Deferred Rendering
+ *
+ * Subpasses are recorded inline by default. With more than one thread (see set_thread_count), the draw of each
+ * subpass is split in chunks recorded concurrently into secondary command buffers, which are then executed in order.
+ * Subpasses which do not implement the chunk functions themselves (see Subpass::has_draw_chunks) are recorded
+ * whole with their draw, in a single secondary command buffer.
+ *
+ * Each subpass is timed on the GPU by the GpuProfiler of the RenderContext, under its debug name, unless draw
+ * is called with secondary command buffer contents.
  */
 class RenderPipeline
 {
@@ -89,6 +97,27 @@ class RenderPipeline
 	 */
 	void draw(CommandBuffer &command_buffer, RenderTarget &render_target, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
+	/**
+	 * @brief Records additional commands in the last subpass begun by draw, before the render pass is ended
+	 *        If the subpasses were recorded in parallel, the subpass only accepts secondary command buffers:
+	 *        the commands are then recorded in one from the calling thread, with a viewport and scissor
+	 *        covering the render target, and executed from the primary command buffer
+	 * @param command_buffer The command buffer draw recorded the render pass into
+	 * @param record Function recording the commands
+	 */
+	void draw_in_last_subpass(CommandBuffer &command_buffer, const std::function<void(CommandBuffer &)> &record);
+
+	/**
+	 * @brief Sets the number of threads recording the subpasses in draw, on the job system
+	 *        Chunk i of a subpass is recorded with the pools of thread index i of the active RenderFrame,
+	 *        so the number of chunks is also limited by the thread count of the RenderContext.
+	 *        Parallel recording only applies when draw is called with inline contents.
+	 * @param count Number of threads, 1 (the default) records the subpasses inline on the calling thread
+	 */
+	void set_thread_count(uint32_t count);
+
+	uint32_t get_thread_count() const;
+
 	/**
 	 * @return Subpass currently being recorded, or the first one
 	 *         if drawing has not started
@@ -96,6 +125,19 @@ class RenderPipeline
 	std::unique_ptr<vkb::rendering::SubpassC> &get_active_subpass();
 
   private:
+	/**
+	 * @brief Records the chunks of a subpass in secondary command buffers, and executes them in order
+	 * @param primary_command_buffer The command buffer the render pass is recorded into
+	 * @param subpass The subpass to draw
+	 * @param scope The GPU profiler scope timing the subpass, written by the first and last chunks
+	 */
+	void draw_chunks(CommandBuffer &primary_command_buffer, vkb::rendering::SubpassC &subpass, uint32_t scope);
+
+	/**
+	 * @brief Begins a secondary command buffer inheriting the current subpass of the primary one
+	 */
+	void begin_secondary_command_buffer(CommandBuffer &secondary_command_buffer, CommandBuffer &primary_command_buffer) const;
+
 	std::vector<std::unique_ptr<vkb::rendering::SubpassC>> subpasses;
 
 	/// Default to two load store
@@ -105,5 +147,14 @@ class RenderPipeline
 	std::vector<VkClearValue> clear_value = std::vector<VkClearValue>(2);
 
 	size_t active_subpass_index{0};
+
+	/// Maximum number of chunks per subpass, the chunks other than the first one are recorded by jobs
+	uint32_t thread_count{1};
+
+	/// Whether the last draw recorded its subpasses in secondary command buffers
+	bool drawn_in_parallel{false};
+
+	/// Extent of the render target of the last draw, used for the viewport of the secondary command buffers
+	VkExtent2D render_extent{};
 };
 }        // namespace vkb
@@ -25,6 +25,8 @@
 #include "scene_graph/components/light.h"
 #include "scene_graph/node.h"
 
+#include <typeinfo>
+
 namespace vkb
 {
 class CommandBuffer;
@@ -105,6 +107,31 @@ class Subpass
 	 */
 	virtual void draw(CommandBufferType &command_buffer) = 0;
 
+	/**
+	 * @brief Splits the draw of the current frame in chunks which can be recorded concurrently
+	 *        Called by the RenderPipeline on the recording thread, before any draw_chunk, and only if
+	 *        has_draw_chunks returns true. By default the draw is not split.
+	 * @param max_chunk_count Maximum number of chunks the draw can be split in
+	 * @return The number of chunks to record
+	 */
+	virtual uint32_t prepare_draw_chunks(uint32_t max_chunk_count);
+
+	/**
+	 * @brief Records one of the chunks prepared by prepare_draw_chunks
+	 *        Chunks are recorded concurrently, each one in its own secondary command buffer.
+	 *        By default the whole draw is recorded.
+	 * @param command_buffer Secondary command buffer to record the chunk into
+	 * @param chunk_index Index of the chunk to record
+	 * @param thread_index Thread index to use for allocating resources
+	 */
+	virtual void draw_chunk(CommandBufferType &command_buffer, uint32_t chunk_index, size_t thread_index);
+
+	/**
+	 * @return True if the chunk functions are implemented by the class of the subpass itself, see set_draw_chunks_type.
+	 *         Otherwise the RenderPipeline records the subpass with draw, in a single chunk
+	 */
+	bool has_draw_chunks() const;
+
 	/**
 	 * @brief Prepares the shaders and shader variants for a subpass
 	 */
@@ -151,12 +178,24 @@ class Subpass
 	 */
 	void update_render_target_attachments(RenderTargetType &render_target);
 
+  protected:
+	/**
+	 * @brief Declares the class implementing the chunk functions, called by its constructor
+	 *        A subclass which overrides draw without declaring itself is recorded with its draw,
+	 *        instead of with the chunks of its parent class
+	 * @param type The class implementing the chunk functions
+	 */
+	void set_draw_chunks_type(const std::type_info &type);
+
   private:
 	/// Default to no color resolve attachments
 	std::vector<uint32_t> color_resolve_attachments = {};
 
 	std::string debug_name{};
 
+	/// Class implementing the chunk functions, if any
+	const std::type_info *draw_chunks_type{nullptr};
+
 	/**
 	 * @brief When creating the renderpass, if not None, the resolve
 	 *        of the multisampled depth attachment will be enabled,
@@ -223,6 +262,30 @@ inline Subpass<bindingType>::Subpass(RenderContextType &render_context, ShaderSo
 {
 }
 
+template <vkb::BindingType bindingType>
+inline uint32_t Subpass<bindingType>::prepare_draw_chunks(uint32_t max_chunk_count)
+{
+	return 1;
+}
+
+template <vkb::BindingType bindingType>
+inline void Subpass<bindingType>::draw_chunk(CommandBufferType &command_buffer, uint32_t chunk_index, size_t thread_index)
+{
+	draw(command_buffer);
+}
+
+template <vkb::BindingType bindingType>
+inline bool Subpass<bindingType>::has_draw_chunks() const
+{
+	return draw_chunks_type && *draw_chunks_type == typeid(*this);
+}
+
+template <vkb::BindingType bindingType>
+inline void Subpass<bindingType>::set_draw_chunks_type(const std::type_info &type)
+{
+	draw_chunks_type = &type;
+}
+
 template <vkb::BindingType bindingType>
 inline const std::vector<uint32_t> &Subpass<bindingType>::get_input_attachments() const
 {
@@ -35,6 +35,7 @@ namespace vkb
 ForwardSubpass::ForwardSubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
     GeometrySubpass{render_context, std::move(vertex_source), std::move(fragment_source), scene_, camera}
 {
+	set_draw_chunks_type(typeid(ForwardSubpass));
 }
 
 void ForwardSubpass::prepare()
@@ -64,4 +65,18 @@ void ForwardSubpass::draw(CommandBuffer &command_buffer)
 
 	GeometrySubpass::draw(command_buffer);
 }
+
+uint32_t ForwardSubpass::prepare_draw_chunks(uint32_t max_chunk_count)
+{
+	allocate_lights<ForwardLights>(scene.get_components<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+
+	return GeometrySubpass::prepare_draw_chunks(max_chunk_count);
+}
+
+void ForwardSubpass::draw_chunk(CommandBuffer &command_buffer, uint32_t chunk_index, size_t thread_index)
+{
+	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
+
+	GeometrySubpass::draw_chunk(command_buffer, chunk_index, thread_index);
+}
 }        // namespace vkb
@@ -65,6 +65,13 @@ class ForwardSubpass : public GeometrySubpass
 	 * @brief Record draw commands
 	 */
 	virtual void draw(CommandBuffer &command_buffer) override;
+
+	/**
+	 * @brief Allocates the lights of the frame, then prepares the chunks of the geometry
+	 */
+	virtual uint32_t prepare_draw_chunks(uint32_t max_chunk_count) override;
+
+	virtual void draw_chunk(CommandBuffer &command_buffer, uint32_t chunk_index, size_t thread_index) override;
 };
 
 }        // namespace vkb
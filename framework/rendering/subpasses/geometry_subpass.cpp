@@ -16,8 +16,11 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+#include "common/helpers.h"
 #include "common/utils.h"
 #include "common/vk_common.h"
+#include "core/util/job_system.hpp"
+#include "core/util/profiling.hpp"
 #include "rendering/render_context.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
@@ -28,14 +31,40 @@
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace vkb
 {
+namespace
+{
+/**
+ * @brief Hashes the image views and samplers of the textures of a material, which draw packets cache
+ */
+size_t hash_textures(const sg::Material &material)
+{
+	size_t hash = 0;
+
+	for (auto &texture : material.textures)
+	{
+		hash_combine(hash, &texture.second->get_image()->get_vk_image_view());
+		hash_combine(hash, texture.second->get_sampler());
+	}
+
+	return hash;
+}
+}        // namespace
+
 GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&vertex_source, ShaderSource &&fragment_source, sg::Scene &scene_, sg::Camera &camera) :
     Subpass{render_context, std::move(vertex_source), std::move(fragment_source)},
     meshes{scene_.get_components<sg::Mesh>()},
     camera{camera},
     scene{scene_}
 {
+	set_draw_chunks_type(typeid(GeometrySubpass));
+
+	// The shaders compiled with INSTANCED are still reflected before drawing instances, this only avoids building them needlessly
+	instance_data_declared = get_vertex_shader().get_source().find(INSTANCE_DATA_NAME) != std::string::npos;
 }
 
 void GeometrySubpass::prepare()
@@ -49,6 +78,44 @@ void GeometrySubpass::prepare()
 			auto &variant     = sub_mesh->get_shader_variant();
 			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
 			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+
+			// Meshes with several instances may be drawn with instanced draws, if the shaders support them
+			if (instancing && instance_data_declared && mesh->get_nodes().size() > 1)
+			{
+				auto instanced_variant = variant;
+				instanced_variant.add_define("INSTANCED");
+
+				device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), instanced_variant);
+				device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), instanced_variant);
+			}
+		}
+	}
+
+	prepare_draw_state_ids();
+
+	invalidate_draw_packets();
+}
+
+void GeometrySubpass::prepare_draw_state_ids()
+{
+	std::unordered_map<size_t, uint32_t>              variant_ids;
+	std::unordered_map<const sg::Material *, uint32_t> material_ids;
+	uint32_t                                           sub_mesh_id = 0;
+
+	draw_state_ids.clear();
+	draw_state_ids.reserve(meshes.size());
+
+	// Dense ids in order of first use
+	for (auto &mesh : meshes)
+	{
+		auto &mesh_state_ids = draw_state_ids.emplace_back();
+
+		for (auto &sub_mesh : mesh->get_submeshes())
+		{
+			uint64_t variant_id  = variant_ids.emplace(sub_mesh->get_shader_variant().get_id(), to_u32(variant_ids.size())).first->second;
+			uint64_t material_id = material_ids.emplace(sub_mesh->get_material(), to_u32(material_ids.size())).first->second;
+
+			mesh_state_ids.push_back(DrawList::make_state_key(variant_id, material_id, sub_mesh_id++));
 		}
 	}
 }
@@ -57,58 +124,292 @@ void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *
 {
 	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
 
-	for (auto &mesh : meshes)
+	cull_instances();
+
+	for (size_t i = 0; i < culling_instances.size(); i++)
 	{
-		for (auto &node : mesh->get_nodes())
+		if (!culling_visibility[i])
 		{
-			auto node_transform = node->get_transform().get_world_matrix();
+			continue;
+		}
+
+		auto &instance = culling_instances[i];
+
+		glm::vec3 center{culling_bounds.center_x[i], culling_bounds.center_y[i], culling_bounds.center_z[i]};
+
+		float distance = glm::length(glm::vec3(camera_transform[3]) - center);
+
+		for (auto &sub_mesh : instance.mesh->get_submeshes())
+		{
+			update_draw_packet(*sub_mesh);
+
+			if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
+			{
+				transparent_nodes.emplace(distance, std::make_pair(instance.node, sub_mesh));
+			}
+			else
+			{
+				opaque_nodes.emplace(distance, std::make_pair(instance.node, sub_mesh));
+			}
+		}
+	}
+}
+
+void GeometrySubpass::sort_draws()
+{
+	PROFILE_FUNCTION();
+
+	if (draw_state_ids.size() != meshes.size())
+	{
+		prepare_draw_state_ids();
+	}
+
+	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
+
+	cull_instances();
+
+	draw_list.clear();
+	draw_list_items.clear();
+
+	for (size_t i = 0; i < culling_instances.size(); i++)
+	{
+		if (!culling_visibility[i])
+		{
+			continue;
+		}
+
+		auto &instance = culling_instances[i];
+
+		glm::vec3 center{culling_bounds.center_x[i], culling_bounds.center_y[i], culling_bounds.center_z[i]};
 
-			const sg::AABB &mesh_bounds = mesh->get_bounds();
+		float distance = glm::length(glm::vec3(camera_transform[3]) - center);
 
-			sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
-			world_bounds.transform(node_transform);
+		// Flipped meshes are drawn with the other front face, which is a different pipeline
+		const auto &scale   = instance.node->get_transform().get_scale();
+		bool        flipped = scale.x * scale.y * scale.z < 0;
 
-			float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
+		auto &sub_meshes     = instance.mesh->get_submeshes();
+		auto &mesh_state_ids = draw_state_ids[instance.mesh_index];
 
-			for (auto &sub_mesh : mesh->get_submeshes())
+		for (size_t j = 0; j < sub_meshes.size(); j++)
+		{
+			uint64_t key;
+
+			if (sub_meshes[j]->get_material()->alpha_mode == sg::AlphaMode::Blend)
+			{
+				key = DrawList::make_transparent_key(distance);
+			}
+			else
 			{
-				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
-				{
-					transparent_nodes.emplace(distance, std::make_pair(node, sub_mesh));
-				}
-				else
-				{
-					opaque_nodes.emplace(distance, std::make_pair(node, sub_mesh));
-				}
+				key = DrawList::make_opaque_key(mesh_state_ids[j], flipped, distance);
 			}
+
+			draw_list.push_back(key, to_u32(draw_list_items.size()));
+			draw_list_items.emplace_back(instance.node, sub_meshes[j]);
+
+			update_draw_packet(*sub_meshes[j]);
+		}
+	}
+
+	draw_list.sort();
+
+	sorted_opaque_nodes.clear();
+	sorted_transparent_nodes.clear();
+	draw_group_offsets.clear();
+
+	uint64_t group_key = ~0ull;
+
+	for (auto &entry : draw_list.get_entries())
+	{
+		if (DrawList::is_transparent(entry.key))
+		{
+			sorted_transparent_nodes.push_back(draw_list_items[entry.index]);
+			continue;
+		}
+
+		// Instances of the same submesh with the same front face are adjacent, the submesh ids may be clamped though
+		auto &item = draw_list_items[entry.index];
+		if (!instancing || !instance_data_declared || DrawList::get_group(entry.key) != group_key || sorted_opaque_nodes.back().second != item.second)
+		{
+			draw_group_offsets.push_back(sorted_opaque_nodes.size());
+			group_key = DrawList::get_group(entry.key);
+		}
+
+		sorted_opaque_nodes.push_back(item);
+	}
+
+	draw_group_offsets.push_back(sorted_opaque_nodes.size());
+
+	for (size_t i = 0; i + 1 < draw_group_offsets.size(); i++)
+	{
+		if (draw_group_offsets[i + 1] - draw_group_offsets[i] > 1)
+		{
+			update_draw_packet(*sorted_opaque_nodes[draw_group_offsets[i]].second, true);
 		}
 	}
 }
 
+void GeometrySubpass::cull_instances()
+{
+	PROFILE_FUNCTION();
+
+	static Plot<int64_t> visible_objects{VISIBLE_OBJECTS_PLOT};
+	static Plot<int64_t> culled_objects{CULLED_OBJECTS_PLOT};
+
+	// Once updated, the world matrices can be read from any thread, such as the recording threads
+	scene.update_transforms();
+
+	culling_instances.clear();
+	culling_world_matrices.clear();
+	for (uint32_t mesh_index = 0; mesh_index < meshes.size(); mesh_index++)
+	{
+		for (auto &node : meshes[mesh_index]->get_nodes())
+		{
+			culling_instances.push_back({node, meshes[mesh_index], mesh_index});
+			culling_world_matrices.push_back(node->get_transform().get_world_matrix());
+		}
+	}
+
+	frustum.update(camera.get_projection() * camera.get_view());
+
+	culling_bounds.resize(culling_instances.size());
+	culling_visibility.resize(culling_instances.size());
+
+	auto cull_batch = [this](size_t batch_index) {
+		size_t begin = batch_index * CULLING_BATCH_SIZE;
+		size_t end   = std::min(begin + CULLING_BATCH_SIZE, culling_instances.size());
+
+		for (size_t i = begin; i < end; i++)
+		{
+			const sg::AABB &mesh_bounds = culling_instances[i].mesh->get_bounds();
+
+			glm::vec3 min = mesh_bounds.get_min();
+			glm::vec3 max = mesh_bounds.get_max();
+
+			// Meshes without bounds are never culled
+			if (min.x > max.x || min.y > max.y || min.z > max.z)
+			{
+				culling_bounds.set(i, glm::vec3{0.0f}, glm::vec3{std::numeric_limits<float>::max()});
+				continue;
+			}
+
+			const auto &world_matrix = culling_world_matrices[i];
+
+			// The world bounds of the box transformed by the matrix, same as transforming its corners
+			glm::vec3 center = glm::vec3(world_matrix * glm::vec4((min + max) * 0.5f, 1.0f));
+			glm::mat3 abs_matrix{glm::abs(glm::vec3(world_matrix[0])), glm::abs(glm::vec3(world_matrix[1])), glm::abs(glm::vec3(world_matrix[2]))};
+			glm::vec3 extent = abs_matrix * ((max - min) * 0.5f);
+
+			culling_bounds.set(i, center, extent);
+		}
+
+		if (frustum_culling)
+		{
+			frustum.check_boxes(culling_bounds, begin, end, culling_visibility.data() + begin);
+		}
+		else
+		{
+			std::fill(culling_visibility.begin() + begin, culling_visibility.begin() + end, uint8_t{1});
+		}
+	};
+
+	size_t batch_count = (culling_instances.size() + CULLING_BATCH_SIZE - 1) / CULLING_BATCH_SIZE;
+
+	if (batch_count > 1)
+	{
+		JobSystem::get().parallel_for(batch_count, cull_batch);
+	}
+	else if (batch_count == 1)
+	{
+		cull_batch(0);
+	}
+
+	int64_t visible_count = 0;
+	int64_t culled_count  = 0;
+
+	for (size_t i = 0; i < culling_instances.size(); i++)
+	{
+		auto sub_mesh_count = static_cast<int64_t>(culling_instances[i].mesh->get_submeshes().size());
+
+		if (culling_visibility[i])
+		{
+			visible_count += sub_mesh_count;
+		}
+		else
+		{
+			culled_count += sub_mesh_count;
+		}
+	}
+
+	visible_objects.plot(visible_count);
+	culled_objects.plot(culled_count);
+}
+
 void GeometrySubpass::draw(CommandBuffer &command_buffer)
 {
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
+	// Not dispatched, so that subclasses extending the chunk functions do not run their part twice
+	GeometrySubpass::prepare_draw_chunks(1);
+	GeometrySubpass::draw_chunk(command_buffer, 0, thread_index);
+}
+
+uint32_t GeometrySubpass::prepare_draw_chunks(uint32_t max_chunk_count)
+{
+	sort_draws();
+
+	size_t group_count = draw_group_offsets.size() - 1;
+
+	uint32_t chunk_count = std::max(1u, std::min(max_chunk_count, to_u32(group_count)));
+
+	// Chunks draw whole groups, with about the same number of instances each
+	draw_chunk_offsets.resize(chunk_count + 1);
+	for (uint32_t i = 0; i <= chunk_count; ++i)
+	{
+		size_t first_instance = sorted_opaque_nodes.size() * i / chunk_count;
+
+		draw_chunk_offsets[i] = std::lower_bound(draw_group_offsets.begin(), draw_group_offsets.end() - 1, first_instance) - draw_group_offsets.begin();
+	}
+
+	return chunk_count;
+}
 
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
+void GeometrySubpass::draw_chunk(CommandBuffer &command_buffer, uint32_t chunk_index, size_t thread_index)
+{
+	assert(chunk_index + 1 < draw_chunk_offsets.size() && "Draw chunks were not prepared");
 
 	// Draw opaque objects in front-to-back order
 	{
 		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		for (size_t group = draw_chunk_offsets[chunk_index]; group < draw_chunk_offsets[chunk_index + 1]; ++group)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			size_t begin = draw_group_offsets[group];
+			size_t end   = draw_group_offsets[group + 1];
 
-			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
+			// Invert the front face if the mesh was flipped, all the instances of a group have the same front face
+			const auto &scale      = sorted_opaque_nodes[begin].first->get_transform().get_scale();
 			bool        flipped    = scale.x * scale.y * scale.z < 0;
 			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
+			if (end - begin > 1 && draw_instances(command_buffer, begin, end - begin, front_face, thread_index))
+			{
+				continue;
+			}
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				update_uniform(command_buffer, *sorted_opaque_nodes[i].first, thread_index);
+
+				draw_submesh(command_buffer, *sorted_opaque_nodes[i].second, front_face);
+			}
 		}
 	}
 
+	// Transparent objects must be blended after all the opaque ones
+	if (chunk_index + 2 != draw_chunk_offsets.size())
+	{
+		return;
+	}
+
 	// Enable alpha blending
 	ColorBlendAttachmentState color_blend_attachment{};
 	color_blend_attachment.blend_enable           = VK_TRUE;
@@ -130,11 +431,11 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 	{
 		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
 
-		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+		for (auto &node : sorted_transparent_nodes)
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			update_uniform(command_buffer, *node.first, thread_index);
 
-			draw_submesh(command_buffer, *node_it->second.second);
+			draw_submesh(command_buffer, *node.second);
 		}
 	}
 }
@@ -162,8 +463,6 @@ void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &no
 
 void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face)
 {
-	auto &device = command_buffer.get_device();
-
 	ScopedDebugLabel submesh_debug_label{command_buffer, sub_mesh.get_name().c_str()};
 
 	prepare_pipeline_state(command_buffer, front_face, sub_mesh.get_material()->double_sided);
@@ -172,36 +471,149 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	multisample_state.rasterization_samples = get_sample_count();
 	command_buffer.set_multisample_state(multisample_state);
 
-	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), sub_mesh.get_shader_variant());
-	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), sub_mesh.get_shader_variant());
+	auto packet_it = draw_packets.find(&sub_mesh);
 
-	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
+	if (packet_it != draw_packets.end())
+	{
+		auto &packet = *packet_it->second;
 
-	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+		std::call_once(packet.built, [&]() { build_draw_packet(command_buffer, sub_mesh, packet); });
 
-	command_buffer.bind_pipeline_layout(pipeline_layout);
+		draw_packet(command_buffer, sub_mesh, packet);
+	}
+	else
+	{
+		// Submeshes drawn without sort_draws, for instance by subclasses, are resolved on every draw
+		DrawPacket packet;
+		packet.variant = sub_mesh.get_shader_variant();
+		if (auto pbr_material = dynamic_cast<const sg::PBRMaterial *>(sub_mesh.get_material()))
+		{
+			packet.material_uniform = {pbr_material->base_color_factor, pbr_material->metallic_factor, pbr_material->roughness_factor};
+		}
+		build_draw_packet(command_buffer, sub_mesh, packet);
+
+		draw_packet(command_buffer, sub_mesh, packet);
+	}
+}
+
+bool GeometrySubpass::draw_instances(CommandBuffer &command_buffer, size_t begin, size_t count, VkFrontFace front_face, size_t thread_index)
+{
+	auto &sub_mesh = *sorted_opaque_nodes[begin].second;
+
+	auto packet_it = instanced_draw_packets.find(&sub_mesh);
+
+	if (packet_it == instanced_draw_packets.end())
+	{
+		return false;
+	}
+
+	auto &packet = *packet_it->second;
+
+	std::call_once(packet.built, [&]() { build_draw_packet(command_buffer, sub_mesh, packet); });
 
-	if (pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0)
+	if (packet.instance_data_binding == ~0u)
 	{
-		prepare_push_constants(command_buffer, sub_mesh);
+		return false;
 	}
 
+	ScopedDebugLabel submesh_debug_label{command_buffer, sub_mesh.get_name().c_str()};
+
+	// The camera uniforms are shared by the instances, the model matrix of GlobalUniform is unused
+	update_uniform(command_buffer, *sorted_opaque_nodes[begin].first, thread_index);
+
+	auto &render_frame = get_render_context().get_active_frame();
+
+	auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, count * sizeof(glm::mat4), thread_index);
+
+	// Reused by the groups drawn on the thread, so that it does not allocate once warmed up
+	thread_local std::vector<glm::mat4> models;
+
+	models.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		models[i] = sorted_opaque_nodes[begin + i].first->get_transform().get_world_matrix();
+	}
+
+	allocation.update(reinterpret_cast<const uint8_t *>(models.data()), models.size() * sizeof(glm::mat4));
+
+	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, packet.instance_data_binding, 0);
+
+	prepare_pipeline_state(command_buffer, front_face, sub_mesh.get_material()->double_sided);
+
+	bind_draw_packet(command_buffer, sub_mesh, packet);
+
+	draw_submesh_command(command_buffer, sub_mesh, to_u32(count));
+
+	return true;
+}
+
+void GeometrySubpass::update_draw_packet(sg::SubMesh &sub_mesh, bool instanced)
+{
+	// Packets are replaced before recording, while recording they are only looked up
+	auto &packet = instanced ? instanced_draw_packets[&sub_mesh] : draw_packets[&sub_mesh];
+
+	auto *material      = sub_mesh.get_material();
+	auto  textures_hash = hash_textures(*material);
+
+	// The image views and samplers of the textures are cached in the packet
+	if (!packet || packet->material != material || packet->textures_hash != textures_hash || packet->variant_id != sub_mesh.get_shader_variant().get_id())
+	{
+		packet                = std::make_unique<DrawPacket>();
+		packet->material      = material;
+		packet->textures_hash = textures_hash;
+		packet->variant_id    = sub_mesh.get_shader_variant().get_id();
+		packet->variant       = sub_mesh.get_shader_variant();
+		packet->pbr_material  = dynamic_cast<const sg::PBRMaterial *>(material);
+
+		if (instanced)
+		{
+			packet->variant.add_define("INSTANCED");
+		}
+	}
+
+	// The factors may be animated, copying them is cheaper than comparing them
+	if (packet->pbr_material)
+	{
+		packet->material_uniform = {packet->pbr_material->base_color_factor, packet->pbr_material->metallic_factor, packet->pbr_material->roughness_factor};
+	}
+}
+
+void GeometrySubpass::build_draw_packet(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawPacket &packet)
+{
+	auto &device = command_buffer.get_device();
+
+	auto &vert_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), packet.variant);
+	auto &frag_shader_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), packet.variant);
+
+	std::vector<ShaderModule *> shader_modules{&vert_shader_module, &frag_shader_module};
+
+	auto &pipeline_layout = prepare_pipeline_layout(command_buffer, shader_modules);
+
+	packet.pipeline_layout    = &pipeline_layout;
+	packet.has_push_constants = pipeline_layout.get_push_constant_range_stage(sizeof(PBRMaterialUniform)) != 0;
+
 	DescriptorSetLayout &descriptor_set_layout = pipeline_layout.get_descriptor_set_layout(0);
 
+	for (auto &storage_resource : pipeline_layout.get_resources(ShaderResourceType::BufferStorage, VK_SHADER_STAGE_VERTEX_BIT))
+	{
+		if (storage_resource.name == INSTANCE_DATA_NAME && storage_resource.set == 0)
+		{
+			packet.instance_data_binding = storage_resource.binding;
+		}
+	}
+
 	for (auto &texture : sub_mesh.get_material()->textures)
 	{
 		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
 		{
-			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
-			                          texture.second->get_sampler()->vk_sampler,
-			                          0, layout_binding->binding, 0);
+			packet.image_bindings.push_back({&texture.second->get_image()->get_vk_image_view(),
+			                                 &texture.second->get_sampler()->vk_sampler,
+			                                 layout_binding->binding});
 		}
 	}
 
 	auto vertex_input_resources = pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT);
 
-	VertexInputState vertex_input_state;
-
 	for (auto &input_resource : vertex_input_resources)
 	{
 		sg::VertexAttribute attribute;
@@ -217,17 +629,15 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 		vertex_attribute.location = input_resource.location;
 		vertex_attribute.offset   = attribute.offset;
 
-		vertex_input_state.attributes.push_back(vertex_attribute);
+		packet.vertex_input_state.attributes.push_back(vertex_attribute);
 
 		VkVertexInputBindingDescription vertex_binding{};
 		vertex_binding.binding = input_resource.location;
 		vertex_binding.stride  = attribute.stride;
 
-		vertex_input_state.bindings.push_back(vertex_binding);
+		packet.vertex_input_state.bindings.push_back(vertex_binding);
 	}
 
-	command_buffer.set_vertex_input_state(vertex_input_state);
-
 	// Find submesh vertex buffers matching the shader input attribute names
 	for (auto &input_resource : vertex_input_resources)
 	{
@@ -235,17 +645,41 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 
 		if (buffer_iter != sub_mesh.vertex_buffers.end())
 		{
-			std::vector<std::reference_wrapper<const vkb::core::BufferC>> buffers;
-			buffers.emplace_back(std::ref(buffer_iter->second));
-
 			// Bind vertex buffers only for the attribute locations defined
-			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+			packet.vertex_buffer_bindings.push_back({input_resource.location, {std::cref(buffer_iter->second)}, {0}});
 		}
 	}
+}
+
+void GeometrySubpass::draw_packet(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawPacket &packet)
+{
+	bind_draw_packet(command_buffer, sub_mesh, packet);
 
 	draw_submesh_command(command_buffer, sub_mesh);
 }
 
+void GeometrySubpass::bind_draw_packet(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawPacket &packet)
+{
+	command_buffer.bind_pipeline_layout(*packet.pipeline_layout);
+
+	if (packet.has_push_constants)
+	{
+		prepare_push_constants(command_buffer, sub_mesh, packet);
+	}
+
+	for (auto &image_binding : packet.image_bindings)
+	{
+		command_buffer.bind_image(*image_binding.image_view, *image_binding.sampler, 0, image_binding.binding, 0);
+	}
+
+	command_buffer.set_vertex_input_state(packet.vertex_input_state);
+
+	for (auto &vertex_buffer_binding : packet.vertex_buffer_bindings)
+	{
+		command_buffer.bind_vertex_buffers(vertex_buffer_binding.location, vertex_buffer_binding.buffers, vertex_buffer_binding.offsets);
+	}
+}
+
 void GeometrySubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material)
 {
 	RasterizationState rasterization_state = base_rasterization_state;
@@ -277,24 +711,12 @@ PipelineLayout &GeometrySubpass::prepare_pipeline_layout(CommandBuffer &command_
 	return command_buffer.get_device().get_resource_cache().request_pipeline_layout(shader_modules);
 }
 
-void GeometrySubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+void GeometrySubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, const DrawPacket &packet)
 {
-	auto pbr_material = dynamic_cast<const sg::PBRMaterial *>(sub_mesh.get_material());
-
-	PBRMaterialUniform pbr_material_uniform{};
-	pbr_material_uniform.base_color_factor = pbr_material->base_color_factor;
-	pbr_material_uniform.metallic_factor   = pbr_material->metallic_factor;
-	pbr_material_uniform.roughness_factor  = pbr_material->roughness_factor;
-
-	auto data = to_bytes(pbr_material_uniform);
-
-	if (!data.empty())
-	{
-		command_buffer.push_constants(data);
-	}
+	command_buffer.push_constants(packet.material_uniform);
 }
 
-void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
+void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t instance_count)
 {
 	// Draw submesh indexed if indices exists
 	if (sub_mesh.vertex_indices != 0)
@@ -303,12 +725,12 @@ void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::Su
 		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
 
 		// Draw submesh using indexed data
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, 0);
+		command_buffer.draw_indexed(sub_mesh.vertex_indices, instance_count, 0, 0, 0);
 	}
 	else
 	{
 		// Draw submesh using vertices only
-		command_buffer.draw(sub_mesh.vertices_count, 1, 0, 0);
+		command_buffer.draw(sub_mesh.vertices_count, instance_count, 0, 0);
 	}
 }
 
@@ -316,4 +738,20 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_frustum_culling(bool enabled)
+{
+	frustum_culling = enabled;
+}
+
+void GeometrySubpass::set_instancing(bool enabled)
+{
+	instancing = enabled;
+}
+
+void GeometrySubpass::invalidate_draw_packets()
+{
+	draw_packets.clear();
+	instanced_draw_packets.clear();
+}
 }        // namespace vkb
@@ -17,18 +17,32 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "common/error.h"
+#include "core/util/draw_list.hpp"
 
 #include "common/glm_common.h"
 
+#include "geometry/frustum.h"
 #include "rendering/subpass.h"
 
 namespace vkb
 {
+namespace core
+{
+class ImageView;
+class Sampler;
+}        // namespace core
+
 namespace sg
 {
 class Scene;
 class Node;
+class Material;
+class PBRMaterial;
 class Mesh;
 class SubMesh;
 class Camera;
@@ -60,10 +74,27 @@ struct PBRMaterialUniform
 
 /**
  * @brief This subpass is responsible for rendering a Scene
+ *
+ * Objects whose bounds are outside of the view frustum of the camera are not drawn. The opaque objects are
+ * sorted to minimize the state changes between draws, the transparent ones back-to-front.
+ *
+ * Visible opaque instances of the same submesh are drawn with a single instanced draw, if the vertex shader
+ * declares the InstanceData storage buffer when INSTANCED is defined. Their model matrices are written to that
+ * buffer, the model matrix of GlobalUniform is then unused. Otherwise each instance is drawn on its own.
  */
 class GeometrySubpass : public vkb::rendering::SubpassC
 {
   public:
+	/// Plots of the objects drawn and culled in the last frame culled by a geometry subpass, see CullingStatsProvider
+	static constexpr const char *VISIBLE_OBJECTS_PLOT = "Visible Objects";
+	static constexpr const char *CULLED_OBJECTS_PLOT  = "Culled Objects";
+
+	/// Number of mesh instances culled together, by a single job on large scenes
+	static constexpr size_t CULLING_BATCH_SIZE = 1024;
+
+	/// Name of the storage buffer of the model matrices in the vertex shader, when INSTANCED is defined
+	static constexpr const char *INSTANCE_DATA_NAME = "InstanceData";
+
 	/**
 	 * @brief Constructs a subpass for the geometry pass of Deferred rendering
 	 * @param render_context Render context
@@ -76,6 +107,9 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 
 	virtual ~GeometrySubpass() = default;
 
+	/**
+	 * @brief Builds the shader variants of the scene, and discards the draw packets
+	 */
 	virtual void prepare() override;
 
 	/**
@@ -83,31 +117,177 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 	 */
 	virtual void draw(CommandBuffer &command_buffer) override;
 
+	/**
+	 * @brief Sorts the draws and splits the opaque ones in chunks of similar size
+	 *        The transparent objects are all drawn by the last chunk, after the opaque ones
+	 */
+	virtual uint32_t prepare_draw_chunks(uint32_t max_chunk_count) override;
+
+	virtual void draw_chunk(CommandBuffer &command_buffer, uint32_t chunk_index, size_t thread_index) override;
+
 	/**
 	 * @brief Thread index to use for allocating resources
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Enables or disables view frustum culling, it is enabled by default
+	 */
+	void set_frustum_culling(bool enabled);
+
+	/**
+	 * @brief Enables or disables drawing the instances of a submesh together, it is enabled by default
+	 *        Must not be called while recording
+	 */
+	void set_instancing(bool enabled);
+
+	/**
+	 * @brief Discards the draw packets so that they are built again, must not be called while recording
+	 *        Needed when prepare_pipeline_layout would now return other layouts
+	 */
+	void invalidate_draw_packets();
+
   protected:
+	/**
+	 * @brief Resources of a submesh resolved for this subpass, which do not change from frame to frame
+	 */
+	struct DrawPacket
+	{
+		struct VertexBufferBinding
+		{
+			uint32_t location;
+
+			std::vector<std::reference_wrapper<const core::BufferC>> buffers;
+
+			std::vector<VkDeviceSize> offsets;
+		};
+
+		struct ImageBinding
+		{
+			const core::ImageView *image_view;
+
+			const core::Sampler *sampler;
+
+			uint32_t binding;
+		};
+
+		/// Material, textures and shader variant of the submesh the packet is built for, it is replaced if they change
+		const sg::Material *material{nullptr};
+
+		size_t textures_hash{0};
+
+		size_t variant_id{0};
+
+		/// The material as a PBR material, nullptr if it is not one
+		const sg::PBRMaterial *pbr_material{nullptr};
+
+		/// Push constants of the material, its factors are copied again before each frame
+		PBRMaterialUniform material_uniform{};
+
+		/// Shader variant the packet is built with, the one of the submesh with INSTANCED defined for instanced draws
+		ShaderVariant variant;
+
+		/// The packet is built by the first thread drawing the submesh
+		std::once_flag built;
+
+		PipelineLayout *pipeline_layout{nullptr};
+
+		/// Whether the pipeline layout has a push constant range for the material
+		bool has_push_constants{false};
+
+		VertexInputState vertex_input_state;
+
+		std::vector<VertexBufferBinding> vertex_buffer_bindings;
+
+		std::vector<ImageBinding> image_bindings;
+
+		/// Binding of the InstanceData storage buffer in set 0, ~0u if the shaders do not declare it
+		uint32_t instance_data_binding{~0u};
+	};
+
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
+	/**
+	 * @brief Draws a submesh with its draw packet if it was created before recording, or resolves its resources otherwise
+	 */
 	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
 
+	/**
+	 * @brief Draws instances of a submesh with a single instanced draw, using its instanced draw packet
+	 * @param command_buffer The command buffer to record into
+	 * @param begin Index of the first instance in sorted_opaque_nodes, the instances follow
+	 * @param count Number of instances
+	 * @param front_face Front face of all the instances
+	 * @param thread_index Thread index to use for allocating resources
+	 * @return False if nothing was drawn as the shaders do not support instancing
+	 */
+	bool draw_instances(CommandBuffer &command_buffer, size_t begin, size_t count, VkFrontFace front_face, size_t thread_index);
+
+	/**
+	 * @brief Creates the draw packet of a submesh, or replaces it if its material, the textures of its material
+	 *        or its shader variant changed. Its resources are resolved by the first draw
+	 * @param sub_mesh The submesh to draw
+	 * @param instanced Whether the packet is the one for instanced draws
+	 */
+	void update_draw_packet(sg::SubMesh &sub_mesh, bool instanced = false);
+
+	/**
+	 * @brief Resolves the resources of a submesh into a draw packet
+	 */
+	void build_draw_packet(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawPacket &packet);
+
+	void draw_packet(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawPacket &packet);
+
+	/**
+	 * @brief Binds the resources of a draw packet, without drawing
+	 */
+	void bind_draw_packet(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, DrawPacket &packet);
+
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
 
 	virtual PipelineLayout &prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules);
 
-	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
+	/**
+	 * @brief Pushes the constants of a draw, by default the material uniform of its draw packet
+	 *        Only called if the pipeline layout has a push constant range for the material
+	 */
+	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, const DrawPacket &packet);
 
-	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
+	/**
+	 * @brief Records the draw of a submesh once its resources are bound, for single and instanced draws
+	 * @param command_buffer The command buffer to record into
+	 * @param sub_mesh The submesh to draw
+	 * @param instance_count Number of instances, more than one for the instanced draws of draw_instances
+	 */
+	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, uint32_t instance_count = 1);
 
 	/**
 	 * @brief Sorts objects based on distance from camera and classifies them
 	 *        into opaque and transparent in the arrays provided
+	 *        GeometrySubpass itself uses sort_draws, which does not allocate once warmed up
+	 *        Also updates the draw packets of the submeshes
 	 */
 	void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
 	                      std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
 
+	/**
+	 * @brief Sorts the visible objects into sorted_opaque_nodes and sorted_transparent_nodes
+	 *        Also updates the draw packets of the sorted submeshes, and groups the opaque instances drawn together
+	 *        The draws are ordered by the keys of DrawList
+	 */
+	void sort_draws();
+
+	/**
+	 * @brief Assigns dense ids to the shader variants, materials and submeshes, used in the sort keys
+	 */
+	void prepare_draw_state_ids();
+
+	/**
+	 * @brief Collects the instances of the meshes, computes their world bounds and tests them against the frustum
+	 *        Large scenes are processed in batches on the job system
+	 */
+	void cull_instances();
+
 	sg::Camera &camera;
 
 	std::vector<sg::Mesh *> meshes;
@@ -117,6 +297,62 @@ class GeometrySubpass : public vkb::rendering::SubpassC
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+	/// Opaque objects of the frame, ordered by state then front-to-back
+	std::vector<std::pair<sg::Node *, sg::SubMesh *>> sorted_opaque_nodes;
+
+	/// Transparent objects of the frame in back-to-front order
+	std::vector<std::pair<sg::Node *, sg::SubMesh *>> sorted_transparent_nodes;
+
+	/// Start of each group of sorted_opaque_nodes drawn together, followed by the number of opaque nodes
+	std::vector<size_t> draw_group_offsets;
+
+	/// Range of groups drawn by each chunk, chunk i draws the groups [offsets[i], offsets[i + 1])
+	std::vector<size_t> draw_chunk_offsets;
+
+	bool frustum_culling{true};
+
+	bool instancing{true};
+
+	/// Whether the vertex shader declares InstanceData, instanced variants are only built if it does
+	bool instance_data_declared{false};
+
+	Frustum frustum;
+
+	struct CullingInstance
+	{
+		sg::Node *node;
+
+		sg::Mesh *mesh;
+
+		/// Index of the mesh in meshes
+		uint32_t mesh_index;
+	};
+
+	/// Each instance of a mesh in the scene, gathered each frame
+	std::vector<CullingInstance> culling_instances;
+
+	std::vector<glm::mat4> culling_world_matrices;
+
+	/// World bounds of each instance
+	BoxArray culling_bounds;
+
+	/// 1 if the instance is visible, 0 otherwise
+	std::vector<uint8_t> culling_visibility;
+
+	/// Shader variant, material and submesh id of each submesh of each mesh, in place in the sort keys
+	std::vector<std::vector<uint64_t>> draw_state_ids;
+
+	DrawList draw_list;
+
+	/// Draws the entries of the draw list refer to
+	std::vector<std::pair<sg::Node *, sg::SubMesh *>> draw_list_items;
+
+	/// Only modified before recording, so that recording threads can look packets up without locking
+	std::unordered_map<const sg::SubMesh *, std::unique_ptr<DrawPacket>> draw_packets;
+
+	/// Draw packets of the submeshes drawn with instanced draws
+	std::unordered_map<const sg::SubMesh *, std::unique_ptr<DrawPacket>> instanced_draw_packets;
 };
 
 }        // namespace vkb
@@ -45,7 +45,9 @@ class HPPForwardSubpass : public vkb::ForwardSubpass
 	                        std::forward<ShaderSource>(fragment_shader),
 	                        reinterpret_cast<vkb::sg::Scene &>(scene),
 	                        camera)
-	{}
+	{
+		set_draw_chunks_type(typeid(HPPForwardSubpass));
+	}
 };
 
 }        // namespace subpasses
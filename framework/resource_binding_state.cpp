@@ -17,12 +17,37 @@
 
 #include "resource_binding_state.h"
 
+#include "common/helpers.h"
+
 namespace vkb
 {
+namespace
+{
+size_t hash_resource_info(const ResourceInfo &resource_info, uint32_t binding, uint32_t array_element)
+{
+	if (resource_info.buffer == nullptr && resource_info.image_view == nullptr && resource_info.sampler == nullptr)
+	{
+		return 0;
+	}
+
+	// Buffer offsets are left out, as dynamic offsets do not change the descriptor set
+	size_t result = 0;
+	hash_combine(result, binding);
+	hash_combine(result, array_element);
+	hash_combine(result, resource_info.buffer ? resource_info.buffer->get_handle() : VK_NULL_HANDLE);
+	hash_combine(result, resource_info.range);
+	hash_combine(result, resource_info.image_view ? resource_info.image_view->get_handle() : VK_NULL_HANDLE);
+	hash_combine(result, resource_info.sampler ? resource_info.sampler->get_handle() : VK_NULL_HANDLE);
+	return result;
+}
+}        // namespace
+
 void ResourceBindingState::reset()
 {
 	clear_dirty();
 
+	resource_sets.for_each([](uint32_t, ResourceSet &resource_set) { resource_set.reset(); });
+
 	resource_sets.clear();
 }
 
@@ -41,35 +66,44 @@ void ResourceBindingState::clear_dirty(uint32_t set)
 	resource_sets[set].clear_dirty();
 }
 
+void ResourceBindingState::set_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set)
+{
+	resource_sets[set].set_descriptor_set(descriptor_set);
+}
+
 void ResourceBindingState::bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_buffer(buffer, offset, range, binding, array_element);
+	auto &resource_set = resource_sets[set];
+	resource_set.bind_buffer(buffer, offset, range, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, sampler, binding, array_element);
+	auto &resource_set = resource_sets[set];
+	resource_set.bind_image(image_view, sampler, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
 void ResourceBindingState::bind_image(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_image(image_view, binding, array_element);
+	auto &resource_set = resource_sets[set];
+	resource_set.bind_image(image_view, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
 void ResourceBindingState::bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	resource_sets[set].bind_input(image_view, binding, array_element);
+	auto &resource_set = resource_sets[set];
+	resource_set.bind_input(image_view, binding, array_element);
 
-	dirty = true;
+	dirty |= resource_set.is_dirty();
 }
 
-const std::unordered_map<uint32_t, ResourceSet> &ResourceBindingState::get_resource_sets()
+const BindingTable<ResourceSet, ResourceBindingState::MAX_SETS> &ResourceBindingState::get_resource_sets()
 {
 	return resource_sets;
 }
@@ -78,7 +112,13 @@ void ResourceSet::reset()
 {
 	clear_dirty();
 
+	// Keep the capacity so that binding resources again does not allocate
+	resource_bindings.for_each([](uint32_t, std::vector<ResourceInfo> &binding_resources) { binding_resources.clear(); });
+
 	resource_bindings.clear();
+
+	hash           = 0;
+	descriptor_set = VK_NULL_HANDLE;
 }
 
 bool ResourceSet::is_dirty() const
@@ -86,55 +126,130 @@ bool ResourceSet::is_dirty() const
 	return dirty;
 }
 
+bool ResourceSet::is_offset_only_dirty() const
+{
+	return dirty && offset_only_dirty;
+}
+
 void ResourceSet::clear_dirty()
 {
-	dirty = false;
+	dirty             = false;
+	offset_only_dirty = false;
+
+	resource_bindings.for_each([](uint32_t, std::vector<ResourceInfo> &binding_resources) {
+		for (auto &resource_info : binding_resources)
+		{
+			resource_info.dirty = false;
+		}
+	});
 }
 
 void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty = false;
+	auto binding_resources = resource_bindings.find(binding);
+
+	assert(binding_resources && array_element < binding_resources->size());
+
+	(*binding_resources)[array_element].dirty = false;
 }
 
 void ResourceSet::bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty  = true;
-	resource_bindings[binding][array_element].buffer = &buffer;
-	resource_bindings[binding][array_element].offset = offset;
-	resource_bindings[binding][array_element].range  = range;
+	ResourceInfo resource_info = get_resource_info(binding, array_element);
 
-	dirty = true;
+	resource_info.buffer = &buffer;
+	resource_info.offset = offset;
+	resource_info.range  = range;
+
+	update_resource_info(resource_info, binding, array_element);
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = &sampler;
+	ResourceInfo resource_info = get_resource_info(binding, array_element);
 
-	dirty = true;
+	resource_info.image_view = &image_view;
+	resource_info.sampler    = &sampler;
+
+	update_resource_info(resource_info, binding, array_element);
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = nullptr;
+	ResourceInfo resource_info = get_resource_info(binding, array_element);
 
-	dirty = true;
+	resource_info.image_view = &image_view;
+	resource_info.sampler    = nullptr;
+
+	update_resource_info(resource_info, binding, array_element);
 }
 
 void ResourceSet::bind_input(const core::ImageView &image_view, const uint32_t binding, const uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
+	ResourceInfo resource_info = get_resource_info(binding, array_element);
 
-	dirty = true;
+	resource_info.image_view = &image_view;
+
+	update_resource_info(resource_info, binding, array_element);
 }
 
-const BindingMap<ResourceInfo> &ResourceSet::get_resource_bindings() const
+const BindingTable<std::vector<ResourceInfo>, ResourceSet::MAX_BINDINGS> &ResourceSet::get_resource_bindings() const
 {
 	return resource_bindings;
 }
 
+size_t ResourceSet::get_hash() const
+{
+	return hash;
+}
+
+VkDescriptorSet ResourceSet::get_descriptor_set() const
+{
+	return descriptor_set;
+}
+
+void ResourceSet::set_descriptor_set(VkDescriptorSet descriptor_set_)
+{
+	descriptor_set = descriptor_set_;
+}
+
+ResourceInfo &ResourceSet::get_resource_info(uint32_t binding, uint32_t array_element)
+{
+	auto &binding_resources = resource_bindings[binding];
+
+	if (array_element >= binding_resources.size())
+	{
+		binding_resources.resize(array_element + 1);
+	}
+
+	return binding_resources[array_element];
+}
+
+void ResourceSet::update_resource_info(const ResourceInfo &new_resource_info, uint32_t binding, uint32_t array_element)
+{
+	auto &resource_info = resource_bindings[binding][array_element];
+
+	bool same_resources = resource_info.buffer == new_resource_info.buffer &&
+	                      resource_info.range == new_resource_info.range &&
+	                      resource_info.image_view == new_resource_info.image_view &&
+	                      resource_info.sampler == new_resource_info.sampler;
+
+	if (same_resources && resource_info.offset == new_resource_info.offset)
+	{
+		// Binding the same resources again does not require a new descriptor set
+		return;
+	}
+
+	// The hash is a XOR of the hash of each resource info, so that one can be replaced without walking the others
+	hash ^= hash_resource_info(resource_info, binding, array_element);
+	hash ^= hash_resource_info(new_resource_info, binding, array_element);
+
+	resource_info       = new_resource_info;
+	resource_info.dirty = true;
+
+	// Only offsets changed if this holds for every change since the dirty flags were cleared
+	offset_only_dirty = (dirty ? offset_only_dirty : true) && same_resources;
+
+	dirty = true;
+}
 }        // namespace vkb
@@ -17,10 +17,13 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/vk_common.h"
 #include "core/buffer.h"
 #include "core/image_view.h"
 #include "core/sampler.h"
+#include "core/util/binding_table.hpp"
 
 namespace vkb
 {
@@ -48,15 +51,28 @@ struct ResourceInfo
  * @brief A resource set is a set of bindings containing resources that were bound
  *        by a command buffer.
  *
- * The ResourceSet has a one to one mapping with a DescriptorSet.
+ * The ResourceSet has a one to one mapping with a DescriptorSet. Bindings are stored in a
+ * BindingTable, each holding the resources bound to its array elements. A hash of the bound resources is kept up to date as resources are bound, so that the matching
+ * descriptor set can be looked up without walking the bindings again.
  */
 class ResourceSet
 {
   public:
+	/// Number of bindings tracked without hashing, larger bindings fall back to a map
+	static constexpr uint32_t MAX_BINDINGS = 32;
+
 	void reset();
 
 	bool is_dirty() const;
 
+	/**
+	 * @brief Checks whether the only changes since the dirty flags were cleared are buffer offsets
+	 *
+	 * If these offsets belong to dynamic buffer bindings, the descriptor set previously built from
+	 * this resource set can be bound again with new dynamic offsets.
+	 */
+	bool is_offset_only_dirty() const;
+
 	void clear_dirty();
 
 	void clear_dirty(uint32_t binding, uint32_t array_element);
@@ -69,12 +85,44 @@ class ResourceSet
 
 	void bind_input(const core::ImageView &image_view, uint32_t binding, uint32_t array_element);
 
-	const BindingMap<ResourceInfo> &get_resource_bindings() const;
+	/**
+	 * @return The resources bound to each array element, for each binding which has resources bound to it
+	 */
+	const BindingTable<std::vector<ResourceInfo>, MAX_BINDINGS> &get_resource_bindings() const;
+
+	/**
+	 * @return A hash of the bound resources, excluding buffer offsets
+	 */
+	size_t get_hash() const;
+
+	/**
+	 * @return The descriptor set last bound for this resource set, or VK_NULL_HANDLE
+	 */
+	VkDescriptorSet get_descriptor_set() const;
+
+	void set_descriptor_set(VkDescriptorSet descriptor_set);
 
   private:
+	/**
+	 * @brief Gets the resource info of a binding array element, growing the binding if needed
+	 */
+	ResourceInfo &get_resource_info(uint32_t binding, uint32_t array_element);
+
+	/**
+	 * @brief Replaces the resource info of a binding array element, updating the hash and dirty flags
+	 *        Nothing is marked dirty if the resources did not change
+	 */
+	void update_resource_info(const ResourceInfo &new_resource_info, uint32_t binding, uint32_t array_element);
+
 	bool dirty{false};
 
-	BindingMap<ResourceInfo> resource_bindings;
+	bool offset_only_dirty{false};
+
+	size_t hash{0};
+
+	VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
+
+	BindingTable<std::vector<ResourceInfo>, MAX_BINDINGS> resource_bindings;
 };
 
 /**
@@ -86,6 +134,9 @@ class ResourceSet
 class ResourceBindingState
 {
   public:
+	/// Number of descriptor sets tracked without hashing, larger sets fall back to a map
+	static constexpr uint32_t MAX_SETS = 8;
+
 	void reset();
 
 	bool is_dirty();
@@ -94,6 +145,8 @@ class ResourceBindingState
 
 	void clear_dirty(uint32_t set);
 
+	void set_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set);
+
 	void bind_buffer(const vkb::core::BufferC &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
 
 	void bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element);
@@ -102,11 +155,11 @@ class ResourceBindingState
 
 	void bind_input(const core::ImageView &image_view, uint32_t set, uint32_t binding, uint32_t array_element);
 
-	const std::unordered_map<uint32_t, ResourceSet> &get_resource_sets();
+	const BindingTable<ResourceSet, MAX_SETS> &get_resource_sets();
 
   private:
 	bool dirty{false};
 
-	std::unordered_map<uint32_t, ResourceSet> resource_sets;
+	BindingTable<ResourceSet, MAX_SETS> resource_sets;
 };
 }        // namespace vkb
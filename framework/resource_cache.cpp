@@ -24,15 +24,273 @@ namespace vkb
 {
 namespace
 {
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start)
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * @brief Sets the concurrent mode of a cache back to a previous value when it goes out of scope
+ */
+struct ConcurrentModeRestorer
+{
+	ResourceCache &resource_cache;
+
+	bool previous_mode;
+
+	~ConcurrentModeRestorer()
+	{
+		resource_cache.set_concurrent_mode(previous_mode);
+	}
+};
+
+void add_build_time(ResourceCacheCounters &counters, uint64_t build_time)
+{
+	counters.build_time += build_time;
+
+	uint64_t max_build_time = counters.max_build_time;
+	while (build_time > max_build_time && !counters.max_build_time.compare_exchange_weak(max_build_time, build_time))
+	{
+	}
+}
+
+/**
+ * @brief Locks the mutex of a resource type, measuring the time spent waiting for it
+ */
+template <class L>
+L lock_sync(ResourceCacheSync &sync)
+{
+	// Only read the clock if the lock is contended
+	L guard(sync.mutex, std::try_to_lock);
+
+	if (!guard.owns_lock())
+	{
+		auto wait_start = std::chrono::steady_clock::now();
+		guard.lock();
+		sync.counters.lock_wait_time += elapsed_ns(wait_start);
+	}
+
+	return guard;
+}
+
+/**
+ * @brief Looks up an object or builds it, the caller must hold the unique lock of its type
+ *        The recorder is shared by all the types, so it is only written under its own mutex
+ */
+template <class T, class... A>
+T &request_resource_locked(Device &device, ResourceRecord &recorder, std::mutex &recorder_mutex, ResourceCacheSync &sync, std::unordered_map<std::size_t, T> &resources, std::size_t hash, A &... args)
+{
+	sync.counters.lookups++;
+
+	auto res_it = resources.find(hash);
+
+	if (res_it != resources.end())
+	{
+		sync.counters.hits++;
+		return res_it->second;
+	}
+
+	sync.counters.misses++;
+
+	auto build_start = std::chrono::steady_clock::now();
+
+	auto &res = request_resource_with_hash(device, nullptr, resources, hash, args...);
+
+	add_build_time(sync.counters, elapsed_ns(build_start));
+
+	{
+		std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+
+		RecordHelper<T, A...> record_helper;
+
+		size_t index = record_helper.record(recorder, args...);
+		record_helper.index(recorder, index, res);
+	}
+
+	return res;
+}
+
+template <class T, class... A>
+T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &recorder_mutex, ResourceCacheSync &sync, std::unordered_map<std::size_t, T> &resources, A &... args)
+{
+	std::size_t hash{0U};
+	hash_param(hash, args...);
+
+	auto guard = lock_sync<std::unique_lock<std::shared_mutex>>(sync);
+
+	return request_resource_locked(device, recorder, recorder_mutex, sync, resources, hash, args...);
+}
+
 template <class T, class... A>
-T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &... args)
+T &request_tracked_resource(Device &device, ResourceRecord &recorder, std::mutex &recorder_mutex, ResourceCacheSync &sync, ResourceCacheLru &lru, uint64_t frame, std::unordered_map<std::size_t, T> &resources, A &... args)
 {
-	std::lock_guard<std::mutex> guard(resource_mutex);
+	std::size_t hash{0U};
+	hash_param(hash, args...);
 
-	auto &res = request_resource(device, &recorder, resources, args...);
+	auto guard = lock_sync<std::unique_lock<std::shared_mutex>>(sync);
+
+	auto &res = request_resource_locked(device, recorder, recorder_mutex, sync, resources, hash, args...);
+
+	// Stamped even without a capacity, so that setting one later does not evict objects still in use
+	lru.last_used[hash] = frame;
 
 	return res;
 }
+
+/**
+ * @brief Evicts the least recently used objects exceeding the capacity, among those not used after the completed frame
+ * @param is_evictable Function returning false for objects which must stay in the cache
+ * @param release Function called on each object before it is destroyed
+ */
+template <class T, class P, class F>
+void evict_resources(ResourceCacheLru &lru, std::unordered_map<std::size_t, T> &resources, uint64_t completed_frame, P is_evictable, F release)
+{
+	if (lru.capacity == 0 || resources.size() <= lru.capacity)
+	{
+		return;
+	}
+
+	// (last used frame, hash) of the objects which are no longer in flight
+	std::vector<std::pair<uint64_t, std::size_t>> candidates;
+	candidates.reserve(resources.size());
+
+	for (auto &res_it : resources)
+	{
+		// Objects requested before a capacity was set have no known last use, they may still be in flight
+		auto used_it = lru.last_used.find(res_it.first);
+		if (used_it != lru.last_used.end() && used_it->second <= completed_frame && is_evictable(res_it->second))
+		{
+			candidates.emplace_back(used_it->second, res_it.first);
+		}
+	}
+
+	size_t evict_count = std::min(resources.size() - lru.capacity, candidates.size());
+
+	// Only the oldest candidates need to be ordered
+	std::nth_element(candidates.begin(), candidates.begin() + evict_count, candidates.end());
+
+	for (size_t i = 0; i < evict_count; ++i)
+	{
+		auto res_it = resources.find(candidates[i].second);
+
+		release(res_it->second);
+
+		resources.erase(res_it);
+		lru.last_used.erase(candidates[i].second);
+	}
+
+	lru.eviction_count += evict_count;
+}
+
+template <class T, class... A>
+T &request_resource_concurrent(Device &device, ResourceRecord &recorder, std::mutex &recorder_mutex, ResourceCacheSync &sync, std::unordered_map<std::size_t, T> &resources, A &... args)
+{
+	RecordHelper<T, A...> record_helper;
+
+	std::size_t hash{0U};
+	hash_param(hash, args...);
+
+	sync.counters.lookups++;
+
+	while (true)
+	{
+		{
+			auto guard = lock_sync<std::shared_lock<std::shared_mutex>>(sync);
+
+			auto res_it = resources.find(hash);
+
+			if (res_it != resources.end())
+			{
+				sync.counters.hits++;
+				return res_it->second;
+			}
+		}
+
+		std::promise<void>       built;
+		std::shared_future<void> pending;
+
+		{
+			auto guard = lock_sync<std::unique_lock<std::shared_mutex>>(sync);
+
+			// Another thread may have published or started building the object in the meantime
+			auto res_it = resources.find(hash);
+
+			if (res_it != resources.end())
+			{
+				sync.counters.hits++;
+				return res_it->second;
+			}
+
+			auto pending_it = sync.pending.find(hash);
+
+			if (pending_it != sync.pending.end())
+			{
+				pending = pending_it->second;
+			}
+			else
+			{
+				sync.pending.emplace(hash, built.get_future().share());
+			}
+		}
+
+		if (pending.valid())
+		{
+			// Wait for the thread building this object, then look it up again.
+			// If that build failed the lookup misses and this thread tries to build it itself.
+			// Waiting for the object is accounted as waiting for the lock of its key
+			auto wait_start = std::chrono::steady_clock::now();
+			pending.wait();
+			sync.counters.lock_wait_time += elapsed_ns(wait_start);
+			continue;
+		}
+
+		sync.counters.misses++;
+
+		const char *res_type = typeid(T).name();
+
+		LOGD("Building cache object ({}) concurrently", res_type);
+
+		try
+		{
+			auto build_start = std::chrono::steady_clock::now();
+
+			T resource(device, args...);
+
+			add_build_time(sync.counters, elapsed_ns(build_start));
+
+			auto guard = lock_sync<std::unique_lock<std::shared_mutex>>(sync);
+
+			auto &res = resources.emplace(hash, std::move(resource)).first->second;
+
+			// Record before publishing, objects depending on this one expect it to be indexed already
+			{
+				std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+
+				size_t index = record_helper.record(recorder, args...);
+				record_helper.index(recorder, index, res);
+			}
+
+			sync.pending.erase(hash);
+			guard.unlock();
+
+			built.set_value();
+
+			return res;
+		}
+		catch (...)
+		{
+			{
+				std::unique_lock<std::shared_mutex> guard(sync.mutex);
+				sync.pending.erase(hash);
+			}
+
+			built.set_value();
+
+			LOGE("Creation error for cache object ({})", res_type);
+			throw;
+		}
+	}
+}
 }        // namespace
 
 ResourceCache::ResourceCache(Device &device) :
@@ -40,16 +298,77 @@ ResourceCache::ResourceCache(Device &device) :
 {
 }
 
-void ResourceCache::warmup(const std::vector<uint8_t> &data)
+ResourceCache::~ResourceCache()
 {
-	recorder.set_data(data);
+	// Wait for the background work before destroying the objects it refers to
+	wait_for_warmup();
 
-	replayer.play(*this, recorder);
+	wait_for_pipeline_compiles();
+}
+
+void ResourceCache::warmup(const std::vector<uint8_t> &data, bool parallel)
+{
+	if (data.empty())
+	{
+		return;
+	}
+
+	std::vector<uint8_t> body;
+
+	if (!ResourceRecord::validate_data(data, ResourceRecordHeader{device.get_gpu().get_properties()}, body))
+	{
+		LOGW("Resource cache data was recorded with another device, driver or schema version, skipping warm-up");
+		return;
+	}
+
+	ConcurrentModeRestorer restorer{*this, is_concurrent_mode()};
+
+	if (parallel)
+	{
+		set_concurrent_mode(true);
+	}
+
+	// Objects are recorded again as they are created
+	replayer.play(*this, body, parallel);
+}
+
+void ResourceCache::warmup_async(const std::vector<uint8_t> &data, bool parallel)
+{
+	wait_for_warmup();
+
+	bool previous_mode = is_concurrent_mode();
+
+	// The render loop requests objects while they are being created
+	set_concurrent_mode(true);
+
+	warmup_future = std::async(std::launch::async, [this, data, parallel, previous_mode]() {
+		ConcurrentModeRestorer restorer{*this, previous_mode};
+		warmup(data, parallel);
+	});
+}
+
+void ResourceCache::wait_for_warmup()
+{
+	if (!warmup_future.valid())
+	{
+		return;
+	}
+
+	try
+	{
+		warmup_future.get();
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("Resource cache warm-up failed: {}", e.what());
+	}
 }
 
 std::vector<uint8_t> ResourceCache::serialize()
 {
-	return recorder.get_data();
+	std::lock_guard<std::mutex> guard(recorder_mutex);
+
+	return recorder.get_data(ResourceRecordHeader{device.get_gpu().get_properties()});
 }
 
 void ResourceCache::set_pipeline_cache(VkPipelineCache new_pipeline_cache)
@@ -57,54 +376,368 @@ void ResourceCache::set_pipeline_cache(VkPipelineCache new_pipeline_cache)
 	pipeline_cache = new_pipeline_cache;
 }
 
+void ResourceCache::set_concurrent_mode(bool concurrent)
+{
+	concurrent_mode = concurrent;
+}
+
+bool ResourceCache::is_concurrent_mode() const
+{
+	return concurrent_mode;
+}
+
+void ResourceCache::set_async_graphics_pipelines(bool enabled, FallbackPipelineFunc fallback)
+{
+	async_graphics_pipelines = enabled;
+	fallback_pipeline_func   = std::move(fallback);
+}
+
+bool ResourceCache::is_async_graphics_pipelines() const
+{
+	return async_graphics_pipelines;
+}
+
+GraphicsPipeline *ResourceCache::request_graphics_pipeline_async(PipelineState &pipeline_state)
+{
+	assert(async_graphics_pipelines && "Asynchronous graphics pipelines must be enabled first");
+
+	std::size_t hash{0U};
+	hash_param(hash, pipeline_cache, pipeline_state);
+
+	{
+		auto guard = lock_sync<std::shared_lock<std::shared_mutex>>(graphics_pipeline_sync);
+
+		auto res_it = state.graphics_pipelines.find(hash);
+
+		if (res_it != state.graphics_pipelines.end())
+		{
+			// Misses are counted by the compile job
+			graphics_pipeline_sync.counters.lookups++;
+			graphics_pipeline_sync.counters.hits++;
+			return &res_it->second;
+		}
+	}
+
+	std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+
+	if (failed_pipelines.count(hash) > 0 || !pending_pipelines.insert(hash).second)
+	{
+		return nullptr;
+	}
+
+	LOGD("Scheduling asynchronous compilation of graphics pipeline {:X}", hash);
+
+	auto &job_system = JobSystem::get();
+
+	pipeline_compile_jobs.erase(std::remove_if(pipeline_compile_jobs.begin(), pipeline_compile_jobs.end(),
+	                                           [&job_system](const JobSystem::JobHandle &job) { return job_system.is_complete(job); }),
+	                            pipeline_compile_jobs.end());
+
+	// The job owns a copy of the state, as the recording thread keeps modifying its own.
+	// Compiles run in the background so that they never delay the jobs of the frame
+	pipeline_compile_jobs.push_back(job_system.schedule_background([this, hash, pipeline_state]() mutable {
+		VkPipelineCache compile_pipeline_cache = pipeline_cache;
+		bool            failed                 = false;
+
+		try
+		{
+			request_resource_concurrent(device, recorder, recorder_mutex, graphics_pipeline_sync, state.graphics_pipelines, compile_pipeline_cache, pipeline_state);
+		}
+		catch (const std::exception &e)
+		{
+			LOGE("Asynchronous compilation of graphics pipeline {:X} failed: {}", hash, e.what());
+			failed = true;
+		}
+
+		std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+
+		pending_pipelines.erase(hash);
+
+		if (failed)
+		{
+			failed_pipelines.insert(hash);
+		}
+	}));
+
+	return nullptr;
+}
+
+GraphicsPipeline *ResourceCache::request_fallback_graphics_pipeline(const PipelineState &pipeline_state)
+{
+	return fallback_pipeline_func ? fallback_pipeline_func(pipeline_state) : nullptr;
+}
+
+uint32_t ResourceCache::get_pending_pipeline_count()
+{
+	std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+
+	return to_u32(pending_pipelines.size());
+}
+
+void ResourceCache::wait_for_pipeline_compiles()
+{
+	std::vector<JobSystem::JobHandle> jobs;
+
+	{
+		std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+		jobs.swap(pipeline_compile_jobs);
+	}
+
+	if (jobs.empty())
+	{
+		return;
+	}
+
+	// Compile jobs catch their own errors
+	JobSystem::get().wait(jobs);
+}
+
+void ResourceCache::set_descriptor_set_capacity(size_t capacity)
+{
+	std::unique_lock<std::shared_mutex> guard(descriptor_set_sync.mutex);
+
+	descriptor_set_lru.capacity = capacity;
+}
+
+void ResourceCache::set_framebuffer_capacity(size_t capacity)
+{
+	std::unique_lock<std::shared_mutex> guard(framebuffer_sync.mutex);
+
+	framebuffer_lru.capacity = capacity;
+}
+
+void ResourceCache::begin_frame(uint64_t frame, uint64_t completed_frame)
+{
+	current_frame = frame;
+
+	{
+		std::unique_lock<std::shared_mutex> guard(descriptor_set_sync.mutex);
+
+		// A set from a pool which cannot free it would leak its slot until the pool is reset, so it is kept
+		auto is_evictable = [](DescriptorSet &descriptor_set) {
+			return descriptor_set.get_descriptor_pool().can_free_descriptor_sets();
+		};
+
+		evict_resources(descriptor_set_lru, state.descriptor_sets, completed_frame, is_evictable, [](DescriptorSet &descriptor_set) {
+			// The pool does not reclaim the handle when the descriptor set is destroyed
+			descriptor_set.get_descriptor_pool().free(descriptor_set.get_handle());
+		});
+	}
+
+	{
+		std::unique_lock<std::shared_mutex> guard(framebuffer_sync.mutex);
+
+		evict_resources(
+		    framebuffer_lru, state.framebuffers, completed_frame, [](Framebuffer &) { return true; }, [](Framebuffer &) {});
+	}
+}
+
+ResourceCacheEvictionStats ResourceCache::get_descriptor_set_eviction_stats()
+{
+	std::shared_lock<std::shared_mutex> guard(descriptor_set_sync.mutex);
+
+	return {state.descriptor_sets.size(), descriptor_set_lru.capacity, descriptor_set_lru.eviction_count};
+}
+
+ResourceCacheEvictionStats ResourceCache::get_framebuffer_eviction_stats()
+{
+	std::shared_lock<std::shared_mutex> guard(framebuffer_sync.mutex);
+
+	return {state.framebuffers.size(), framebuffer_lru.capacity, framebuffer_lru.eviction_count};
+}
+
+ResourceCacheStats ResourceCache::get_stats(ResourceCacheType type)
+{
+	auto &counters = get_sync(type).counters;
+
+	ResourceCacheStats stats;
+
+	stats.lookups        = counters.lookups;
+	stats.hits           = counters.hits;
+	stats.misses         = counters.misses;
+	stats.build_time     = std::chrono::nanoseconds{counters.build_time};
+	stats.max_build_time = std::chrono::nanoseconds{counters.max_build_time};
+	stats.lock_wait_time = std::chrono::nanoseconds{counters.lock_wait_time};
+
+	return stats;
+}
+
+ResourceCacheStats ResourceCache::get_total_stats()
+{
+	ResourceCacheStats total;
+
+	for (auto type : {ResourceCacheType::ShaderModule,
+	                  ResourceCacheType::PipelineLayout,
+	                  ResourceCacheType::DescriptorSetLayout,
+	                  ResourceCacheType::RenderPass,
+	                  ResourceCacheType::GraphicsPipeline,
+	                  ResourceCacheType::ComputePipeline,
+	                  ResourceCacheType::DescriptorSet,
+	                  ResourceCacheType::Framebuffer})
+	{
+		auto stats = get_stats(type);
+
+		total.lookups += stats.lookups;
+		total.hits += stats.hits;
+		total.misses += stats.misses;
+		total.build_time += stats.build_time;
+		total.max_build_time = std::max(total.max_build_time, stats.max_build_time);
+		total.lock_wait_time += stats.lock_wait_time;
+	}
+
+	return total;
+}
+
+void ResourceCache::reset_stats()
+{
+	for (auto *sync : {&shader_module_sync,
+	                   &pipeline_layout_sync,
+	                   &descriptor_set_layout_sync,
+	                   &render_pass_sync,
+	                   &graphics_pipeline_sync,
+	                   &compute_pipeline_sync,
+	                   &descriptor_set_sync,
+	                   &framebuffer_sync})
+	{
+		sync->counters.lookups        = 0;
+		sync->counters.hits           = 0;
+		sync->counters.misses         = 0;
+		sync->counters.build_time     = 0;
+		sync->counters.max_build_time = 0;
+		sync->counters.lock_wait_time = 0;
+	}
+}
+
 ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant)
 {
 	std::string entry_point{"main"};
-	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
+
+	if (concurrent_mode)
+	{
+		return request_resource_concurrent(device, recorder, recorder_mutex, shader_module_sync, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, shader_module_sync, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
 }
 
 PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
-	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
+	if (concurrent_mode)
+	{
+		return request_resource_concurrent(device, recorder, recorder_mutex, pipeline_layout_sync, state.pipeline_layouts, shader_modules);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, pipeline_layout_sync, state.pipeline_layouts, shader_modules);
 }
 
 DescriptorSetLayout &ResourceCache::request_descriptor_set_layout(const uint32_t                     set_index,
                                                                   const std::vector<ShaderModule *> &shader_modules,
                                                                   const std::vector<ShaderResource> &set_resources)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	if (concurrent_mode)
+	{
+		return request_resource_concurrent(device, recorder, recorder_mutex, descriptor_set_layout_sync, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, descriptor_set_layout_sync, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
 }
 
 GraphicsPipeline &ResourceCache::request_graphics_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	if (concurrent_mode)
+	{
+		return request_resource_concurrent(device, recorder, recorder_mutex, graphics_pipeline_sync, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, graphics_pipeline_sync, state.graphics_pipelines, pipeline_cache, pipeline_state);
 }
 
 ComputePipeline &ResourceCache::request_compute_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
+	if (concurrent_mode)
+	{
+		return request_resource_concurrent(device, recorder, recorder_mutex, compute_pipeline_sync, state.compute_pipelines, pipeline_cache, pipeline_state);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, compute_pipeline_sync, state.compute_pipelines, pipeline_cache, pipeline_state);
 }
 
 DescriptorSet &ResourceCache::request_descriptor_set(DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
 {
-	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, state.descriptor_pools, descriptor_set_layout);
-	return request_resource(device, recorder, descriptor_set_mutex, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	// Descriptor sets allocate from a shared descriptor pool, so they are always built under the lock
+	uint32_t pool_size = DescriptorPool::MAX_SETS_PER_POOL;
+
+	DescriptorPool *descriptor_pool{nullptr};
+
+	{
+		std::unique_lock<std::shared_mutex> guard(descriptor_set_sync.mutex);
+		std::lock_guard<std::mutex>         recorder_guard(recorder_mutex);
+
+		// Individual sets are only freed when bounded descriptor sets are evicted one by one
+		bool free_descriptor_sets = descriptor_set_lru.capacity > 0;
+
+		std::size_t pool_hash{0U};
+		hash_param(pool_hash, descriptor_set_layout, pool_size, free_descriptor_sets);
+
+		// Pools are not counted, the counters of the type are about descriptor sets
+		descriptor_pool = &request_resource_with_hash(device, &recorder, state.descriptor_pools, pool_hash, descriptor_set_layout, pool_size, free_descriptor_sets);
+	}
+
+	return request_tracked_resource(device, recorder, recorder_mutex, descriptor_set_sync, descriptor_set_lru, current_frame, state.descriptor_sets, descriptor_set_layout, *descriptor_pool, buffer_infos, image_infos);
 }
 
 RenderPass &ResourceCache::request_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses)
 {
-	return request_resource(device, recorder, render_pass_mutex, state.render_passes, attachments, load_store_infos, subpasses);
+	if (concurrent_mode)
+	{
+		return request_resource_concurrent(device, recorder, recorder_mutex, render_pass_sync, state.render_passes, attachments, load_store_infos, subpasses);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, render_pass_sync, state.render_passes, attachments, load_store_infos, subpasses);
 }
 
 Framebuffer &ResourceCache::request_framebuffer(const RenderTarget &render_target, const RenderPass &render_pass)
 {
-	return request_resource(device, recorder, framebuffer_mutex, state.framebuffers, render_target, render_pass);
+	bool bounded{false};
+
+	{
+		std::shared_lock<std::shared_mutex> guard(framebuffer_sync.mutex);
+
+		bounded = framebuffer_lru.capacity > 0;
+	}
+
+	if (bounded)
+	{
+		return request_tracked_resource(device, recorder, recorder_mutex, framebuffer_sync, framebuffer_lru, current_frame, state.framebuffers, render_target, render_pass);
+	}
+
+	if (concurrent_mode)
+	{
+		return request_resource_concurrent(device, recorder, recorder_mutex, framebuffer_sync, state.framebuffers, render_target, render_pass);
+	}
+
+	return request_resource(device, recorder, recorder_mutex, framebuffer_sync, state.framebuffers, render_target, render_pass);
 }
 
 void ResourceCache::clear_pipelines()
 {
-	state.graphics_pipelines.clear();
-	state.compute_pipelines.clear();
+	// Compile jobs insert into the maps
+	wait_for_pipeline_compiles();
+
+	{
+		std::unique_lock<std::shared_mutex> guard(graphics_pipeline_sync.mutex);
+		state.graphics_pipelines.clear();
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(async_pipeline_mutex);
+		failed_pipelines.clear();
+	}
+
+	{
+		std::unique_lock<std::shared_mutex> guard(compute_pipeline_sync.mutex);
+		state.compute_pipelines.clear();
+	}
 }
 
 void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &old_views, const std::vector<core::ImageView> &new_views)
@@ -189,19 +822,34 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 
 		// Add (key, resource) to the cache
 		state.descriptor_sets.emplace(new_key, std::move(descriptor_set));
+
+		// Keep the last use of the descriptor set under its new key
+		auto used_it = descriptor_set_lru.last_used.find(match);
+		if (used_it != descriptor_set_lru.last_used.end())
+		{
+			auto last_used = used_it->second;
+			descriptor_set_lru.last_used.erase(used_it);
+			descriptor_set_lru.last_used[new_key] = last_used;
+		}
 	}
 }
 
 void ResourceCache::clear_framebuffers()
 {
 	state.framebuffers.clear();
+	framebuffer_lru.last_used.clear();
 }
 
 void ResourceCache::clear()
 {
+	// Background jobs create objects until they complete
+	wait_for_warmup();
+	wait_for_pipeline_compiles();
+
 	state.shader_modules.clear();
 	state.pipeline_layouts.clear();
 	state.descriptor_sets.clear();
+	descriptor_set_lru.last_used.clear();
 	state.descriptor_set_layouts.clear();
 	state.render_passes.clear();
 	clear_pipelines();
@@ -212,4 +860,28 @@ const ResourceCacheState &ResourceCache::get_internal_state() const
 {
 	return state;
 }
+
+ResourceCacheSync &ResourceCache::get_sync(ResourceCacheType type)
+{
+	switch (type)
+	{
+		case ResourceCacheType::ShaderModule:
+			return shader_module_sync;
+		case ResourceCacheType::PipelineLayout:
+			return pipeline_layout_sync;
+		case ResourceCacheType::DescriptorSetLayout:
+			return descriptor_set_layout_sync;
+		case ResourceCacheType::RenderPass:
+			return render_pass_sync;
+		case ResourceCacheType::GraphicsPipeline:
+			return graphics_pipeline_sync;
+		case ResourceCacheType::ComputePipeline:
+			return compute_pipeline_sync;
+		case ResourceCacheType::DescriptorSet:
+			return descriptor_set_sync;
+		case ResourceCacheType::Framebuffer:
+		default:
+			return framebuffer_sync;
+	}
+}
 }        // namespace vkb
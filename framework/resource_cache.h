@@ -17,8 +17,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "common/helpers.h"
@@ -27,6 +34,7 @@
 #include "core/descriptor_set_layout.h"
 #include "core/framebuffer.h"
 #include "core/pipeline.h"
+#include "core/util/job_system.hpp"
 #include "resource_record.h"
 #include "resource_replay.h"
 
@@ -64,6 +72,105 @@ struct ResourceCacheState
 	std::unordered_map<std::size_t, Framebuffer> framebuffers;
 };
 
+/**
+ * @brief Types of objects held by the Resource Cache
+ */
+enum class ResourceCacheType
+{
+	ShaderModule,
+	PipelineLayout,
+	DescriptorSetLayout,
+	RenderPass,
+	GraphicsPipeline,
+	ComputePipeline,
+	DescriptorSet,
+	Framebuffer
+};
+
+/**
+ * @brief Counters of the requests for one type of cached resource, updated concurrently
+ */
+struct ResourceCacheCounters
+{
+	std::atomic<uint64_t> lookups{0};
+
+	std::atomic<uint64_t> hits{0};
+
+	std::atomic<uint64_t> misses{0};
+
+	/// Total time spent building objects, in nanoseconds
+	std::atomic<uint64_t> build_time{0};
+
+	/// Longest time spent building a single object, in nanoseconds
+	std::atomic<uint64_t> max_build_time{0};
+
+	/// Total time spent waiting for the lock of the type, in nanoseconds
+	std::atomic<uint64_t> lock_wait_time{0};
+};
+
+/**
+ * @brief Snapshot of the counters of one type of cached resource
+ */
+struct ResourceCacheStats
+{
+	uint64_t lookups{0};
+
+	uint64_t hits{0};
+
+	uint64_t misses{0};
+
+	std::chrono::nanoseconds build_time{0};
+
+	std::chrono::nanoseconds max_build_time{0};
+
+	std::chrono::nanoseconds lock_wait_time{0};
+};
+
+/**
+ * @brief Synchronization state for one type of cached resource
+ *
+ * In concurrent mode lookups only take the shared lock. Objects are built outside of the lock,
+ * and concurrent requests for a key which is being built wait on that key only.
+ */
+struct ResourceCacheSync
+{
+	std::shared_mutex mutex;
+
+	/// Keys of the objects currently being built, signalled once the object is published
+	std::unordered_map<std::size_t, std::shared_future<void>> pending;
+
+	ResourceCacheCounters counters;
+};
+
+/**
+ * @brief Least recently used tracking for one type of cached resource
+ *
+ * Each object remembers the frame it was last requested in. Once there are more objects than
+ * the capacity, the least recently used ones are evicted, provided their last frame completed.
+ */
+struct ResourceCacheLru
+{
+	/// Maximum number of objects kept in the cache, 0 if unbounded
+	size_t capacity{0};
+
+	/// Frame number of the last request of each object, objects missing were last used in frame 0
+	std::unordered_map<std::size_t, uint64_t> last_used;
+
+	size_t eviction_count{0};
+};
+
+/**
+ * @brief Number of objects of a bounded resource type, and how many were evicted so far
+ */
+struct ResourceCacheEvictionStats
+{
+	size_t size{0};
+
+	size_t capacity{0};
+
+	size_t eviction_count{0};
+};
+
 /**
  * @brief Cache all sorts of Vulkan objects specific to a Vulkan device.
  * Supports serialization and deserialization of cached resources.
@@ -74,13 +181,28 @@ struct ResourceCacheState
  * The resource cache is also linked with ResourceRecord and ResourceReplay. Replay can warm-up
  * the cache on app startup by creating all necessary objects.
  * The cache holds pointers to objects and has a mapping from such pointers to hashes.
- * It can only be destroyed in bulk, single elements cannot be removed.
+ * Most objects can only be destroyed in bulk. Descriptor sets and framebuffers can be bounded
+ * instead (see set_descriptor_set_capacity and set_framebuffer_capacity), evicting the least
+ * recently used ones once the frames using them completed (see begin_frame).
+ *
+ * By default every request holds the lock of its resource type while the object is built.
+ * In concurrent mode (see set_concurrent_mode) objects are built outside of the lock, so that
+ * a recording thread building a pipeline does not block the other threads.
+ *
+ * Graphics pipelines can also be compiled asynchronously (see set_async_graphics_pipelines):
+ * requests then return immediately, and the pipeline is built by a background job
+ * which shares the VkPipelineCache.
  */
 class ResourceCache
 {
   public:
+	/// Returns a pipeline to draw with while the one for the given state is compiled, or nullptr to skip the draw
+	using FallbackPipelineFunc = std::function<GraphicsPipeline *(const PipelineState &)>;
+
 	ResourceCache(Device &device);
 
+	~ResourceCache();
+
 	ResourceCache(const ResourceCache &) = delete;
 
 	ResourceCache(ResourceCache &&) = delete;
@@ -89,12 +211,112 @@ class ResourceCache
 
 	ResourceCache &operator=(ResourceCache &&) = delete;
 
-	void warmup(const std::vector<uint8_t> &data);
-
+	/**
+	 * @brief Creates all the objects recorded by a previous run
+	 *        Data recorded with another device, driver or schema version is rejected.
+	 * @param data Serialized resources, as returned by serialize
+	 * @param parallel Whether objects of the same type are created in parallel on the job system,
+	 *                 the cache is then in concurrent mode until the warm-up completes
+	 */
+	void warmup(const std::vector<uint8_t> &data, bool parallel = false);
+
+	/**
+	 * @brief Same as warmup, but runs in the background so that the first frames can render meanwhile
+	 *        The cache is in concurrent mode until the warm-up completes.
+	 */
+	void warmup_async(const std::vector<uint8_t> &data, bool parallel = false);
+
+	/**
+	 * @brief Waits for a background warm-up to complete, if any
+	 */
+	void wait_for_warmup();
+
+	/**
+	 * @return Serialized resources preceded by a header identifying the device, driver and schema version
+	 */
 	std::vector<uint8_t> serialize();
 
 	void set_pipeline_cache(VkPipelineCache pipeline_cache);
 
+	/**
+	 * @brief Enables building cache objects outside of the per-type lock
+	 *        Descriptor sets are always built under the lock, as they share their descriptor pool
+	 * @param concurrent True to enable concurrent mode
+	 */
+	void set_concurrent_mode(bool concurrent);
+
+	bool is_concurrent_mode() const;
+
+	/**
+	 * @brief Enables compiling graphics pipelines in background jobs
+	 * @param enabled True to enable asynchronous compilation
+	 * @param fallback Optional function providing a pipeline to use until the requested one is ready.
+	 *                 The fallback must be compatible with the layout and render pass of the requested state
+	 */
+	void set_async_graphics_pipelines(bool enabled, FallbackPipelineFunc fallback = {});
+
+	bool is_async_graphics_pipelines() const;
+
+	/**
+	 * @brief Requests a graphics pipeline without blocking on its compilation
+	 * @return The pipeline if it is ready, otherwise nullptr after scheduling its compilation
+	 */
+	GraphicsPipeline *request_graphics_pipeline_async(PipelineState &pipeline_state);
+
+	/**
+	 * @return The fallback pipeline for the given state, or nullptr if there is none
+	 */
+	GraphicsPipeline *request_fallback_graphics_pipeline(const PipelineState &pipeline_state);
+
+	/**
+	 * @return The number of graphics pipelines scheduled or being compiled in the background
+	 */
+	uint32_t get_pending_pipeline_count();
+
+	/**
+	 * @brief Waits for the scheduled asynchronous pipeline compilations to complete
+	 */
+	void wait_for_pipeline_compiles();
+
+	/**
+	 * @brief Bounds the number of cached descriptor sets, the least recently used ones are evicted first
+	 *        Bounded descriptor sets are allocated from pools which allow freeing them individually,
+	 *        sets allocated while the cache was unbounded cannot be freed, so they are never evicted.
+	 * @param capacity Maximum number of descriptor sets, 0 if unbounded
+	 */
+	void set_descriptor_set_capacity(size_t capacity);
+
+	/**
+	 * @brief Bounds the number of cached framebuffers, the least recently used ones are evicted first
+	 *        Bounded framebuffers are always built under the lock, even in concurrent mode.
+	 * @param capacity Maximum number of framebuffers, 0 if unbounded
+	 */
+	void set_framebuffer_capacity(size_t capacity);
+
+	/**
+	 * @brief Starts a new frame, and evicts the objects exceeding the capacity of their type
+	 *        Objects requested after the completed frame may still be in use by the GPU, so they are kept.
+	 * @param frame Number of the frame being started, objects requested from now on are tagged with it
+	 * @param completed_frame Number of the last frame whose GPU work is known to be complete
+	 */
+	void begin_frame(uint64_t frame, uint64_t completed_frame);
+
+	ResourceCacheEvictionStats get_descriptor_set_eviction_stats();
+
+	ResourceCacheEvictionStats get_framebuffer_eviction_stats();
+
+	/**
+	 * @return The counters of the requests for a type of object, since creation or the last reset_stats
+	 */
+	ResourceCacheStats get_stats(ResourceCacheType type);
+
+	/**
+	 * @return The counters of the requests for all types of objects
+	 */
+	ResourceCacheStats get_total_stats();
+
+	void reset_stats();
+
 	ShaderModule &request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant = {});
 
 	PipelineLayout &request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
@@ -118,6 +340,9 @@ class ResourceCache
 	Framebuffer &request_framebuffer(const RenderTarget &render_target,
 	                                 const RenderPass &  render_pass);
 
+	/**
+	 * @brief Destroys the pipelines, once the pending compile jobs completed
+	 */
 	void clear_pipelines();
 
 	/// @brief Update those descriptor sets referring to old views
@@ -127,11 +352,16 @@ class ResourceCache
 
 	void clear_framebuffers();
 
+	/**
+	 * @brief Destroys all the cached objects, once the warm-up and the pending compile jobs completed
+	 */
 	void clear();
 
 	const ResourceCacheState &get_internal_state() const;
 
   private:
+	ResourceCacheSync &get_sync(ResourceCacheType type);
+
 	Device &device;
 
 	ResourceRecord recorder;
@@ -142,20 +372,52 @@ class ResourceCache
 
 	ResourceCacheState state;
 
-	std::mutex descriptor_set_mutex;
+	/// Read by the recording threads, and may be set by a background warm-up
+	std::atomic<bool> concurrent_mode{false};
+
+	ResourceCacheSync descriptor_set_sync;
+
+	ResourceCacheSync pipeline_layout_sync;
+
+	ResourceCacheSync shader_module_sync;
+
+	ResourceCacheSync descriptor_set_layout_sync;
+
+	ResourceCacheSync graphics_pipeline_sync;
+
+	ResourceCacheSync render_pass_sync;
+
+	ResourceCacheSync compute_pipeline_sync;
+
+	ResourceCacheSync framebuffer_sync;
+
+	/// Serializes access to the recorder in concurrent mode
+	std::mutex recorder_mutex;
+
+	/// Number of the current frame, used to tag the requests of bounded resources
+	std::atomic<uint64_t> current_frame{0};
+
+	/// Guarded by descriptor_set_sync
+	ResourceCacheLru descriptor_set_lru;
+
+	/// Guarded by framebuffer_sync
+	ResourceCacheLru framebuffer_lru;
 
-	std::mutex pipeline_layout_mutex;
+	std::future<void> warmup_future;
 
-	std::mutex shader_module_mutex;
+	bool async_graphics_pipelines{false};
 
-	std::mutex descriptor_set_layout_mutex;
+	FallbackPipelineFunc fallback_pipeline_func;
 
-	std::mutex graphics_pipeline_mutex;
+	std::mutex async_pipeline_mutex;
 
-	std::mutex render_pass_mutex;
+	/// Hashes of the graphics pipelines scheduled for compilation
+	std::unordered_set<std::size_t> pending_pipelines;
 
-	std::mutex compute_pipeline_mutex;
+	/// Hashes of the graphics pipelines which failed to compile, they are not scheduled again
+	std::unordered_set<std::size_t> failed_pipelines;
 
-	std::mutex framebuffer_mutex;
+	/// Guarded by async_pipeline_mutex, completed jobs are pruned when new ones are scheduled
+	std::vector<JobSystem::JobHandle> pipeline_compile_jobs;
 };
 }        // namespace vkb
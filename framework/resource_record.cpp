@@ -47,6 +47,24 @@ inline void write_processes(std::ostringstream &os, const std::vector<std::strin
 }
 }        // namespace
 
+ResourceRecordHeader::ResourceRecordHeader(const VkPhysicalDeviceProperties &properties) :
+    vendor_id{properties.vendorID},
+    device_id{properties.deviceID},
+    driver_version{properties.driverVersion}
+{
+	std::copy(std::begin(properties.pipelineCacheUUID), std::end(properties.pipelineCacheUUID), pipeline_cache_uuid.begin());
+}
+
+bool ResourceRecordHeader::operator==(const ResourceRecordHeader &other) const
+{
+	return magic == other.magic &&
+	       schema_version == other.schema_version &&
+	       vendor_id == other.vendor_id &&
+	       device_id == other.device_id &&
+	       driver_version == other.driver_version &&
+	       pipeline_cache_uuid == other.pipeline_cache_uuid;
+}
+
 void ResourceRecord::set_data(const std::vector<uint8_t> &data)
 {
 	stream.str(std::string{data.begin(), data.end()});
@@ -59,6 +77,49 @@ std::vector<uint8_t> ResourceRecord::get_data()
 	return std::vector<uint8_t>{str.begin(), str.end()};
 }
 
+std::vector<uint8_t> ResourceRecord::get_data(const ResourceRecordHeader &header)
+{
+	std::ostringstream os;
+
+	write(os,
+	      header.magic,
+	      header.schema_version,
+	      header.vendor_id,
+	      header.device_id,
+	      header.driver_version,
+	      header.pipeline_cache_uuid);
+
+	os << stream.str();
+
+	std::string str = os.str();
+
+	return std::vector<uint8_t>{str.begin(), str.end()};
+}
+
+bool ResourceRecord::validate_data(const std::vector<uint8_t> &data, const ResourceRecordHeader &header, std::vector<uint8_t> &body)
+{
+	std::istringstream is{std::string{data.begin(), data.end()}};
+
+	ResourceRecordHeader data_header;
+
+	read(is,
+	     data_header.magic,
+	     data_header.schema_version,
+	     data_header.vendor_id,
+	     data_header.device_id,
+	     data_header.driver_version,
+	     data_header.pipeline_cache_uuid);
+
+	if (is.fail() || !(data_header == header))
+	{
+		return false;
+	}
+
+	body.assign(data.begin() + static_cast<std::ptrdiff_t>(is.tellg()), data.end());
+
+	return true;
+}
+
 const std::ostringstream &ResourceRecord::get_stream()
 {
 	return stream;
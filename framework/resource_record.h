@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "rendering/pipeline_state.h"
@@ -36,6 +37,37 @@ enum class ResourceType
 	GraphicsPipeline
 };
 
+/**
+ * @brief Header of serialized resource records
+ *        Records written by another device, driver or schema version are stale and must not be replayed.
+ */
+struct ResourceRecordHeader
+{
+	/// Identifies resource record data
+	static constexpr uint32_t MAGIC = 0x52524B56;        // "VKRR"
+
+	/// Bump whenever the serialized layout of a resource changes
+	static constexpr uint32_t SCHEMA_VERSION = 1;
+
+	uint32_t magic{MAGIC};
+
+	uint32_t schema_version{SCHEMA_VERSION};
+
+	uint32_t vendor_id{0};
+
+	uint32_t device_id{0};
+
+	uint32_t driver_version{0};
+
+	std::array<uint8_t, VK_UUID_SIZE> pipeline_cache_uuid{};
+
+	ResourceRecordHeader() = default;
+
+	ResourceRecordHeader(const VkPhysicalDeviceProperties &properties);
+
+	bool operator==(const ResourceRecordHeader &other) const;
+};
+
 /**
  * @brief Writes Vulkan objects in a memory stream.
  */
@@ -46,6 +78,21 @@ class ResourceRecord
 
 	std::vector<uint8_t> get_data();
 
+	/**
+	 * @brief Serializes the recorded resources preceded by a header
+	 * @param header Identifies the device the resources were recorded with
+	 */
+	std::vector<uint8_t> get_data(const ResourceRecordHeader &header);
+
+	/**
+	 * @brief Validates the header of serialized resources
+	 * @param data Serialized resources, as returned by get_data(header)
+	 * @param header The header expected for the current device
+	 * @param[out] body The serialized resources without their header
+	 * @return False if the data is not valid for the current device, driver or schema version
+	 */
+	static bool validate_data(const std::vector<uint8_t> &data, const ResourceRecordHeader &header, std::vector<uint8_t> &body);
+
 	const std::ostringstream &get_stream();
 
 	size_t register_shader_module(VkShaderStageFlagBits stage,
@@ -18,6 +18,7 @@
 #include "resource_replay.h"
 
 #include "common/vk_common.h"
+#include "core/util/job_system.hpp"
 #include "core/util/logging.hpp"
 #include "rendering/pipeline_state.h"
 #include "resource_cache.h"
@@ -48,19 +49,40 @@ inline void read_processes(std::istringstream &is, std::vector<std::string> &val
 		read(is, item);
 	}
 }
+
+/**
+ * @brief Calls func for each index in [0, count), across the job system if parallel
+ *        Waits for all the calls to complete, then rethrows the first exception if any
+ */
+template <class F>
+void for_each_index(bool parallel, size_t count, F func)
+{
+	if (parallel)
+	{
+		JobSystem::get().parallel_for(count, func);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		func(i);
+	}
+}
 }        // namespace
 
 ResourceReplay::ResourceReplay()
 {
-	stream_resources[ResourceType::ShaderModule]     = std::bind(&ResourceReplay::create_shader_module, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::PipelineLayout]   = std::bind(&ResourceReplay::create_pipeline_layout, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::RenderPass]       = std::bind(&ResourceReplay::create_render_pass, this, std::placeholders::_1, std::placeholders::_2);
-	stream_resources[ResourceType::GraphicsPipeline] = std::bind(&ResourceReplay::create_graphics_pipeline, this, std::placeholders::_1, std::placeholders::_2);
+	stream_resources[ResourceType::ShaderModule]     = std::bind(&ResourceReplay::read_shader_module, this, std::placeholders::_1);
+	stream_resources[ResourceType::PipelineLayout]   = std::bind(&ResourceReplay::read_pipeline_layout, this, std::placeholders::_1);
+	stream_resources[ResourceType::RenderPass]       = std::bind(&ResourceReplay::read_render_pass, this, std::placeholders::_1);
+	stream_resources[ResourceType::GraphicsPipeline] = std::bind(&ResourceReplay::read_graphics_pipeline, this, std::placeholders::_1);
 }
 
-void ResourceReplay::play(ResourceCache &resource_cache, ResourceRecord &recorder)
+void ResourceReplay::play(ResourceCache &resource_cache, const std::vector<uint8_t> &data, bool parallel)
 {
-	std::istringstream stream{recorder.get_stream().str()};
+	clear();
+
+	std::istringstream stream{std::string{data.begin(), data.end()}};
 
 	while (true)
 	{
@@ -80,16 +102,33 @@ void ResourceReplay::play(ResourceCache &resource_cache, ResourceRecord &recorde
 		if (cmd_it != stream_resources.end())
 		{
 			// Run command function
-			cmd_it->second(resource_cache, stream);
+			cmd_it->second(stream);
 		}
 		else
 		{
 			LOGE("Replay command not supported.");
+			break;
 		}
 	}
+
+	shader_modules.resize(shader_module_entries.size());
+	pipeline_layouts.resize(pipeline_layout_entries.size());
+	render_passes.resize(render_pass_entries.size());
+	graphics_pipelines.resize(graphics_pipeline_entries.size());
+
+	// Each type only depends on the types created before it
+	for_each_index(parallel, shader_module_entries.size(), [&](size_t index) { create_shader_module(resource_cache, index); });
+	for_each_index(parallel, pipeline_layout_entries.size(), [&](size_t index) { create_pipeline_layout(resource_cache, index); });
+	for_each_index(parallel, render_pass_entries.size(), [&](size_t index) { create_render_pass(resource_cache, index); });
+	for_each_index(parallel, graphics_pipeline_entries.size(), [&](size_t index) { create_graphics_pipeline(resource_cache, index); });
+
+	LOGI("Replayed {} shader modules, {} pipeline layouts, {} render passes and {} graphics pipelines",
+	     shader_modules.size(), pipeline_layouts.size(), render_passes.size(), graphics_pipelines.size());
+
+	clear();
 }
 
-void ResourceReplay::create_shader_module(ResourceCache &resource_cache, std::istringstream &stream)
+void ResourceReplay::read_shader_module(std::istringstream &stream)
 {
 	VkShaderStageFlagBits    stage{};
 	std::string              glsl_source;
@@ -105,62 +144,46 @@ void ResourceReplay::create_shader_module(ResourceCache &resource_cache, std::is
 
 	read_processes(stream, processes);
 
-	ShaderSource shader_source{};
-	shader_source.set_source(std::move(glsl_source));
-	ShaderVariant shader_variant(std::move(preamble), std::move(processes));
-
-	auto &shader_module = resource_cache.request_shader_module(stage, shader_source, shader_variant);
+	ShaderModuleEntry entry{};
+	entry.stage = stage;
+	entry.source.set_source(std::move(glsl_source));
+	entry.variant = ShaderVariant(std::move(preamble), std::move(processes));
 
-	shader_modules.push_back(&shader_module);
+	shader_module_entries.push_back(std::move(entry));
 }
 
-void ResourceReplay::create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream)
+void ResourceReplay::read_pipeline_layout(std::istringstream &stream)
 {
 	std::vector<size_t> shader_indices;
 
 	read(stream,
 	     shader_indices);
 
-	std::vector<ShaderModule *> shader_stages(shader_indices.size());
-	std::transform(shader_indices.begin(),
-	               shader_indices.end(),
-	               shader_stages.begin(),
-	               [&](size_t shader_index) {
-		               assert(shader_index < shader_modules.size());
-		               return shader_modules[shader_index];
-	               });
-
-	auto &pipeline_layout = resource_cache.request_pipeline_layout(shader_stages);
-
-	pipeline_layouts.push_back(&pipeline_layout);
+	pipeline_layout_entries.push_back(std::move(shader_indices));
 }
 
-void ResourceReplay::create_render_pass(ResourceCache &resource_cache, std::istringstream &stream)
+void ResourceReplay::read_render_pass(std::istringstream &stream)
 {
-	std::vector<Attachment>    attachments;
-	std::vector<LoadStoreInfo> load_store_infos;
-	std::vector<SubpassInfo>   subpasses;
+	RenderPassEntry entry{};
 
 	read(stream,
-	     attachments,
-	     load_store_infos);
-
-	read_subpass_info(stream, subpasses);
+	     entry.attachments,
+	     entry.load_store_infos);
 
-	auto &render_pass = resource_cache.request_render_pass(attachments, load_store_infos, subpasses);
+	read_subpass_info(stream, entry.subpasses);
 
-	render_passes.push_back(&render_pass);
+	render_pass_entries.push_back(std::move(entry));
 }
 
-void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream)
+void ResourceReplay::read_graphics_pipeline(std::istringstream &stream)
 {
-	size_t   pipeline_layout_index{};
-	size_t   render_pass_index{};
+	GraphicsPipelineEntry entry{};
+
 	uint32_t subpass_index{};
 
 	read(stream,
-	     pipeline_layout_index,
-	     render_pass_index,
+	     entry.pipeline_layout_index,
+	     entry.render_pass_index,
 	     subpass_index);
 
 	std::map<uint32_t, std::vector<uint8_t>> specialization_constant_state{};
@@ -193,11 +216,7 @@ void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std
 	     color_blend_state.logic_op_enable,
 	     color_blend_state.attachments);
 
-	PipelineState pipeline_state{};
-	assert(pipeline_layout_index < pipeline_layouts.size());
-	pipeline_state.set_pipeline_layout(*pipeline_layouts[pipeline_layout_index]);
-	assert(render_pass_index < render_passes.size());
-	pipeline_state.set_render_pass(*render_passes[render_pass_index]);
+	auto &pipeline_state = entry.pipeline_state;
 
 	for (auto &item : specialization_constant_state)
 	{
@@ -213,8 +232,62 @@ void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, std
 	pipeline_state.set_depth_stencil_state(depth_stencil_state);
 	pipeline_state.set_color_blend_state(color_blend_state);
 
-	auto &graphics_pipeline = resource_cache.request_graphics_pipeline(pipeline_state);
+	graphics_pipeline_entries.push_back(std::move(entry));
+}
+
+void ResourceReplay::create_shader_module(ResourceCache &resource_cache, size_t index)
+{
+	auto &entry = shader_module_entries[index];
+
+	shader_modules[index] = &resource_cache.request_shader_module(entry.stage, entry.source, entry.variant);
+}
+
+void ResourceReplay::create_pipeline_layout(ResourceCache &resource_cache, size_t index)
+{
+	auto &shader_indices = pipeline_layout_entries[index];
+
+	std::vector<ShaderModule *> shader_stages(shader_indices.size());
+	std::transform(shader_indices.begin(),
+	               shader_indices.end(),
+	               shader_stages.begin(),
+	               [&](size_t shader_index) {
+		               assert(shader_index < shader_modules.size());
+		               return shader_modules[shader_index];
+	               });
+
+	pipeline_layouts[index] = &resource_cache.request_pipeline_layout(shader_stages);
+}
+
+void ResourceReplay::create_render_pass(ResourceCache &resource_cache, size_t index)
+{
+	auto &entry = render_pass_entries[index];
+
+	render_passes[index] = &resource_cache.request_render_pass(entry.attachments, entry.load_store_infos, entry.subpasses);
+}
+
+void ResourceReplay::create_graphics_pipeline(ResourceCache &resource_cache, size_t index)
+{
+	auto &entry = graphics_pipeline_entries[index];
+
+	// Work on a copy, so that the entry can be replayed concurrently
+	PipelineState pipeline_state = entry.pipeline_state;
+	assert(entry.pipeline_layout_index < pipeline_layouts.size());
+	pipeline_state.set_pipeline_layout(*pipeline_layouts[entry.pipeline_layout_index]);
+	assert(entry.render_pass_index < render_passes.size());
+	pipeline_state.set_render_pass(*render_passes[entry.render_pass_index]);
 
-	graphics_pipelines.push_back(&graphics_pipeline);
+	graphics_pipelines[index] = &resource_cache.request_graphics_pipeline(pipeline_state);
+}
+
+void ResourceReplay::clear()
+{
+	shader_module_entries.clear();
+	pipeline_layout_entries.clear();
+	render_pass_entries.clear();
+	graphics_pipeline_entries.clear();
+	shader_modules.clear();
+	pipeline_layouts.clear();
+	render_passes.clear();
+	graphics_pipelines.clear();
 }
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -25,28 +25,82 @@ class ResourceCache;
 
 /**
  * @brief Reads Vulkan objects from a memory stream and creates them in the resource cache.
+ *
+ * The stream is parsed first, then objects are created one type at a time: shader modules,
+ * pipeline layouts, render passes and finally graphics pipelines. Objects of the same type
+ * do not depend on each other, so they can be created in parallel on the job system.
  */
 class ResourceReplay
 {
   public:
 	ResourceReplay();
 
-	void play(ResourceCache &resource_cache, ResourceRecord &recorder);
+	/**
+	 * @brief Creates all the objects serialized in the data
+	 * @param resource_cache The cache to create the objects in, it must be in concurrent mode if parallel
+	 * @param data Serialized resources, without the record header
+	 * @param parallel Whether objects of the same type are created in parallel, on the workers of the job system
+	 */
+	void play(ResourceCache &resource_cache, const std::vector<uint8_t> &data, bool parallel = false);
 
   protected:
-	void create_shader_module(ResourceCache &resource_cache, std::istringstream &stream);
+	void read_shader_module(std::istringstream &stream);
+
+	void read_pipeline_layout(std::istringstream &stream);
+
+	void read_render_pass(std::istringstream &stream);
+
+	void read_graphics_pipeline(std::istringstream &stream);
+
+	void create_shader_module(ResourceCache &resource_cache, size_t index);
 
-	void create_pipeline_layout(ResourceCache &resource_cache, std::istringstream &stream);
+	void create_pipeline_layout(ResourceCache &resource_cache, size_t index);
 
-	void create_render_pass(ResourceCache &resource_cache, std::istringstream &stream);
+	void create_render_pass(ResourceCache &resource_cache, size_t index);
 
-	void create_graphics_pipeline(ResourceCache &resource_cache, std::istringstream &stream);
+	void create_graphics_pipeline(ResourceCache &resource_cache, size_t index);
 
   private:
-	using ResourceFunc = std::function<void(ResourceCache &, std::istringstream &)>;
+	struct ShaderModuleEntry
+	{
+		VkShaderStageFlagBits stage{};
+
+		ShaderSource source;
+
+		ShaderVariant variant;
+	};
+
+	struct RenderPassEntry
+	{
+		std::vector<Attachment> attachments;
+
+		std::vector<LoadStoreInfo> load_store_infos;
+
+		std::vector<SubpassInfo> subpasses;
+	};
+
+	struct GraphicsPipelineEntry
+	{
+		size_t pipeline_layout_index{};
+
+		size_t render_pass_index{};
+
+		/// Full state except for the pipeline layout and render pass, which are only known once created
+		PipelineState pipeline_state;
+	};
+
+	using ResourceFunc = std::function<void(std::istringstream &)>;
 
 	std::unordered_map<ResourceType, ResourceFunc> stream_resources;
 
+	std::vector<ShaderModuleEntry> shader_module_entries;
+
+	std::vector<std::vector<size_t>> pipeline_layout_entries;
+
+	std::vector<RenderPassEntry> render_pass_entries;
+
+	std::vector<GraphicsPipelineEntry> graphics_pipeline_entries;
+
 	std::vector<ShaderModule *> shader_modules;
 
 	std::vector<PipelineLayout *> pipeline_layouts;
@@ -54,5 +108,7 @@ class ResourceReplay
 	std::vector<const RenderPass *> render_passes;
 
 	std::vector<const GraphicsPipeline *> graphics_pipelines;
+
+	void clear();
 };
 }        // namespace vkb
@@ -21,6 +21,7 @@
 #include <glm/gtx/matrix_decompose.hpp>
 
 #include "scene_graph/node.h"
+#include "scene_graph/transform_store.h"
 
 namespace vkb
 {
@@ -95,6 +96,17 @@ glm::mat4 Transform::get_matrix() const
 
 glm::mat4 Transform::get_world_matrix()
 {
+	if (store)
+	{
+		// Rebuilding the store may remove the transform from it
+		store->update_hierarchy();
+	}
+
+	if (store)
+	{
+		return store->get_world_matrix(store_index);
+	}
+
 	update_world_transform();
 
 	return world_matrix;
@@ -102,7 +114,29 @@ glm::mat4 Transform::get_world_matrix()
 
 void Transform::invalidate_world_matrix()
 {
+	if (store)
+	{
+		store->mark_dirty(store_index);
+		return;
+	}
+
+	// The descendants of an invalid transform are already invalid
+	if (update_world_matrix)
+	{
+		return;
+	}
+
 	update_world_matrix = true;
+
+	for (auto child : node.get_children())
+	{
+		child->get_transform().invalidate_world_matrix();
+	}
+}
+
+TransformStore *Transform::get_store() const
+{
+	return store;
 }
 
 void Transform::update_world_transform()
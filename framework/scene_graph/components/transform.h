@@ -34,7 +34,14 @@ namespace vkb
 namespace sg
 {
 class Node;
+class TransformStore;
 
+/**
+ * @brief Local transform of a node
+ *
+ * Once the node is stored in the TransformStore of its scene, its world matrix is read from the store.
+ * Otherwise it is computed lazily from the world matrix of its parent.
+ */
 class Transform : public Component
 {
   public:
@@ -68,10 +75,18 @@ class Transform : public Component
 	 * @brief Marks the world transform invalid if any of
 	 *        the local transform are changed or the parent
 	 *        world transform has changed.
+	 *        The world transforms of the descendants are invalidated too.
 	 */
 	void invalidate_world_matrix();
 
+	/**
+	 * @return The store the transform is in, null if it is not stored
+	 */
+	TransformStore *get_store() const;
+
   private:
+	friend class TransformStore;
+
 	Node &node;
 
 	glm::vec3 translation = glm::vec3(0.0, 0.0, 0.0);
@@ -84,6 +99,11 @@ class Transform : public Component
 
 	bool update_world_matrix = false;
 
+	TransformStore *store = nullptr;
+
+	/// Index of the node in the store
+	uint32_t store_index = 0;
+
 	void update_world_transform();
 };
 
@@ -35,6 +35,8 @@ namespace scene_graph
 class HPPScene : private vkb::sg::Scene
 {
   public:
+	using vkb::sg::Scene::update_transforms;
+
 	template <class T>
 	std::vector<T *> get_components() const
 	{
@@ -19,6 +19,7 @@
 
 #include "component.h"
 #include "components/transform.h"
+#include "transform_store.h"
 
 namespace vkb
 {
@@ -46,6 +47,11 @@ void Node::set_parent(Node &p)
 {
 	parent = &p;
 
+	if (auto store = transform.get_store())
+	{
+		store->invalidate_hierarchy();
+	}
+
 	transform.invalidate_world_matrix();
 }
 
@@ -57,6 +63,11 @@ Node *Node::get_parent() const
 void Node::add_child(Node &child)
 {
 	children.push_back(&child);
+
+	if (auto store = transform.get_store())
+	{
+		store->invalidate_hierarchy();
+	}
 }
 
 const std::vector<Node *> &Node::get_children() const
@@ -129,11 +129,23 @@ Node *Scene::find_node(const std::string &node_name)
 void Scene::set_root_node(Node &node)
 {
 	root = &node;
+
+	transform_store->set_root(node);
 }
 
 Node &Scene::get_root_node()
 {
 	return *root;
 }
+
+void Scene::update_transforms()
+{
+	transform_store->update_all();
+}
+
+TransformStore &Scene::get_transform_store()
+{
+	return *transform_store;
+}
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
@@ -26,6 +26,7 @@
 
 #include "scene_graph/components/light.h"
 #include "scene_graph/components/texture.h"
+#include "scene_graph/transform_store.h"
 
 namespace vkb
 {
@@ -126,10 +127,21 @@ class Scene
 
 	Node *find_node(const std::string &name);
 
+	/**
+	 * @brief Sets the root node, the nodes reachable from it are stored in the transform store
+	 */
 	void set_root_node(Node &node);
 
 	Node &get_root_node();
 
+	/**
+	 * @brief Updates the world matrices of the nodes whose transform changed since the last update
+	 *        Called once per frame, after the scripts and animations
+	 */
+	void update_transforms();
+
+	TransformStore &get_transform_store();
+
   private:
 	std::string name;
 
@@ -139,6 +151,9 @@ class Scene
 	Node *root{nullptr};
 
 	std::unordered_map<std::type_index, std::vector<std::unique_ptr<Component>>> components;
+
+	/// Declared last, so that it is destroyed while the nodes still exist
+	std::unique_ptr<TransformStore> transform_store{std::make_unique<TransformStore>()};
 };
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
@@ -0,0 +1,224 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transform_store.h"
+
+#include "common/helpers.h"
+#include "core/util/job_system.hpp"
+#include "core/util/profiling.hpp"
+#include "scene_graph/node.h"
+
+namespace vkb
+{
+namespace sg
+{
+TransformStore::~TransformStore()
+{
+	clear();
+}
+
+void TransformStore::set_root(Node &root_)
+{
+	root = &root_;
+	hierarchy_dirty.store(true, std::memory_order_release);
+}
+
+void TransformStore::invalidate_hierarchy()
+{
+	hierarchy_dirty.store(true, std::memory_order_release);
+}
+
+void TransformStore::update_hierarchy()
+{
+	if (!hierarchy_dirty.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock{mutex};
+
+	// Another thread may have rebuilt the store while this one waited
+	if (hierarchy_dirty.load(std::memory_order_relaxed))
+	{
+		rebuild();
+	}
+}
+
+void TransformStore::update_all()
+{
+	PROFILE_FUNCTION();
+
+	update_hierarchy();
+
+	if (!any_dirty.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	// Ancestors first, the batches then only depend on nodes already updated
+	for (auto index : hierarchy.get_serial_nodes())
+	{
+		if (hierarchy.is_world_dirty(index))
+		{
+			update_node(index);
+		}
+	}
+
+	auto &batches      = hierarchy.get_batches();
+	auto  update_batch = [this, &batches](size_t batch_index) {
+		hierarchy.for_each_dirty(batches[batch_index].first, batches[batch_index].second, [this](uint32_t index) { update_node(index); });
+	};
+
+	if (batches.size() > 1)
+	{
+		JobSystem::get().parallel_for(batches.size(), update_batch);
+	}
+	else if (batches.size() == 1)
+	{
+		update_batch(0);
+	}
+
+	// Batches may share words of the bitsets, so the bits are only cleared once all are done
+	hierarchy.clear_all_dirty();
+
+	// Published to the threads reading without the lock
+	any_dirty.store(false, std::memory_order_release);
+}
+
+const glm::mat4 &TransformStore::get_world_matrix(uint32_t index)
+{
+	if (!any_dirty.load(std::memory_order_acquire))
+	{
+		return world_matrices[index];
+	}
+
+	std::lock_guard<std::mutex> lock{mutex};
+
+	thread_local std::vector<uint32_t> chain;
+
+	hierarchy.get_dirty_chain(index, chain);
+
+	for (auto node_index : chain)
+	{
+		update_node(node_index);
+
+		hierarchy.clear_dirty(node_index);
+	}
+
+	return world_matrices[index];
+}
+
+void TransformStore::mark_dirty(uint32_t index)
+{
+	hierarchy.mark_dirty(index);
+
+	any_dirty.store(true, std::memory_order_relaxed);
+}
+
+const std::vector<Node *> &TransformStore::get_nodes() const
+{
+	return nodes;
+}
+
+const std::vector<glm::mat4> &TransformStore::get_world_matrices() const
+{
+	return world_matrices;
+}
+
+void TransformStore::clear()
+{
+	// The transforms compute their world matrix on their own again
+	for (auto node : nodes)
+	{
+		auto &transform               = node->get_transform();
+		transform.store               = nullptr;
+		transform.update_world_matrix = true;
+	}
+
+	nodes.clear();
+	hierarchy.clear();
+	local_matrices.clear();
+	world_matrices.clear();
+
+	any_dirty.store(false, std::memory_order_relaxed);
+}
+
+void TransformStore::rebuild()
+{
+	PROFILE_FUNCTION();
+
+	clear();
+
+	hierarchy_dirty.store(false, std::memory_order_relaxed);
+
+	if (!root)
+	{
+		return;
+	}
+
+	std::vector<uint32_t> parents;
+
+	// Depth-first, so that each subtree is a contiguous range
+	std::vector<std::pair<Node *, uint32_t>> stack{{root, INVALID_INDEX}};
+
+	while (!stack.empty())
+	{
+		auto [node, parent] = stack.back();
+		stack.pop_back();
+
+		auto &transform = node->get_transform();
+
+		// A node reachable twice is only stored once
+		if (transform.store == this)
+		{
+			continue;
+		}
+
+		transform.store       = this;
+		transform.store_index = to_u32(nodes.size());
+
+		nodes.push_back(node);
+		parents.push_back(parent);
+
+		auto &children = node->get_children();
+		for (auto it = children.rbegin(); it != children.rend(); ++it)
+		{
+			stack.emplace_back(*it, transform.store_index);
+		}
+	}
+
+	hierarchy.build(parents, UPDATE_BATCH_SIZE);
+
+	local_matrices.resize(nodes.size());
+	world_matrices.resize(nodes.size());
+
+	any_dirty.store(!nodes.empty(), std::memory_order_relaxed);
+}
+
+void TransformStore::update_node(uint32_t index)
+{
+	if (hierarchy.is_local_dirty(index))
+	{
+		local_matrices[index] = nodes[index]->get_transform().get_matrix();
+	}
+
+	uint32_t parent = hierarchy.get_parent(index);
+
+	world_matrices[index] = parent == INVALID_INDEX ? local_matrices[index] : world_matrices[parent] * local_matrices[index];
+}
+}        // namespace sg
+}        // namespace vkb
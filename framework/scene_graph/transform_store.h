@@ -0,0 +1,146 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "common/glm_common.h"
+#include "core/util/transform_hierarchy.hpp"
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+class Transform;
+
+/**
+ * @brief Stores the local and world matrices of the nodes of a scene in contiguous arrays
+ *
+ * The nodes reachable from the root are stored in depth-first order, see TransformHierarchy. Changing a transform
+ * marks its node and its whole subtree dirty, update_all then recomputes the dirty world matrices in a single
+ * linear pass, subtrees running in parallel on the job system.
+ *
+ * The transforms of the stored nodes read their world matrix from the store. Once update_all ran, reads do not
+ * modify the store and take no lock. Before that, reading the world matrix of a dirty node updates it and its
+ * dirty ancestors under a lock. Changing transforms, or calling update_all, while other threads read is not
+ * supported. The store is rebuilt once the hierarchy changed, nodes which are not reachable from the root are
+ * not stored. A rebuild moves the transforms in and out of the store, so the hierarchy must be updated before
+ * reading from several threads.
+ */
+class TransformStore
+{
+  public:
+	/// Index of the parent of a root node
+	static constexpr uint32_t INVALID_INDEX = TransformHierarchy::INVALID_INDEX;
+
+	/// Maximum number of nodes updated together by a single job, larger subtrees are split
+	static constexpr uint32_t UPDATE_BATCH_SIZE = 512;
+
+	TransformStore() = default;
+
+	/**
+	 * @brief Unregisters the transforms of the stored nodes, which must still exist
+	 */
+	~TransformStore();
+
+	TransformStore(const TransformStore &) = delete;
+
+	TransformStore(TransformStore &&) = delete;
+
+	TransformStore &operator=(const TransformStore &) = delete;
+
+	TransformStore &operator=(TransformStore &&) = delete;
+
+	/**
+	 * @brief Sets the root of the stored nodes, the store is rebuilt on next use
+	 */
+	void set_root(Node &root);
+
+	/**
+	 * @brief Rebuilds the store on next use, called when a stored node gets a new parent or child
+	 */
+	void invalidate_hierarchy();
+
+	/**
+	 * @brief Rebuilds the store if the hierarchy changed, all the world matrices are then dirty
+	 *        Takes a lock if it does
+	 */
+	void update_hierarchy();
+
+	/**
+	 * @brief Recomputes the dirty world matrices, in parallel for large scenes
+	 *        Does nothing if no transform changed
+	 */
+	void update_all();
+
+	/**
+	 * @param index Index of the node in the store
+	 * @return The world matrix of the node, updated with its dirty ancestors under a lock if needed
+	 */
+	const glm::mat4 &get_world_matrix(uint32_t index);
+
+	/**
+	 * @brief Marks the local matrix of a node dirty, and the world matrices of its subtree
+	 */
+	void mark_dirty(uint32_t index);
+
+	/**
+	 * @return The stored nodes, in depth-first order
+	 */
+	const std::vector<Node *> &get_nodes() const;
+
+	/**
+	 * @return The world matrices of the stored nodes, up to date after update_all
+	 */
+	const std::vector<glm::mat4> &get_world_matrices() const;
+
+  private:
+	void clear();
+
+	void rebuild();
+
+	/**
+	 * @brief Recomputes the world matrix of a node, and its local matrix if dirty, its parent must be up to date
+	 */
+	void update_node(uint32_t index);
+
+	Node *root{nullptr};
+
+	/// Set once the hierarchy changed, checked without the lock by the reads
+	std::atomic<bool> hierarchy_dirty{false};
+
+	/// Set once a world matrix is dirty, reads only take the lock while it is set
+	std::atomic<bool> any_dirty{false};
+
+	/// Serializes the updates of the reads
+	std::mutex mutex;
+
+	std::vector<Node *> nodes;
+
+	TransformHierarchy hierarchy;
+
+	std::vector<glm::mat4> local_matrices;
+
+	std::vector<glm::mat4> world_matrices;
+};
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,277 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shader_cache.h"
+
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+#include "glsl_compiler.h"
+
+namespace vkb
+{
+namespace
+{
+/// Identifies a shader cache file
+constexpr uint32_t SHADER_CACHE_MAGIC = 0x43534B56;        // "VKSC"
+
+/// Bump whenever the layout of a cache entry or the reflection output changes
+constexpr uint32_t SHADER_CACHE_VERSION = 2;
+
+const char *SHADER_CACHE_DIRECTORY = "shader_cache";
+
+inline void write_resource(std::ostringstream &os, const ShaderResource &resource)
+{
+	write(os,
+	      resource.stages,
+	      resource.type,
+	      resource.mode,
+	      resource.set,
+	      resource.binding,
+	      resource.location,
+	      resource.input_attachment_index,
+	      resource.vec_size,
+	      resource.columns,
+	      resource.array_size,
+	      resource.offset,
+	      resource.size,
+	      resource.constant_id,
+	      resource.qualifiers,
+	      resource.name);
+}
+
+inline void read_resource(std::istringstream &is, ShaderResource &resource)
+{
+	read(is,
+	     resource.stages,
+	     resource.type,
+	     resource.mode,
+	     resource.set,
+	     resource.binding,
+	     resource.location,
+	     resource.input_attachment_index,
+	     resource.vec_size,
+	     resource.columns,
+	     resource.array_size,
+	     resource.offset,
+	     resource.size,
+	     resource.constant_id,
+	     resource.qualifiers,
+	     resource.name);
+}
+}        // namespace
+
+std::atomic<bool>     ShaderCache::enabled{true};
+std::atomic<uint32_t> ShaderCache::hit_count{0};
+std::atomic<uint32_t> ShaderCache::miss_count{0};
+std::mutex            ShaderCache::file_mutex;
+
+void ShaderCache::set_enabled(bool enabled_)
+{
+	enabled = enabled_;
+}
+
+bool ShaderCache::is_enabled()
+{
+	return enabled;
+}
+
+ShaderCache::Key ShaderCache::compute_key(VkShaderStageFlagBits stage, const std::vector<uint8_t> &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant)
+{
+	// Runtime array sizes only affect reflection, but are part of the cached result.
+	// Sort them so that the key does not depend on the unordered_map iteration order
+	std::map<std::string, size_t> runtime_array_sizes{shader_variant.get_runtime_array_sizes().begin(),
+	                                                  shader_variant.get_runtime_array_sizes().end()};
+
+	std::ostringstream os;
+
+	write(os,
+	      SHADER_CACHE_VERSION,
+	      std::string{glsl_source.begin(), glsl_source.end()},
+	      shader_variant.get_preamble(),
+	      shader_variant.get_processes().size());
+
+	for (auto &process : shader_variant.get_processes())
+	{
+		write(os, process);
+	}
+
+	write(os,
+	      runtime_array_sizes,
+	      static_cast<uint32_t>(stage),
+	      entry_point,
+	      static_cast<int>(GLSLCompiler::get_target_language()),
+	      static_cast<int>(GLSLCompiler::get_target_language_version()));
+
+	Key key;
+	key.material = os.str();
+	key.hash     = std::hash<std::string>{}(key.material);
+
+	return key;
+}
+
+bool ShaderCache::load(const Key &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
+{
+	if (!enabled)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+
+	{
+		std::lock_guard<std::mutex> guard(file_mutex);
+
+		auto fs       = vkb::filesystem::get();
+		auto filename = fs->temp_directory() / SHADER_CACHE_DIRECTORY / get_filename(key.hash);
+
+		if (!fs->is_file(filename))
+		{
+			miss_count++;
+			return false;
+		}
+
+		data = fs->read_file_binary(filename);
+	}
+
+	std::istringstream is{std::string{data.begin(), data.end()}};
+
+	uint32_t    magic{0};
+	uint32_t    version{0};
+	std::string stored_material;
+
+	try
+	{
+		read(is, magic, version);
+
+		if (!is.fail() && magic == SHADER_CACHE_MAGIC && version == SHADER_CACHE_VERSION)
+		{
+			read(is, stored_material);
+		}
+	}
+	catch (const std::exception &)
+	{
+		is.setstate(std::ios::failbit);
+	}
+
+	// The file name only identifies the hash, another shader with the same hash may own the entry
+	if (is.fail() || magic != SHADER_CACHE_MAGIC || version != SHADER_CACHE_VERSION || stored_material != key.material)
+	{
+		LOGW("Ignoring stale shader cache entry {}", get_filename(key.hash));
+		miss_count++;
+		return false;
+	}
+
+	std::vector<uint32_t>       cached_spirv;
+	std::vector<ShaderResource> cached_resources;
+
+	try
+	{
+		read(is, cached_spirv);
+
+		size_t resource_count{0};
+		read(is, resource_count);
+
+		for (size_t i = 0; i < resource_count && !is.fail(); i++)
+		{
+			ShaderResource resource{};
+			read_resource(is, resource);
+			cached_resources.push_back(std::move(resource));
+		}
+	}
+	catch (const std::exception &)
+	{
+		// Sizes read from a truncated file may be arbitrary, treat any failure as a corrupted entry
+		is.setstate(std::ios::failbit);
+	}
+
+	if (is.fail() || cached_spirv.empty())
+	{
+		LOGW("Ignoring corrupted shader cache entry {}", get_filename(key.hash));
+		miss_count++;
+		return false;
+	}
+
+	spirv     = std::move(cached_spirv);
+	resources = std::move(cached_resources);
+
+	hit_count++;
+	return true;
+}
+
+void ShaderCache::store(const Key &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	std::ostringstream os;
+
+	write(os, SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key.material);
+	write(os, spirv);
+	write(os, resources.size());
+
+	for (auto &resource : resources)
+	{
+		write_resource(os, resource);
+	}
+
+	auto data_str = os.str();
+
+	std::lock_guard<std::mutex> guard(file_mutex);
+
+	try
+	{
+		auto fs        = vkb::filesystem::get();
+		auto directory = fs->temp_directory() / SHADER_CACHE_DIRECTORY;
+
+		if (!fs->is_directory(directory))
+		{
+			fs->create_directory(directory);
+		}
+
+		fs->write_file(directory / get_filename(key.hash), std::vector<uint8_t>{data_str.begin(), data_str.end()});
+	}
+	catch (const std::exception &e)
+	{
+		// A failure to persist the cache is not fatal, the shader will be compiled again next time
+		LOGW("Failed to write shader cache entry {}: {}", get_filename(key.hash), e.what());
+	}
+}
+
+uint32_t ShaderCache::get_hit_count()
+{
+	return hit_count;
+}
+
+uint32_t ShaderCache::get_miss_count()
+{
+	return miss_count;
+}
+
+void ShaderCache::reset_stats()
+{
+	hit_count  = 0;
+	miss_count = 0;
+}
+
+std::string ShaderCache::get_filename(size_t key)
+{
+	return fmt::format("{:016X}.bin", key);
+}
+}        // namespace vkb
@@ -0,0 +1,109 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/shader_module.h"
+
+namespace vkb
+{
+/**
+ * @brief Persistent, content-addressed disk cache for compiled shaders
+ *
+ * Each entry holds the SPIR-V code of a shader together with its reflected resources,
+ * so that a warm start skips both glslang compilation and SPIRV-Cross reflection.
+ * Entries are keyed by the preprocessed GLSL source, the shader variant (preamble, processes
+ * and runtime array sizes), the shader stage, the entry point and the glslang target environment.
+ * They are stored in the temporary directory, one file per key hash. The full key is stored in the file
+ * and compared on load, so that entries with colliding hashes are never mixed up.
+ */
+class ShaderCache
+{
+  public:
+	/**
+	 * @brief Identifies a shader in the cache
+	 */
+	struct Key
+	{
+		/// Hash of the material, which names the cache file
+		size_t hash{0};
+
+		/// All the inputs of the compilation and reflection, serialized
+		std::string material;
+	};
+
+	/**
+	 * @brief Enables or disables the cache, it is enabled by default
+	 */
+	static void set_enabled(bool enabled);
+
+	static bool is_enabled();
+
+	/**
+	 * @brief Computes the key identifying a shader in the cache
+	 * @param stage The Vulkan shader stage flag
+	 * @param glsl_source The preprocessed GLSL source code
+	 * @param entry_point The entrypoint function name of the shader stage
+	 * @param shader_variant The shader variant
+	 * @return The cache key
+	 */
+	static Key compute_key(VkShaderStageFlagBits       stage,
+	                       const std::vector<uint8_t> &glsl_source,
+	                       const std::string          &entry_point,
+	                       const ShaderVariant        &shader_variant);
+
+	/**
+	 * @brief Looks up a shader in the cache
+	 * @param key The key returned by compute_key
+	 * @param[out] spirv The cached SPIRV code
+	 * @param[out] resources The cached shader resources
+	 * @return True on a cache hit, false otherwise
+	 */
+	static bool load(const Key &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources);
+
+	/**
+	 * @brief Stores a compiled and reflected shader in the cache
+	 * @param key The key returned by compute_key
+	 * @param spirv The SPIRV code
+	 * @param resources The reflected shader resources
+	 */
+	static void store(const Key &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources);
+
+	static uint32_t get_hit_count();
+
+	static uint32_t get_miss_count();
+
+	static void reset_stats();
+
+  private:
+	static std::string get_filename(size_t key);
+
+	static std::atomic<bool> enabled;
+
+	static std::atomic<uint32_t> hit_count;
+
+	static std::atomic<uint32_t> miss_count;
+
+	static std::mutex file_mutex;
+};
+}        // namespace vkb
@@ -0,0 +1,63 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "culling_stats_provider.h"
+
+#include "rendering/subpasses/geometry_subpass.h"
+
+namespace vkb
+{
+CullingStatsProvider::CullingStatsProvider(std::set<StatIndex> &requested_stats) :
+    visible_objects{GeometrySubpass::VISIBLE_OBJECTS_PLOT},
+    culled_objects{GeometrySubpass::CULLED_OBJECTS_PLOT}
+{
+	for (auto index : {StatIndex::visible_objects, StatIndex::culled_objects})
+	{
+		if (requested_stats.erase(index) > 0)
+		{
+			stat_indices.insert(index);
+		}
+	}
+}
+
+bool CullingStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.find(index) != stat_indices.end();
+}
+
+StatsProvider::Counters CullingStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	for (auto index : stat_indices)
+	{
+		switch (index)
+		{
+			case StatIndex::visible_objects:
+				res[index].result = static_cast<double>(visible_objects.get());
+				break;
+			case StatIndex::culled_objects:
+				res[index].result = static_cast<double>(culled_objects.get());
+				break;
+			default:
+				break;
+		}
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,96 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gpu_profiler_stats_provider.h"
+
+#include <cassert>
+
+#include "core/util/logging.hpp"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr StatIndex pass_stat_indices[] = {StatIndex::gpu_pass_time_0,
+                                           StatIndex::gpu_pass_time_1,
+                                           StatIndex::gpu_pass_time_2,
+                                           StatIndex::gpu_pass_time_3,
+                                           StatIndex::gpu_pass_time_4,
+                                           StatIndex::gpu_pass_time_5,
+                                           StatIndex::gpu_pass_time_6,
+                                           StatIndex::gpu_pass_time_7};
+}        // namespace
+
+GpuProfilerStatsProvider::GpuProfilerStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    gpu_profiler{render_context.get_gpu_profiler()}
+{
+	if (!gpu_profiler.is_supported())
+	{
+		return;
+	}
+
+	for (auto index : pass_stat_indices)
+	{
+		if (requested_stats.erase(index) > 0)
+		{
+			graph_data[index] = default_graph_map[index];
+		}
+	}
+}
+
+bool GpuProfilerStatsProvider::is_available(StatIndex index) const
+{
+	return graph_data.find(index) != graph_data.end();
+}
+
+const StatGraphData &GpuProfilerStatsProvider::get_graph_data(StatIndex index) const
+{
+	assert(is_available(index) && "GpuProfilerStatsProvider::get_graph_data() called with invalid StatIndex");
+
+	return graph_data.at(index);
+}
+
+StatsProvider::Counters GpuProfilerStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	auto pass_times = gpu_profiler.get_pass_times();
+
+	// Only a fixed number of stats exist for the passes, report once that some are not shown
+	if (pass_times.size() > std::size(pass_stat_indices) && pass_times.size() > reported_pass_count)
+	{
+		LOGW("The GPU profiler timed {} passes, only the first {} are reported as stats", pass_times.size(), std::size(pass_stat_indices));
+		reported_pass_count = pass_times.size();
+	}
+
+	for (size_t i = 0; i < pass_times.size() && i < std::size(pass_stat_indices); i++)
+	{
+		auto it = graph_data.find(pass_stat_indices[i]);
+		if (it == graph_data.end())
+		{
+			continue;
+		}
+
+		it->second.name = pass_times[i].name;
+
+		res[it->first].result = std::chrono::duration<double>(pass_times[i].gpu_time).count();
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,74 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+
+#include "stats_provider.h"
+
+namespace vkb
+{
+class GpuProfiler;
+class RenderContext;
+
+/**
+ * @brief Provides the GPU time of the first passes timed by the GpuProfiler of the render context
+ *
+ * Each stat is named after the pass it reports, the passes beyond the last stat are not reported
+ * and a warning is logged when they appear. The timestamps are only read back once a frame
+ * completed, so the stats are a few frames behind and only support polling.
+ */
+class GpuProfilerStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a GpuProfilerStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 * @param render_context The render context
+	 */
+	GpuProfilerStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve graphing data for the given enabled stat
+	 * @param index The stat index
+	 */
+	const StatGraphData &get_graph_data(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+  private:
+	GpuProfiler &gpu_profiler;
+
+	/// Graph data of the enabled stats, renamed after the pass they report
+	std::map<StatIndex, StatGraphData> graph_data;
+
+	/// The largest number of passes already reported as exceeding the stats
+	size_t reported_pass_count{0};
+};
+}        // namespace vkb
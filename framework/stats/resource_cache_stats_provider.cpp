@@ -0,0 +1,105 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resource_cache_stats_provider.h"
+
+#include "core/device.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+ResourceCacheStatsProvider::ResourceCacheStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    resource_cache{render_context.get_device().get_resource_cache()},
+    last_stats{resource_cache.get_total_stats()}
+{
+	for (auto index : {StatIndex::resource_cache_lookups,
+	                   StatIndex::resource_cache_misses,
+	                   StatIndex::resource_cache_hit_ratio,
+	                   StatIndex::resource_cache_build_time,
+	                   StatIndex::resource_cache_lock_wait_time})
+	{
+		if (requested_stats.erase(index) > 0)
+		{
+			stat_indices.insert(index);
+		}
+	}
+}
+
+bool ResourceCacheStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.find(index) != stat_indices.end();
+}
+
+StatsProvider::Counters ResourceCacheStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	auto stats = resource_cache.get_total_stats();
+
+	// The counters may have been reset since the last sample
+	if (stats.lookups < last_stats.lookups)
+	{
+		last_stats = {};
+	}
+
+	// The cache counters are cumulative, report the change since the last sample
+	double lookups        = static_cast<double>(stats.lookups - last_stats.lookups);
+	double misses         = static_cast<double>(stats.misses - last_stats.misses);
+	double hits           = static_cast<double>(stats.hits - last_stats.hits);
+	double build_time     = std::chrono::duration<double>(stats.build_time - last_stats.build_time).count();
+	double lock_wait_time = std::chrono::duration<double>(stats.lock_wait_time - last_stats.lock_wait_time).count();
+
+	last_stats = stats;
+
+	if (delta_time <= 0.0f)
+	{
+		return res;
+	}
+
+	for (auto index : stat_indices)
+	{
+		switch (index)
+		{
+			case StatIndex::resource_cache_lookups:
+				res[index].result = lookups / delta_time;
+				break;
+			case StatIndex::resource_cache_misses:
+				res[index].result = misses / delta_time;
+				break;
+			case StatIndex::resource_cache_hit_ratio:
+				res[index].result = lookups > 0.0 ? hits / lookups : 1.0;
+				break;
+			case StatIndex::resource_cache_build_time:
+				res[index].result = build_time / delta_time;
+				break;
+			case StatIndex::resource_cache_lock_wait_time:
+				res[index].result = lock_wait_time / delta_time;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return res;
+}
+
+StatsProvider::Counters ResourceCacheStatsProvider::continuous_sample(float delta_time)
+{
+	// The counters are atomic, so they can be read from the sampling thread
+	return sample(delta_time);
+}
+}        // namespace vkb
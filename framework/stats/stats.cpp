@@ -29,10 +29,116 @@
 #endif
 #include "core/allocated.h"
 #include "rendering/render_context.h"
+#include "culling_stats_provider.h"
+#include "gpu_profiler_stats_provider.h"
+#include "resource_cache_stats_provider.h"
 #include "vulkan_stats_provider.h"
 
 namespace vkb
 {
+namespace
+{
+// For now names are taken from the stats_provider.cpp file
+const char *to_string(StatIndex index)
+{
+	switch (index)
+	{
+		case StatIndex::frame_times:
+			return "Frame Times (ms)";
+		case StatIndex::cpu_cycles:
+			return "CPU Cycles (M/s)";
+		case StatIndex::cpu_instructions:
+			return "CPU Instructions (M/s)";
+		case StatIndex::cpu_cache_miss_ratio:
+			return "Cache Miss Ratio (%)";
+		case StatIndex::cpu_branch_miss_ratio:
+			return "Branch Miss Ratio (%)";
+		case StatIndex::cpu_l1_accesses:
+			return "CPU L1 Accesses (M/s)";
+		case StatIndex::cpu_instr_retired:
+			return "CPU Instructions Retired (M/s)";
+		case StatIndex::cpu_l2_accesses:
+			return "CPU L2 Accesses (M/s)";
+		case StatIndex::cpu_l3_accesses:
+			return "CPU L3 Accesses (M/s)";
+		case StatIndex::cpu_bus_reads:
+			return "CPU Bus Read Beats (M/s)";
+		case StatIndex::cpu_bus_writes:
+			return "CPU Bus Write Beats (M/s)";
+		case StatIndex::cpu_mem_reads:
+			return "CPU Memory Read Instructions (M/s)";
+		case StatIndex::cpu_mem_writes:
+			return "CPU Memory Write Instructions (M/s)";
+		case StatIndex::cpu_ase_spec:
+			return "CPU Speculatively Exec. SIMD Instructions (M/s)";
+		case StatIndex::cpu_vfp_spec:
+			return "CPU Speculatively Exec. FP Instructions (M/s)";
+		case StatIndex::cpu_crypto_spec:
+			return "CPU Speculatively Exec. Crypto Instructions (M/s)";
+		case StatIndex::gpu_cycles:
+			return "GPU Cycles (M/s)";
+		case StatIndex::gpu_vertex_cycles:
+			return "Vertex Cycles (M/s)";
+		case StatIndex::gpu_load_store_cycles:
+			return "Load Store Cycles (k/s)";
+		case StatIndex::gpu_tiles:
+			return "Tiles (k/s)";
+		case StatIndex::gpu_killed_tiles:
+			return "Tiles killed by CRC match (k/s)";
+		case StatIndex::gpu_fragment_jobs:
+			return "Fragment Jobs (s)";
+		case StatIndex::gpu_fragment_cycles:
+			return "Fragment Cycles (M/s)";
+		case StatIndex::gpu_tex_cycles:
+			return "Shader Texture Cycles (k/s)";
+		case StatIndex::gpu_ext_reads:
+			return "External Reads (M/s)";
+		case StatIndex::gpu_ext_writes:
+			return "External Writes (M/s)";
+		case StatIndex::gpu_ext_read_stalls:
+			return "External Read Stalls (M/s)";
+		case StatIndex::gpu_ext_write_stalls:
+			return "External Write Stalls (M/s)";
+		case StatIndex::gpu_ext_read_bytes:
+			return "External Read Bytes (MiB/s)";
+		case StatIndex::gpu_ext_write_bytes:
+			return "External Write Bytes (MiB/s)";
+		case StatIndex::resource_cache_lookups:
+			return "Resource Cache Lookups (/s)";
+		case StatIndex::resource_cache_misses:
+			return "Resource Cache Misses (/s)";
+		case StatIndex::resource_cache_hit_ratio:
+			return "Resource Cache Hit Ratio (%)";
+		case StatIndex::resource_cache_build_time:
+			return "Resource Cache Build Time (ms/s)";
+		case StatIndex::resource_cache_lock_wait_time:
+			return "Resource Cache Lock Wait Time (ms/s)";
+		case StatIndex::gpu_pass_time_0:
+			return "GPU Pass 0 Time (ms)";
+		case StatIndex::gpu_pass_time_1:
+			return "GPU Pass 1 Time (ms)";
+		case StatIndex::gpu_pass_time_2:
+			return "GPU Pass 2 Time (ms)";
+		case StatIndex::gpu_pass_time_3:
+			return "GPU Pass 3 Time (ms)";
+		case StatIndex::gpu_pass_time_4:
+			return "GPU Pass 4 Time (ms)";
+		case StatIndex::gpu_pass_time_5:
+			return "GPU Pass 5 Time (ms)";
+		case StatIndex::gpu_pass_time_6:
+			return "GPU Pass 6 Time (ms)";
+		case StatIndex::gpu_pass_time_7:
+			return "GPU Pass 7 Time (ms)";
+		case StatIndex::visible_objects:
+			return "Visible Objects (per frame)";
+		case StatIndex::culled_objects:
+			return "Culled Objects (per frame)";
+		default:
+			return nullptr;
+	}
+}
+}        // namespace
+
 Stats::Stats(RenderContext &render_context, size_t buffer_size) :
     render_context(render_context),
     buffer_size(buffer_size)
@@ -75,6 +181,9 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 #endif
 	providers.emplace_back(std::make_unique<VulkanStatsProvider>(stats, sampling_config, render_context));
+	providers.emplace_back(std::make_unique<ResourceCacheStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<GpuProfilerStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<CullingStatsProvider>(stats));
 
 	// In continuous sampling mode we still need to update the frame times as if we are polling
 	// Store the frame time provider here so we can easily access it later.
@@ -83,6 +192,14 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	for (const auto &stat : requested_stats)
 	{
 		counters[stat] = std::vector<float>(buffer_size, 0);
+
+#if VKB_PROFILING
+		// Resolve the plots once, so that pushing the counters does not look them up every frame
+		if (auto *index_name = to_string(stat))
+		{
+			counter_plots.emplace(stat, Plot<float>{index_name});
+		}
+#endif
 	}
 
 	if (sampling_config.mode == CounterSamplingMode::Continuous)
@@ -291,80 +408,7 @@ void Stats::push_sample(const StatsProvider::Counters &sample)
 	}
 }
 
-namespace
-{
-// For now names are taken from the stats_provider.cpp file
-const char *to_string(StatIndex index)
-{
-	switch (index)
-	{
-		case StatIndex::frame_times:
-			return "Frame Times (ms)";
-		case StatIndex::cpu_cycles:
-			return "CPU Cycles (M/s)";
-		case StatIndex::cpu_instructions:
-			return "CPU Instructions (M/s)";
-		case StatIndex::cpu_cache_miss_ratio:
-			return "Cache Miss Ratio (%)";
-		case StatIndex::cpu_branch_miss_ratio:
-			return "Branch Miss Ratio (%)";
-		case StatIndex::cpu_l1_accesses:
-			return "CPU L1 Accesses (M/s)";
-		case StatIndex::cpu_instr_retired:
-			return "CPU Instructions Retired (M/s)";
-		case StatIndex::cpu_l2_accesses:
-			return "CPU L2 Accesses (M/s)";
-		case StatIndex::cpu_l3_accesses:
-			return "CPU L3 Accesses (M/s)";
-		case StatIndex::cpu_bus_reads:
-			return "CPU Bus Read Beats (M/s)";
-		case StatIndex::cpu_bus_writes:
-			return "CPU Bus Write Beats (M/s)";
-		case StatIndex::cpu_mem_reads:
-			return "CPU Memory Read Instructions (M/s)";
-		case StatIndex::cpu_mem_writes:
-			return "CPU Memory Write Instructions (M/s)";
-		case StatIndex::cpu_ase_spec:
-			return "CPU Speculatively Exec. SIMD Instructions (M/s)";
-		case StatIndex::cpu_vfp_spec:
-			return "CPU Speculatively Exec. FP Instructions (M/s)";
-		case StatIndex::cpu_crypto_spec:
-			return "CPU Speculatively Exec. Crypto Instructions (M/s)";
-		case StatIndex::gpu_cycles:
-			return "GPU Cycles (M/s)";
-		case StatIndex::gpu_vertex_cycles:
-			return "Vertex Cycles (M/s)";
-		case StatIndex::gpu_load_store_cycles:
-			return "Load Store Cycles (k/s)";
-		case StatIndex::gpu_tiles:
-			return "Tiles (k/s)";
-		case StatIndex::gpu_killed_tiles:
-			return "Tiles killed by CRC match (k/s)";
-		case StatIndex::gpu_fragment_jobs:
-			return "Fragment Jobs (s)";
-		case StatIndex::gpu_fragment_cycles:
-			return "Fragment Cycles (M/s)";
-		case StatIndex::gpu_tex_cycles:
-			return "Shader Texture Cycles (k/s)";
-		case StatIndex::gpu_ext_reads:
-			return "External Reads (M/s)";
-		case StatIndex::gpu_ext_writes:
-			return "External Writes (M/s)";
-		case StatIndex::gpu_ext_read_stalls:
-			return "External Read Stalls (M/s)";
-		case StatIndex::gpu_ext_write_stalls:
-			return "External Write Stalls (M/s)";
-		case StatIndex::gpu_ext_read_bytes:
-			return "External Read Bytes (MiB/s)";
-		case StatIndex::gpu_ext_write_bytes:
-			return "External Write Bytes (MiB/s)";
-		default:
-			return nullptr;
-	}
-}
-}        // namespace
-
-void Stats::profile_counters() const
+void Stats::profile_counters()
 {
 #if VKB_PROFILING
 	static std::chrono::high_resolution_clock::time_point last_time = std::chrono::high_resolution_clock::now();
@@ -377,30 +421,28 @@ void Stats::profile_counters() const
 
 	last_time = now;
 
-	for (auto &c : counters)
+	for (auto &c : counter_plots)
 	{
 		StatIndex idx        = c.first;
 		auto     &graph_data = get_graph_data(idx);
+		auto     &values     = counters.at(idx);
 
-		if (c.second.empty())
+		if (values.empty())
 		{
 			continue;
 		}
 
 		float average = 0.0f;
-		for (auto &v : c.second)
+		for (auto &v : values)
 		{
 			average += v;
 		}
-		average /= c.second.size();
+		average /= values.size();
 
-		if (auto *index_name = to_string(idx))
-		{
-			Plot<float>::plot(index_name, average * graph_data.scale_factor);
-		}
+		c.second.plot(average * graph_data.scale_factor);
 	}
 
-	static std::vector<std::string> labels;
+	static std::vector<Plot<float, PlotType::Memory>> heap_plots;
 
 	auto        &device    = render_context.get_device();
 	VmaAllocator allocator = allocated::get_memory_allocator();
@@ -408,24 +450,25 @@ void Stats::profile_counters() const
 	VmaBudget heap_budgets[VK_MAX_MEMORY_HEAPS];
 	vmaGetHeapBudgets(allocator, heap_budgets);
 
-	// We know that we will only ever have one device in the system, so we can cache the labels
-	if (labels.size() == 0)
+	// We know that we will only ever have one device in the system, so we can cache the plots
+	if (heap_plots.size() == 0)
 	{
 		VkPhysicalDeviceMemoryProperties memory_properties;
 		vkGetPhysicalDeviceMemoryProperties(device.get_gpu().get_handle(), &memory_properties);
 
-		labels.reserve(memory_properties.memoryHeapCount);
+		heap_plots.reserve(memory_properties.memoryHeapCount);
 
 		for (size_t heap = 0; heap < memory_properties.memoryHeapCount; heap++)
 		{
 			VkMemoryPropertyFlags flags = memory_properties.memoryHeaps[heap].flags;
-			labels.push_back("Heap " + std::to_string(heap) + " " + vk::to_string(vk::MemoryPropertyFlags{flags}));
+			std::string           label = "Heap " + std::to_string(heap) + " " + vk::to_string(vk::MemoryPropertyFlags{flags});
+			heap_plots.emplace_back(label.c_str());
 		}
 	}
 
-	for (size_t heap = 0; heap < labels.size(); heap++)
+	for (size_t heap = 0; heap < heap_plots.size(); heap++)
 	{
-		Plot<float, PlotType::Memory>::plot(labels[heap].c_str(), heap_budgets[heap].usage / (1024.0f * 1024.0f));
+		heap_plots[heap].plot(heap_budgets[heap].usage / (1024.0f * 1024.0f));
 	}
 #endif
 }
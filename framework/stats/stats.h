@@ -25,6 +25,7 @@
 #include <set>
 #include <vector>
 
+#include "core/util/profiling.hpp"
 #include "stats_common.h"
 #include "stats_provider.h"
 #include "timer.h"
@@ -164,6 +165,9 @@ class Stats
 	/// Circular buffers for counter data
 	std::map<StatIndex, std::vector<float>> counters{};
 
+	/// Plots of the counters pushed to external profilers, resolved when the stats are requested
+	std::map<StatIndex, Plot<float>> counter_plots{};
+
 	/// Worker thread for continuous sampling
 	std::thread worker_thread;
 
@@ -193,7 +197,7 @@ class Stats
 	void push_sample(const StatsProvider::Counters &sample);
 
 	// Push counters to external profilers
-	void profile_counters() const;
+	void profile_counters();
 };
 
 }        // namespace vkb
@@ -63,6 +63,24 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+
+	resource_cache_lookups,
+	resource_cache_misses,
+	resource_cache_hit_ratio,
+	resource_cache_build_time,
+	resource_cache_lock_wait_time,
+
+	gpu_pass_time_0,
+	gpu_pass_time_1,
+	gpu_pass_time_2,
+	gpu_pass_time_3,
+	gpu_pass_time_4,
+	gpu_pass_time_5,
+	gpu_pass_time_6,
+	gpu_pass_time_7,
+
+	visible_objects,
+	culled_objects,
 };
 
 struct StatIndexHash
@@ -54,6 +54,24 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+
+    {StatIndex::resource_cache_lookups,        {"Resource Cache Lookups",              "{:4.0f}/s"}},
+    {StatIndex::resource_cache_misses,         {"Resource Cache Misses",               "{:4.0f}/s"}},
+    {StatIndex::resource_cache_hit_ratio,      {"Resource Cache Hit Ratio",            "{:3.1f}%",      100.0f,                       true,     100.0f}},
+    {StatIndex::resource_cache_build_time,     {"Resource Cache Build Time",           "{:3.1f} ms/s",  1000.0f}},
+    {StatIndex::resource_cache_lock_wait_time, {"Resource Cache Lock Wait Time",       "{:3.1f} ms/s",  1000.0f}},
+
+    {StatIndex::gpu_pass_time_0,               {"GPU Pass 0",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_1,               {"GPU Pass 1",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_2,               {"GPU Pass 2",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_3,               {"GPU Pass 3",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_4,               {"GPU Pass 4",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_5,               {"GPU Pass 5",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_6,               {"GPU Pass 6",                          "{:3.2f} ms",    1000.0f}},
+    {StatIndex::gpu_pass_time_7,               {"GPU Pass 7",                          "{:3.2f} ms",    1000.0f}},
+
+    {StatIndex::visible_objects,               {"Visible Objects",                     "{:4.0f}"}},
+    {StatIndex::culled_objects,                {"Culled Objects",                      "{:4.0f}"}},
     // clang-format on
 };
 
@@ -0,0 +1,182 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timeline_semaphore.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/device.h"
+
+namespace vkb
+{
+TimelineSemaphore::TimelineSemaphore(Device &device) :
+    device{device}
+{
+	VkSemaphoreTypeCreateInfoKHR type_create_info{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR};
+	type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+	type_create_info.initialValue  = 0;
+
+	VkSemaphoreCreateInfo create_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+	create_info.pNext = &type_create_info;
+
+	VkResult result = vkCreateSemaphore(device.get_handle(), &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw std::runtime_error("Failed to create timeline semaphore.");
+	}
+}
+
+TimelineSemaphore::~TimelineSemaphore()
+{
+	if (handle != VK_NULL_HANDLE)
+	{
+		vkDestroySemaphore(device.get_handle(), handle, nullptr);
+	}
+}
+
+VkSemaphore TimelineSemaphore::get_handle() const
+{
+	return handle;
+}
+
+uint64_t TimelineSemaphore::submit(VkQueue queue, const VkSubmitInfo &submit_info, VkFence fence)
+{
+	return submit_impl(queue, submit_info, nullptr, 0, 0, fence);
+}
+
+uint64_t TimelineSemaphore::submit(VkQueue queue, const VkSubmitInfo &submit_info, const TimelineSemaphore &wait_semaphore, uint64_t wait_value, VkPipelineStageFlags wait_stage_mask, VkFence fence)
+{
+	return submit_impl(queue, submit_info, &wait_semaphore, wait_value, wait_stage_mask, fence);
+}
+
+uint64_t TimelineSemaphore::submit_impl(VkQueue queue, const VkSubmitInfo &submit_info, const TimelineSemaphore *wait_semaphore, uint64_t wait_value, VkPipelineStageFlags wait_stage_mask, VkFence fence)
+{
+	assert(submit_info.pNext == nullptr && "The submit info must not have a structure chain");
+
+	// Binary semaphores ignore their value, but the signal values must match the signal semaphores
+	std::array<VkSemaphore, 8> signal_semaphores{};
+	std::array<uint64_t, 8>    signal_values{};
+
+	if (submit_info.signalSemaphoreCount >= signal_semaphores.size())
+	{
+		throw std::runtime_error("Too many signal semaphores for a tracked submission.");
+	}
+
+	std::copy_n(submit_info.pSignalSemaphores, submit_info.signalSemaphoreCount, signal_semaphores.begin());
+	signal_semaphores[submit_info.signalSemaphoreCount] = handle;
+
+	VkTimelineSemaphoreSubmitInfoKHR timeline_info{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+	timeline_info.signalSemaphoreValueCount = submit_info.signalSemaphoreCount + 1;
+	timeline_info.pSignalSemaphoreValues    = signal_values.data();
+
+	VkSubmitInfo tracked_submit_info         = submit_info;
+	tracked_submit_info.pNext                = &timeline_info;
+	tracked_submit_info.signalSemaphoreCount = submit_info.signalSemaphoreCount + 1;
+	tracked_submit_info.pSignalSemaphores    = signal_semaphores.data();
+
+	// The wait on the other timeline semaphore is appended to the wait semaphores of the submission
+	std::array<VkSemaphore, 8>          wait_semaphores{};
+	std::array<uint64_t, 8>             wait_values{};
+	std::array<VkPipelineStageFlags, 8> wait_stage_masks{};
+
+	if (wait_semaphore)
+	{
+		if (submit_info.waitSemaphoreCount >= wait_semaphores.size())
+		{
+			throw std::runtime_error("Too many wait semaphores for a tracked submission.");
+		}
+
+		std::copy_n(submit_info.pWaitSemaphores, submit_info.waitSemaphoreCount, wait_semaphores.begin());
+		std::copy_n(submit_info.pWaitDstStageMask, submit_info.waitSemaphoreCount, wait_stage_masks.begin());
+		wait_semaphores[submit_info.waitSemaphoreCount]  = wait_semaphore->get_handle();
+		wait_values[submit_info.waitSemaphoreCount]      = wait_value;
+		wait_stage_masks[submit_info.waitSemaphoreCount] = wait_stage_mask;
+
+		timeline_info.waitSemaphoreValueCount = submit_info.waitSemaphoreCount + 1;
+		timeline_info.pWaitSemaphoreValues    = wait_values.data();
+
+		tracked_submit_info.waitSemaphoreCount = submit_info.waitSemaphoreCount + 1;
+		tracked_submit_info.pWaitSemaphores    = wait_semaphores.data();
+		tracked_submit_info.pWaitDstStageMask  = wait_stage_masks.data();
+	}
+
+	std::lock_guard<std::mutex> guard(submit_mutex);
+
+	uint64_t value = submitted_value + 1;
+
+	signal_values[submit_info.signalSemaphoreCount] = value;
+
+	VK_CHECK(vkQueueSubmit(queue, 1, &tracked_submit_info, fence));
+
+	submitted_value = value;
+
+	return value;
+}
+
+uint64_t TimelineSemaphore::get_submitted_value() const
+{
+	return submitted_value;
+}
+
+uint64_t TimelineSemaphore::get_completed_value()
+{
+	uint64_t value{0};
+	VK_CHECK(vkGetSemaphoreCounterValueKHR(device.get_handle(), handle, &value));
+
+	update_completed_value(value);
+
+	return value;
+}
+
+bool TimelineSemaphore::is_complete(uint64_t value)
+{
+	return value <= completed_value || value <= get_completed_value();
+}
+
+VkResult TimelineSemaphore::wait(uint64_t value, uint64_t timeout)
+{
+	if (value <= completed_value)
+	{
+		return VK_SUCCESS;
+	}
+
+	VkSemaphoreWaitInfoKHR wait_info{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR};
+	wait_info.semaphoreCount = 1;
+	wait_info.pSemaphores    = &handle;
+	wait_info.pValues        = &value;
+
+	VkResult result = vkWaitSemaphoresKHR(device.get_handle(), &wait_info, timeout);
+
+	if (result == VK_SUCCESS)
+	{
+		update_completed_value(value);
+	}
+
+	return result;
+}
+
+void TimelineSemaphore::update_completed_value(uint64_t value)
+{
+	// Other threads may have observed a more recent value in the meantime
+	uint64_t known_value = completed_value;
+	while (known_value < value && !completed_value.compare_exchange_weak(known_value, value))
+	{
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,124 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief A timeline semaphore tracking the work submitted to a queue
+ *
+ * Each tracked submission signals the next value of the semaphore, so a single value is enough
+ * to know whether a submission and all the ones before it on the queue completed.
+ * Values can be polled without blocking, unlike fences they never need to be reset.
+ * Requires VK_KHR_timeline_semaphore and its timelineSemaphore feature.
+ */
+class TimelineSemaphore
+{
+  public:
+	TimelineSemaphore(Device &device);
+
+	TimelineSemaphore(const TimelineSemaphore &) = delete;
+
+	TimelineSemaphore(TimelineSemaphore &&other) = delete;
+
+	~TimelineSemaphore();
+
+	TimelineSemaphore &operator=(const TimelineSemaphore &) = delete;
+
+	TimelineSemaphore &operator=(TimelineSemaphore &&) = delete;
+
+	VkSemaphore get_handle() const;
+
+	/**
+	 * @brief Submits work to a queue, with a signal operation of the next value of the semaphore appended
+	 *        The submit info must not chain a VkTimelineSemaphoreSubmitInfo, nor wait on timeline semaphores (see the overload below)
+	 * @param queue The queue tracked by the semaphore
+	 * @param submit_info The work to submit
+	 * @param fence An optional fence to signal as well
+	 * @return The value signaled once the work is complete
+	 */
+	uint64_t submit(VkQueue queue, const VkSubmitInfo &submit_info, VkFence fence = VK_NULL_HANDLE);
+
+	/**
+	 * @brief Same as submit, but the work also waits for another timeline semaphore to reach a value
+	 *        Used to chain work across queues, for instance to use resources uploaded on a transfer queue
+	 * @param queue The queue tracked by the semaphore
+	 * @param submit_info The work to submit
+	 * @param wait_semaphore The timeline semaphore to wait on, usually the one tracking another queue
+	 * @param wait_value The value to wait for
+	 * @param wait_stage_mask The stages of the work which wait for the value
+	 * @param fence An optional fence to signal as well
+	 * @return The value signaled once the work is complete
+	 */
+	uint64_t submit(VkQueue                  queue,
+	                const VkSubmitInfo      &submit_info,
+	                const TimelineSemaphore &wait_semaphore,
+	                uint64_t                 wait_value,
+	                VkPipelineStageFlags     wait_stage_mask,
+	                VkFence                  fence = VK_NULL_HANDLE);
+
+	/**
+	 * @return The last value handed out by submit
+	 */
+	uint64_t get_submitted_value() const;
+
+	/**
+	 * @brief Queries the current value of the semaphore, without blocking
+	 */
+	uint64_t get_completed_value();
+
+	/**
+	 * @return True if the work which signals the value completed, without blocking
+	 */
+	bool is_complete(uint64_t value);
+
+	/**
+	 * @brief Waits for the semaphore to reach a value
+	 * @param value The value to wait for
+	 * @param timeout The timeout in nanoseconds
+	 * @return VK_SUCCESS, or VK_TIMEOUT if the value was not reached in time
+	 */
+	VkResult wait(uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max());
+
+  private:
+	uint64_t submit_impl(VkQueue queue, const VkSubmitInfo &submit_info, const TimelineSemaphore *wait_semaphore, uint64_t wait_value, VkPipelineStageFlags wait_stage_mask, VkFence fence);
+
+	void update_completed_value(uint64_t value);
+
+	Device &device;
+
+	VkSemaphore handle{VK_NULL_HANDLE};
+
+	/// Guards the order of values and submissions, values must be signaled in increasing order
+	std::mutex submit_mutex;
+
+	std::atomic<uint64_t> submitted_value{0};
+
+	/// Last value known to be reached, to avoid querying the semaphore for older values
+	std::atomic<uint64_t> completed_value{0};
+};
+}        // namespace vkb
@@ -0,0 +1,488 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "upload_manager.h"
+
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "core/device.h"
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @return The index of a queue family supporting transfers but neither graphics nor compute,
+ *         with no restriction on the granularity of image copies
+ */
+int32_t find_transfer_only_queue_family(const PhysicalDevice &gpu)
+{
+	const auto &queue_family_properties = gpu.get_queue_family_properties();
+
+	for (uint32_t i = 0; i < to_u32(queue_family_properties.size()); i++)
+	{
+		const auto &properties = queue_family_properties[i];
+		const auto &extent     = properties.minImageTransferGranularity;
+
+		if ((properties.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+		    !(properties.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) &&
+		    extent.width == 1 && extent.height == 1 && extent.depth == 1)
+		{
+			return static_cast<int32_t>(i);
+		}
+	}
+
+	return -1;
+}
+}        // namespace
+
+UploadManager::UploadManager(Device &device, VkDeviceSize staging_size) :
+    device{device},
+    graphics_queue{device.get_suitable_graphics_queue()}
+{
+	// Ownership transfers to the graphics queue are chained with timeline semaphores
+	if (device.has_timeline_semaphores())
+	{
+		int32_t transfer_family_index = find_transfer_only_queue_family(device.get_gpu());
+
+		if (transfer_family_index >= 0)
+		{
+			transfer_queue = &device.get_queue(static_cast<uint32_t>(transfer_family_index), 0);
+		}
+	}
+
+	graphics_command_pool = device.create_command_pool(graphics_queue.get_family_index(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+	if (transfer_queue)
+	{
+		transfer_command_pool = device.create_command_pool(transfer_queue->get_family_index(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+		LOGI("Uploads use the dedicated transfer queue family {}", transfer_queue->get_family_index());
+	}
+	else
+	{
+		transfer_command_pool = graphics_command_pool;
+	}
+
+	staging_buffer = std::make_unique<core::BufferC>(device,
+	                                                 staging_size,
+	                                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	                                                 VMA_MEMORY_USAGE_CPU_ONLY,
+	                                                 VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+	staging_buffer->set_debug_name("upload manager staging ring");
+
+	current_batch.token = 1;
+}
+
+UploadManager::~UploadManager()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	flush_batch();
+
+	while (!batches_in_flight.empty())
+	{
+		retire_batches(true);
+	}
+
+	if (transfer_command_pool != graphics_command_pool)
+	{
+		vkDestroyCommandPool(device.get_handle(), transfer_command_pool, nullptr);
+	}
+	vkDestroyCommandPool(device.get_handle(), graphics_command_pool, nullptr);
+}
+
+UploadManager::Token UploadManager::upload_buffer(core::BufferC       &buffer,
+                                                  const void          *data,
+                                                  VkDeviceSize         size,
+                                                  VkDeviceSize         offset,
+                                                  VkPipelineStageFlags dst_stage_mask,
+                                                  VkAccessFlags        dst_access_mask)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto staging = stage(data, size, 4);
+
+	begin_batch();
+
+	VkBufferCopy copy_region{staging.second, offset, size};
+	vkCmdCopyBuffer(current_batch.transfer_command_buffer, staging.first, buffer.get_handle(), 1, &copy_region);
+
+	VkBufferMemoryBarrier barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+	barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask       = dst_access_mask;
+	barrier.srcQueueFamilyIndex = transfer_queue ? transfer_queue->get_family_index() : VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = transfer_queue ? graphics_queue.get_family_index() : VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer              = buffer.get_handle();
+	barrier.offset              = offset;
+	barrier.size                = size;
+
+	current_batch.buffer_barriers.push_back(barrier);
+	current_batch.dst_stage_mask |= dst_stage_mask;
+
+	return current_batch.token;
+}
+
+UploadManager::Token UploadManager::upload_image(VkImage                               image,
+                                                 VkFormat                              format,
+                                                 const std::vector<uint8_t>           &data,
+                                                 const std::vector<VkBufferImageCopy> &regions,
+                                                 const VkImageSubresourceRange        &subresource_range,
+                                                 VkPipelineStageFlags                  dst_stage_mask,
+                                                 VkAccessFlags                         dst_access_mask)
+{
+	// Buffer offsets of copies to an image must be multiples of both the texel block size and 4
+	VkDeviceSize block_size = get_texel_block_size(format);
+	VkDeviceSize alignment  = block_size > 0 ? std::lcm(block_size, VkDeviceSize{4}) : 16;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto staging = stage(data.data(), data.size(), alignment);
+
+	begin_batch();
+
+	VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+	barrier.srcAccessMask       = 0;
+	barrier.dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image               = image;
+	barrier.subresourceRange    = subresource_range;
+
+	vkCmdPipelineBarrier(current_batch.transfer_command_buffer,
+	                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+	                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                     0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	std::vector<VkBufferImageCopy> staging_regions{regions};
+	for (auto &region : staging_regions)
+	{
+		region.bufferOffset += staging.second;
+	}
+
+	vkCmdCopyBufferToImage(current_batch.transfer_command_buffer,
+	                       staging.first,
+	                       image,
+	                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	                       to_u32(staging_regions.size()),
+	                       staging_regions.data());
+
+	barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask       = dst_access_mask;
+	barrier.oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.srcQueueFamilyIndex = transfer_queue ? transfer_queue->get_family_index() : VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = transfer_queue ? graphics_queue.get_family_index() : VK_QUEUE_FAMILY_IGNORED;
+
+	current_batch.image_barriers.push_back(barrier);
+	current_batch.dst_stage_mask |= dst_stage_mask;
+
+	return current_batch.token;
+}
+
+UploadManager::Token UploadManager::flush()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return flush_batch();
+}
+
+bool UploadManager::is_complete(Token token)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (token >= current_batch.token)
+	{
+		return false;
+	}
+
+	retire_batches(false);
+
+	return batches_in_flight.empty() || token < batches_in_flight.front().token;
+}
+
+void UploadManager::wait(Token token)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (token >= current_batch.token)
+	{
+		flush_batch();
+	}
+
+	while (!batches_in_flight.empty() && token >= batches_in_flight.front().token)
+	{
+		retire_batches(true);
+	}
+}
+
+bool UploadManager::has_dedicated_transfer_queue() const
+{
+	return transfer_queue != nullptr;
+}
+
+void UploadManager::begin_batch()
+{
+	if (current_batch.transfer_command_buffer != VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	current_batch.transfer_command_buffer = allocate_command_buffer(transfer_command_pool);
+
+	VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	VK_CHECK(vkBeginCommandBuffer(current_batch.transfer_command_buffer, &begin_info));
+}
+
+std::pair<VkBuffer, VkDeviceSize> UploadManager::stage(const void *data, VkDeviceSize size, VkDeviceSize alignment)
+{
+	auto ring_size = staging_buffer->get_size();
+
+	if (size > ring_size)
+	{
+		current_batch.dedicated_staging_buffers.push_back(
+		    std::make_unique<core::BufferC>(core::BufferC::create_staging_buffer(device, size, data)));
+
+		return {current_batch.dedicated_staging_buffers.back()->get_handle(), 0};
+	}
+
+	retire_batches(false);
+
+	uint64_t offset = (ring_head + alignment - 1) / alignment * alignment;
+
+	// Allocations never wrap around the end of the staging buffer
+	if (offset % ring_size + size > ring_size)
+	{
+		offset = (offset / ring_size + 1) * ring_size;
+	}
+
+	// Make room by releasing the oldest batches, including the current one if needed
+	while (offset + size - ring_tail > ring_size)
+	{
+		if (batches_in_flight.empty() && current_batch.transfer_command_buffer == VK_NULL_HANDLE)
+		{
+			ring_tail = offset;
+			break;
+		}
+
+		flush_batch();
+		retire_batches(true);
+	}
+
+	ring_head = offset + size;
+
+	auto staging_offset = offset % ring_size;
+
+	std::memcpy(staging_buffer->map() + staging_offset, data, static_cast<size_t>(size));
+	staging_buffer->flush(staging_offset, size);
+
+	return {staging_buffer->get_handle(), staging_offset};
+}
+
+UploadManager::Token UploadManager::flush_batch()
+{
+	Token token = current_batch.token;
+
+	if (current_batch.transfer_command_buffer == VK_NULL_HANDLE)
+	{
+		// Nothing was recorded, the token is complete as soon as the previous batches are
+		return token - 1;
+	}
+
+	Batch batch = std::move(current_batch);
+
+	current_batch       = {};
+	current_batch.token = token + 1;
+
+	batch.ring_end = ring_head;
+
+	if (transfer_queue)
+	{
+		// Release the ownership of the resources, the access and stage masks of the destination are ignored
+		auto release_buffer_barriers = batch.buffer_barriers;
+		for (auto &barrier : release_buffer_barriers)
+		{
+			barrier.dstAccessMask = 0;
+		}
+
+		auto release_image_barriers = batch.image_barriers;
+		for (auto &barrier : release_image_barriers)
+		{
+			barrier.dstAccessMask = 0;
+		}
+
+		vkCmdPipelineBarrier(batch.transfer_command_buffer,
+		                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                     0,
+		                     0, nullptr,
+		                     to_u32(release_buffer_barriers.size()), release_buffer_barriers.data(),
+		                     to_u32(release_image_barriers.size()), release_image_barriers.data());
+	}
+	else
+	{
+		vkCmdPipelineBarrier(batch.transfer_command_buffer,
+		                     VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                     batch.dst_stage_mask,
+		                     0,
+		                     0, nullptr,
+		                     to_u32(batch.buffer_barriers.size()), batch.buffer_barriers.data(),
+		                     to_u32(batch.image_barriers.size()), batch.image_barriers.data());
+	}
+
+	VK_CHECK(vkEndCommandBuffer(batch.transfer_command_buffer));
+
+	VkSubmitInfo submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &batch.transfer_command_buffer;
+
+	if (transfer_queue)
+	{
+		uint64_t transfer_value = device.submit_and_track(*transfer_queue, submit_info);
+
+		// Acquire the ownership of the resources, the access and stage masks of the source are ignored
+		for (auto &barrier : batch.buffer_barriers)
+		{
+			barrier.srcAccessMask = 0;
+		}
+		for (auto &barrier : batch.image_barriers)
+		{
+			barrier.srcAccessMask = 0;
+		}
+
+		batch.acquire_command_buffer = allocate_command_buffer(graphics_command_pool);
+
+		VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+		begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		VK_CHECK(vkBeginCommandBuffer(batch.acquire_command_buffer, &begin_info));
+
+		vkCmdPipelineBarrier(batch.acquire_command_buffer,
+		                     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		                     batch.dst_stage_mask,
+		                     0,
+		                     0, nullptr,
+		                     to_u32(batch.buffer_barriers.size()), batch.buffer_barriers.data(),
+		                     to_u32(batch.image_barriers.size()), batch.image_barriers.data());
+
+		VK_CHECK(vkEndCommandBuffer(batch.acquire_command_buffer));
+
+		submit_info.pCommandBuffers = &batch.acquire_command_buffer;
+
+		batch.timeline_value = device.get_timeline_semaphore(graphics_queue)
+		                           .submit(graphics_queue.get_handle(),
+		                                   submit_info,
+		                                   device.get_timeline_semaphore(*transfer_queue),
+		                                   transfer_value,
+		                                   VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+	}
+	else if (device.has_timeline_semaphores())
+	{
+		batch.timeline_value = device.submit_and_track(graphics_queue, submit_info);
+	}
+	else
+	{
+		VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+		VK_CHECK(vkCreateFence(device.get_handle(), &fence_info, nullptr, &batch.fence));
+
+		VK_CHECK(vkQueueSubmit(graphics_queue.get_handle(), 1, &submit_info, batch.fence));
+	}
+
+	// The barriers are not needed anymore, only the resources released once the batch completed are kept
+	batch.buffer_barriers.clear();
+	batch.image_barriers.clear();
+
+	batches_in_flight.push_back(std::move(batch));
+
+	return token;
+}
+
+bool UploadManager::is_batch_complete(Batch &batch)
+{
+	if (batch.fence != VK_NULL_HANDLE)
+	{
+		return vkGetFenceStatus(device.get_handle(), batch.fence) == VK_SUCCESS;
+	}
+
+	return device.is_complete(graphics_queue, batch.timeline_value);
+}
+
+void UploadManager::wait_batch(Batch &batch)
+{
+	if (batch.fence != VK_NULL_HANDLE)
+	{
+		VK_CHECK(vkWaitForFences(device.get_handle(), 1, &batch.fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+	}
+	else
+	{
+		device.wait_for(graphics_queue, batch.timeline_value);
+	}
+}
+
+void UploadManager::retire_batches(bool wait)
+{
+	while (!batches_in_flight.empty())
+	{
+		auto &batch = batches_in_flight.front();
+
+		if (wait)
+		{
+			wait_batch(batch);
+			wait = false;
+		}
+		else if (!is_batch_complete(batch))
+		{
+			break;
+		}
+
+		vkFreeCommandBuffers(device.get_handle(), transfer_command_pool, 1, &batch.transfer_command_buffer);
+
+		if (batch.acquire_command_buffer != VK_NULL_HANDLE)
+		{
+			vkFreeCommandBuffers(device.get_handle(), graphics_command_pool, 1, &batch.acquire_command_buffer);
+		}
+
+		if (batch.fence != VK_NULL_HANDLE)
+		{
+			vkDestroyFence(device.get_handle(), batch.fence, nullptr);
+		}
+
+		ring_tail = batch.ring_end;
+
+		batches_in_flight.pop_front();
+	}
+}
+
+VkCommandBuffer UploadManager::allocate_command_buffer(VkCommandPool command_pool)
+{
+	VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+	allocate_info.commandPool        = command_pool;
+	allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocate_info.commandBufferCount = 1;
+
+	VkCommandBuffer command_buffer{VK_NULL_HANDLE};
+	VK_CHECK(vkAllocateCommandBuffers(device.get_handle(), &allocate_info, &command_buffer));
+
+	return command_buffer;
+}
+}        // namespace vkb
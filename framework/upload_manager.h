@@ -0,0 +1,218 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+
+namespace vkb
+{
+class Device;
+class Queue;
+
+/**
+ * @brief Uploads data to device local buffers and images, without blocking the calling thread
+ *
+ * Data is copied into a persistently mapped staging ring, and the copies are recorded into a batch.
+ * A batch is submitted by flush, or once the ring is full, and its staging memory is reused once it completed.
+ *
+ * If the device has a transfer-only queue family and supports timeline semaphores, the copies run on that queue,
+ * in parallel with the rendering. The ownership of the resources is then released by the transfer queue and
+ * acquired by the graphics queue in a second submission, which waits for the transfer one on the GPU.
+ * Otherwise the copies are submitted to the graphics queue directly.
+ *
+ * Either way, once a batch is flushed, the work submitted afterwards to the graphics queue is ordered after
+ * the uploads by the barriers of the batch. Tokens only need to be waited for to use the resources on the host,
+ * or on another queue. Flushing submits to the graphics queue, so it must happen on the thread which submits
+ * the rendering work.
+ */
+class UploadManager
+{
+  public:
+	/// Identifies the batch an upload belongs to
+	using Token = uint64_t;
+
+	static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 64 * 1024 * 1024;
+
+	/**
+	 * @param device The device to upload to
+	 * @param staging_size Size of the staging ring, larger uploads get a staging buffer of their own
+	 */
+	UploadManager(Device &device, VkDeviceSize staging_size = DEFAULT_STAGING_SIZE);
+
+	/**
+	 * @brief Flushes the pending uploads, and waits for all of them to complete
+	 */
+	~UploadManager();
+
+	UploadManager(const UploadManager &) = delete;
+
+	UploadManager(UploadManager &&) = delete;
+
+	UploadManager &operator=(const UploadManager &) = delete;
+
+	UploadManager &operator=(UploadManager &&) = delete;
+
+	/**
+	 * @brief Uploads data to a buffer, which must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT
+	 * @param buffer The buffer to upload to
+	 * @param data The data to upload, it is copied before returning
+	 * @param size The size of the data
+	 * @param offset The offset in the buffer
+	 * @param dst_stage_mask The stages which first use the buffer
+	 * @param dst_access_mask The accesses of those stages
+	 * @return The token of the batch the upload belongs to
+	 */
+	Token upload_buffer(core::BufferC       &buffer,
+	                    const void          *data,
+	                    VkDeviceSize         size,
+	                    VkDeviceSize         offset          = 0,
+	                    VkPipelineStageFlags dst_stage_mask  = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+	                    VkAccessFlags        dst_access_mask = VK_ACCESS_MEMORY_READ_BIT);
+
+	/**
+	 * @brief Uploads data to an image, which is left in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+	 *        The previous content of the image is discarded
+	 * @param image The image to upload to, it must have been created with VK_IMAGE_USAGE_TRANSFER_DST_BIT
+	 * @param format The format of the image, the data is staged at a multiple of its texel block size
+	 * @param data The data to upload, it is copied before returning
+	 * @param regions The copies to the image, with buffer offsets relative to the data
+	 * @param subresource_range The subresources of the image to transition
+	 * @param dst_stage_mask The stages which first use the image
+	 * @param dst_access_mask The accesses of those stages
+	 * @return The token of the batch the upload belongs to
+	 */
+	Token upload_image(VkImage                               image,
+	                   VkFormat                              format,
+	                   const std::vector<uint8_t>           &data,
+	                   const std::vector<VkBufferImageCopy> &regions,
+	                   const VkImageSubresourceRange        &subresource_range,
+	                   VkPipelineStageFlags                  dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                   VkAccessFlags                         dst_access_mask = VK_ACCESS_SHADER_READ_BIT);
+
+	/**
+	 * @brief Submits the uploads recorded so far
+	 * @return The token of the submitted batch
+	 */
+	Token flush();
+
+	/**
+	 * @return True if the uploads of the batch completed, without blocking
+	 */
+	bool is_complete(Token token);
+
+	/**
+	 * @brief Waits for the uploads of a batch to complete, flushing them first if needed
+	 */
+	void wait(Token token);
+
+	/**
+	 * @return True if the uploads run on a transfer-only queue
+	 */
+	bool has_dedicated_transfer_queue() const;
+
+  private:
+	struct Batch
+	{
+		Token token{0};
+
+		/// Records the copies, on the transfer queue if there is a dedicated one, or the graphics queue otherwise
+		VkCommandBuffer transfer_command_buffer{VK_NULL_HANDLE};
+
+		/// Acquires the ownership of the resources on the graphics queue, with a dedicated transfer queue only
+		VkCommandBuffer acquire_command_buffer{VK_NULL_HANDLE};
+
+		/// Barriers recorded after the copies, also used to acquire the ownership with a dedicated transfer queue
+		std::vector<VkBufferMemoryBarrier> buffer_barriers;
+
+		std::vector<VkImageMemoryBarrier> image_barriers;
+
+		VkPipelineStageFlags dst_stage_mask{0};
+
+		/// Staging buffers of the uploads too large for the ring
+		std::vector<std::unique_ptr<core::BufferC>> dedicated_staging_buffers;
+
+		/// End of the staging memory used by the batch in the ring
+		uint64_t ring_end{0};
+
+		/// Value of the timeline semaphore of the graphics queue signaled once the batch completed
+		uint64_t timeline_value{0};
+
+		/// Signaled once the batch completed, without timeline semaphores only
+		VkFence fence{VK_NULL_HANDLE};
+	};
+
+	/**
+	 * @brief Begins the command buffer of the current batch, if needed
+	 */
+	void begin_batch();
+
+	/**
+	 * @brief Copies data into the staging memory
+	 * @return The staging buffer and the offset of the data in it
+	 */
+	std::pair<VkBuffer, VkDeviceSize> stage(const void *data, VkDeviceSize size, VkDeviceSize alignment);
+
+	Token flush_batch();
+
+	bool is_batch_complete(Batch &batch);
+
+	void wait_batch(Batch &batch);
+
+	/**
+	 * @brief Releases the resources of the oldest batches in flight which completed
+	 * @param wait If true, waits for the oldest batch to complete and releases it at least
+	 */
+	void retire_batches(bool wait);
+
+	VkCommandBuffer allocate_command_buffer(VkCommandPool command_pool);
+
+	Device &device;
+
+	const Queue &graphics_queue;
+
+	/// Transfer-only queue, null if the copies run on the graphics queue
+	const Queue *transfer_queue{nullptr};
+
+	VkCommandPool transfer_command_pool{VK_NULL_HANDLE};
+
+	VkCommandPool graphics_command_pool{VK_NULL_HANDLE};
+
+	std::unique_ptr<core::BufferC> staging_buffer;
+
+	/// Offsets in the ring grow forever, the offset in the staging buffer is their remainder by its size
+	uint64_t ring_head{0};
+
+	/// Start of the staging memory still used by the batches in flight
+	uint64_t ring_tail{0};
+
+	Batch current_batch;
+
+	/// Submitted batches, in submission order
+	std::deque<Batch> batches_in_flight;
+
+	/// Guards all the above, uploads can be recorded from any thread
+	std::mutex mutex;
+};
+}        // namespace vkb
@@ -409,6 +409,11 @@ class VulkanSample : public vkb::Application
 
 	static constexpr float STATS_VIEW_RESET_TIME{10.0f};        // 10 seconds
 
+	// Bounds of the cached objects which are recreated on demand, a resize or a change of
+	// render targets leaves the previous framebuffers unused until they are evicted
+	static constexpr size_t FRAMEBUFFER_CACHE_CAPACITY{64};
+	static constexpr size_t DESCRIPTOR_SET_CACHE_CAPACITY{1024};
+
 	/**
 	 * @brief The Vulkan surface
 	 */
@@ -657,7 +662,15 @@ inline void VulkanSample<bindingType>::draw_renderpass_impl(vkb::core::HPPComman
 
 	if (gui)
 	{
-		gui->draw(command_buffer);
+		if (render_pipeline)
+		{
+			// The pipeline may have left a subpass that only accepts secondary command buffers
+			render_pipeline->draw_in_last_subpass(command_buffer, [this](vkb::core::HPPCommandBuffer &cmd_buf) { gui->draw(cmd_buf); });
+		}
+		else
+		{
+			gui->draw(command_buffer);
+		}
 	}
 
 	command_buffer.get_handle().endRenderPass();
@@ -1141,6 +1154,9 @@ inline bool VulkanSample<bindingType>::prepare(const ApplicationOptions &options
 	// initialize C++-Bindings default dispatcher, optional third step
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(device->get_handle());
 
+	device->get_resource_cache().set_framebuffer_capacity(FRAMEBUFFER_CACHE_CAPACITY);
+	device->get_resource_cache().set_descriptor_set_capacity(DESCRIPTOR_SET_CACHE_CAPACITY);
+
 	create_render_context();
 	prepare_render_context();
 
@@ -1403,6 +1419,9 @@ inline void VulkanSample<bindingType>::update_scene(float delta_time)
 				animation->update(delta_time);
 			}
 		}
+
+		// Update the world matrices changed by the scripts and animations
+		scene->update_transforms();
 	}
 }
 
@@ -29,6 +29,9 @@ HPPTextureLoading::HPPTextureLoading()
 
 	zoom     = -2.5f;
 	rotation = {0.0f, 15.0f, 0.0f};
+
+	// Each swapchain image has its own uniform buffer, so that the frames in flight are not overwritten
+	set_frame_lag(2);
 }
 
 HPPTextureLoading::~HPPTextureLoading()
@@ -47,7 +50,7 @@ HPPTextureLoading::~HPPTextureLoading()
 
 	vertex_buffer.reset();
 	index_buffer.reset();
-	vertex_shader_data_buffer.reset();
+	vertex_shader_data_buffers.clear();
 }
 
 bool HPPTextureLoading::prepare(const vkb::ApplicationOptions &options)
@@ -63,8 +66,11 @@ bool HPPTextureLoading::prepare(const vkb::ApplicationOptions &options)
 		pipeline_layout       = get_device().get_handle().createPipelineLayout({{}, descriptor_set_layout});
 		pipeline              = create_pipeline();
 		descriptor_pool       = create_descriptor_pool();
-		descriptor_set        = vkb::common::allocate_descriptor_set(get_device().get_handle(), descriptor_pool, {descriptor_set_layout});
-		update_descriptor_set();
+		for (size_t i = 0; i < draw_cmd_buffers.size(); ++i)
+		{
+			descriptor_sets.push_back(vkb::common::allocate_descriptor_set(get_device().get_handle(), descriptor_pool, {descriptor_set_layout}));
+		}
+		update_descriptor_sets();
 		build_command_buffers();
 
 		prepared = true;
@@ -116,7 +122,7 @@ void HPPTextureLoading::build_command_buffers()
 		vk::Rect2D scissor({0, 0}, extent);
 		command_buffer.setScissor(0, scissor);
 
-		command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0, descriptor_set, {});
+		command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0, descriptor_sets[i], {});
 		command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
 
 		vk::DeviceSize offset = 0;
@@ -137,10 +143,8 @@ void HPPTextureLoading::on_update_ui_overlay(vkb::Drawer &drawer)
 {
 	if (drawer.header("Settings"))
 	{
-		if (drawer.slider_float("LOD bias", &vertex_shader_data.lod_bias, 0.0f, static_cast<float>(texture.mip_levels)))
-		{
-			update_uniform_buffers();
-		}
+		// The uniform buffers are written every frame
+		drawer.slider_float("LOD bias", &vertex_shader_data.lod_bias, 0.0f, static_cast<float>(texture.mip_levels));
 	}
 }
 
@@ -152,17 +156,14 @@ void HPPTextureLoading::render(float delta_time)
 	}
 }
 
-void HPPTextureLoading::view_changed()
-{
-	update_uniform_buffers();
-}
-
 vk::DescriptorPool HPPTextureLoading::create_descriptor_pool()
 {
-	// Example uses one ubo and one image sampler
-	std::array<vk::DescriptorPoolSize, 2> pool_sizes = {{{vk::DescriptorType::eUniformBuffer, 1}, {vk::DescriptorType::eCombinedImageSampler, 1}}};
+	// Example uses one ubo and one image sampler for each swapchain image
+	uint32_t set_count = static_cast<uint32_t>(draw_cmd_buffers.size());
 
-	return get_device().get_handle().createDescriptorPool({{}, 2, pool_sizes});
+	std::array<vk::DescriptorPoolSize, 2> pool_sizes = {{{vk::DescriptorType::eUniformBuffer, set_count}, {vk::DescriptorType::eCombinedImageSampler, set_count}}};
+
+	return get_device().get_handle().createDescriptorPool({{}, set_count, pool_sizes});
 }
 
 vk::DescriptorSetLayout HPPTextureLoading::create_descriptor_set_layout()
@@ -218,6 +219,9 @@ void HPPTextureLoading::draw()
 {
 	HPPApiVulkanSample::prepare_frame();
 
+	// The uniform buffer of the acquired image is no longer read by a frame in flight
+	update_uniform_buffers();
+
 	// Command buffer to be submitted to the queue
 	submit_info.setCommandBuffers(draw_cmd_buffers[current_buffer]);
 
@@ -527,31 +531,33 @@ void HPPTextureLoading::load_texture()
 // Prepare and initialize uniform buffer containing shader uniforms
 void HPPTextureLoading::prepare_uniform_buffers()
 {
-	// Vertex shader uniform buffer block
-	vertex_shader_data_buffer =
-	    std::make_unique<vkb::core::BufferCpp>(get_device(), sizeof(vertex_shader_data), vk::BufferUsageFlagBits::eUniformBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU);
-
-	update_uniform_buffers();
+	// Vertex shader uniform buffer block, one for each swapchain image
+	// They are written by draw once the image is acquired
+	create_frame_uniform_buffers(vertex_shader_data_buffers, sizeof(vertex_shader_data));
 }
 
-void HPPTextureLoading::update_descriptor_set()
+void HPPTextureLoading::update_descriptor_sets()
 {
-	vk::DescriptorBufferInfo buffer_descriptor(vertex_shader_data_buffer->get_handle(), 0, VK_WHOLE_SIZE);
-
 	// Setup a descriptor image info for the current texture to be used as a combined image sampler
 	vk::DescriptorImageInfo image_descriptor;
 	image_descriptor.imageView   = texture.image_view;          // The image's view (images are never directly accessed by the shader, but rather through views defining subresources)
 	image_descriptor.sampler     = texture.sampler;             // The sampler (Telling the pipeline how to sample the texture, including repeat, border, etc.)
 	image_descriptor.imageLayout = texture.image_layout;        // The current layout of the image (Note: Should always fit the actual use, e.g. shader read)
 
-	std::array<vk::WriteDescriptorSet, 2> write_descriptor_sets = {
-	    {// Binding 0 : Vertex shader uniform buffer
-	     {descriptor_set, 0, {}, vk::DescriptorType::eUniformBuffer, {}, buffer_descriptor},
-	     // Binding 1 : Fragment shader texture sampler
-	     //	Fragment shader: layout (binding = 1) uniform sampler2D samplerColor;
-	     {descriptor_set, 1, {}, vk::DescriptorType::eCombinedImageSampler, image_descriptor}}};
+	// The descriptor set of each swapchain image points to the uniform buffer of that image
+	for (size_t i = 0; i < descriptor_sets.size(); ++i)
+	{
+		vk::DescriptorBufferInfo buffer_descriptor(vertex_shader_data_buffers[i]->get_handle(), 0, VK_WHOLE_SIZE);
+
+		std::array<vk::WriteDescriptorSet, 2> write_descriptor_sets = {
+		    {// Binding 0 : Vertex shader uniform buffer
+		     {descriptor_sets[i], 0, {}, vk::DescriptorType::eUniformBuffer, {}, buffer_descriptor},
+		     // Binding 1 : Fragment shader texture sampler
+		     //	Fragment shader: layout (binding = 1) uniform sampler2D samplerColor;
+		     {descriptor_sets[i], 1, {}, vk::DescriptorType::eCombinedImageSampler, image_descriptor}}};
 
-	get_device().get_handle().updateDescriptorSets(write_descriptor_sets, {});
+		get_device().get_handle().updateDescriptorSets(write_descriptor_sets, {});
+	}
 }
 
 void HPPTextureLoading::update_uniform_buffers()
@@ -567,7 +573,7 @@ void HPPTextureLoading::update_uniform_buffers()
 
 	vertex_shader_data.view_pos = glm::vec4(0.0f, 0.0f, -zoom, 0.0f);
 
-	vertex_shader_data_buffer->convert_and_update(vertex_shader_data);
+	get_frame_uniform_buffer(vertex_shader_data_buffers).convert_and_update(vertex_shader_data);
 }
 
 std::unique_ptr<vkb::Application> create_hpp_texture_loading()
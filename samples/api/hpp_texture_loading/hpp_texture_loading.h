@@ -78,7 +78,6 @@ class HPPTextureLoading : public HPPApiVulkanSample
 	void build_command_buffers() override;
 	void on_update_ui_overlay(vkb::Drawer &drawer) override;
 	void render(float delta_time) override;
-	void view_changed() override;
 
 	vk::DescriptorPool      create_descriptor_pool();
 	vk::DescriptorSetLayout create_descriptor_set_layout();
@@ -87,20 +86,20 @@ class HPPTextureLoading : public HPPApiVulkanSample
 	void                    generate_quad();
 	void                    load_texture();
 	void                    prepare_uniform_buffers();
-	void                    update_descriptor_set();
+	void                    update_descriptor_sets();
 	void                    update_uniform_buffers();
 
   private:
-	vk::DescriptorSet                     descriptor_set;
-	vk::DescriptorSetLayout               descriptor_set_layout;
-	std::unique_ptr<vkb::core::BufferCpp> index_buffer;
-	uint32_t                              index_count;
-	vk::Pipeline                          pipeline;
-	vk::PipelineLayout                    pipeline_layout;
-	Texture                               texture;
-	std::unique_ptr<vkb::core::BufferCpp> vertex_buffer;
-	VertexShaderData                      vertex_shader_data;
-	std::unique_ptr<vkb::core::BufferCpp> vertex_shader_data_buffer;
+	std::vector<vk::DescriptorSet>                     descriptor_sets;        // One for each swapchain image
+	vk::DescriptorSetLayout                            descriptor_set_layout;
+	std::unique_ptr<vkb::core::BufferCpp>              index_buffer;
+	uint32_t                                           index_count;
+	vk::Pipeline                                       pipeline;
+	vk::PipelineLayout                                 pipeline_layout;
+	Texture                                            texture;
+	std::unique_ptr<vkb::core::BufferCpp>              vertex_buffer;
+	VertexShaderData                                   vertex_shader_data;
+	std::vector<std::unique_ptr<vkb::core::BufferCpp>> vertex_shader_data_buffers;        // One for each swapchain image
 };
 
 std::unique_ptr<vkb::Application> create_hpp_texture_loading();
@@ -26,6 +26,9 @@ TextureLoading::TextureLoading()
 	zoom     = -2.5f;
 	rotation = {0.0f, 15.0f, 0.0f};
 	title    = "Texture loading";
+
+	// Each swapchain image has its own uniform buffer, so that the frames in flight are not overwritten
+	set_frame_lag(2);
 }
 
 TextureLoading::~TextureLoading()
@@ -45,7 +48,7 @@ TextureLoading::~TextureLoading()
 
 	vertex_buffer.reset();
 	index_buffer.reset();
-	uniform_buffer_vs.reset();
+	uniform_buffers_vs.clear();
 }
 
 // Enable physical device features required for this example
@@ -444,7 +447,7 @@ void TextureLoading::build_command_buffers()
 		VkRect2D scissor = vkb::initializers::rect2D(width, height, 0, 0);
 		vkCmdSetScissor(draw_cmd_buffers[i], 0, 1, &scissor);
 
-		vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 0, NULL);
+		vkCmdBindDescriptorSets(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_sets[i], 0, NULL);
 		vkCmdBindPipeline(draw_cmd_buffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.solid);
 
 		VkDeviceSize offsets[1] = {0};
@@ -465,6 +468,9 @@ void TextureLoading::draw()
 {
 	ApiVulkanSample::prepare_frame();
 
+	// The uniform buffer of the acquired image is no longer read by a frame in flight
+	update_uniform_buffers();
+
 	// Command buffer to be submitted to the queue
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
@@ -511,17 +517,19 @@ void TextureLoading::generate_quad()
 
 void TextureLoading::setup_descriptor_pool()
 {
-	// Example uses one ubo and one image sampler
+	// Example uses one ubo and one image sampler for each swapchain image
+	uint32_t set_count = static_cast<uint32_t>(draw_cmd_buffers.size());
+
 	std::vector<VkDescriptorPoolSize> pool_sizes =
 	    {
-	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1),
-	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1)};
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, set_count),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, set_count)};
 
 	VkDescriptorPoolCreateInfo descriptor_pool_create_info =
 	    vkb::initializers::descriptor_pool_create_info(
 	        static_cast<uint32_t>(pool_sizes.size()),
 	        pool_sizes.data(),
-	        2);
+	        set_count);
 
 	VK_CHECK(vkCreateDescriptorPool(get_device().get_handle(), &descriptor_pool_create_info, nullptr, &descriptor_pool));
 }
@@ -558,40 +566,46 @@ void TextureLoading::setup_descriptor_set_layout()
 
 void TextureLoading::setup_descriptor_set()
 {
-	VkDescriptorSetAllocateInfo alloc_info =
-	    vkb::initializers::descriptor_set_allocate_info(
-	        descriptor_pool,
-	        &descriptor_set_layout,
-	        1);
+	// One descriptor set for each swapchain image, pointing to the uniform buffer of that image
+	descriptor_sets.resize(draw_cmd_buffers.size());
 
-	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, &descriptor_set));
-
-	VkDescriptorBufferInfo buffer_descriptor = create_descriptor(*uniform_buffer_vs);
-
-	// Setup a descriptor image info for the current texture to be used as a combined image sampler
-	VkDescriptorImageInfo image_descriptor;
-	image_descriptor.imageView   = texture.view;                // The image's view (images are never directly accessed by the shader, but rather through views defining subresources)
-	image_descriptor.sampler     = texture.sampler;             // The sampler (Telling the pipeline how to sample the texture, including repeat, border, etc.)
-	image_descriptor.imageLayout = texture.image_layout;        // The current layout of the image (Note: Should always fit the actual use, e.g. shader read)
-
-	std::vector<VkWriteDescriptorSet> write_descriptor_sets =
-	    {
-	        // Binding 0 : Vertex shader uniform buffer
-	        vkb::initializers::write_descriptor_set(
-	            descriptor_set,
-	            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-	            0,
-	            &buffer_descriptor),
-	        // Binding 1 : Fragment shader texture sampler
-	        //	Fragment shader: layout (binding = 1) uniform sampler2D samplerColor;
-	        vkb::initializers::write_descriptor_set(
-	            descriptor_set,
-	            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,        // The descriptor set will use a combined image sampler (sampler and image could be split)
-	            1,                                                // Shader binding point 1
-	            &image_descriptor)                                // Pointer to the descriptor image for our texture
-	    };
-
-	vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, NULL);
+	for (size_t i = 0; i < descriptor_sets.size(); ++i)
+	{
+		VkDescriptorSetAllocateInfo alloc_info =
+		    vkb::initializers::descriptor_set_allocate_info(
+		        descriptor_pool,
+		        &descriptor_set_layout,
+		        1);
+
+		VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &alloc_info, &descriptor_sets[i]));
+
+		VkDescriptorBufferInfo buffer_descriptor = create_descriptor(*uniform_buffers_vs[i]);
+
+		// Setup a descriptor image info for the current texture to be used as a combined image sampler
+		VkDescriptorImageInfo image_descriptor;
+		image_descriptor.imageView   = texture.view;                // The image's view (images are never directly accessed by the shader, but rather through views defining subresources)
+		image_descriptor.sampler     = texture.sampler;             // The sampler (Telling the pipeline how to sample the texture, including repeat, border, etc.)
+		image_descriptor.imageLayout = texture.image_layout;        // The current layout of the image (Note: Should always fit the actual use, e.g. shader read)
+
+		std::vector<VkWriteDescriptorSet> write_descriptor_sets =
+		    {
+		        // Binding 0 : Vertex shader uniform buffer
+		        vkb::initializers::write_descriptor_set(
+		            descriptor_sets[i],
+		            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+		            0,
+		            &buffer_descriptor),
+		        // Binding 1 : Fragment shader texture sampler
+		        //	Fragment shader: layout (binding = 1) uniform sampler2D samplerColor;
+		        vkb::initializers::write_descriptor_set(
+		            descriptor_sets[i],
+		            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,        // The descriptor set will use a combined image sampler (sampler and image could be split)
+		            1,                                                // Shader binding point 1
+		            &image_descriptor)                                // Pointer to the descriptor image for our texture
+		    };
+
+		vkUpdateDescriptorSets(get_device().get_handle(), static_cast<uint32_t>(write_descriptor_sets.size()), write_descriptor_sets.data(), 0, NULL);
+	}
 }
 
 void TextureLoading::prepare_pipelines()
@@ -688,13 +702,9 @@ void TextureLoading::prepare_pipelines()
 // Prepare and initialize uniform buffer containing shader uniforms
 void TextureLoading::prepare_uniform_buffers()
 {
-	// Vertex shader uniform buffer block
-	uniform_buffer_vs = std::make_unique<vkb::core::BufferC>(get_device(),
-	                                                         sizeof(ubo_vs),
-	                                                         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-	                                                         VMA_MEMORY_USAGE_CPU_TO_GPU);
-
-	update_uniform_buffers();
+	// Vertex shader uniform buffer block, one for each swapchain image
+	// They are written by draw once the image is acquired
+	create_frame_uniform_buffers(uniform_buffers_vs, sizeof(ubo_vs));
 }
 
 void TextureLoading::update_uniform_buffers()
@@ -710,7 +720,7 @@ void TextureLoading::update_uniform_buffers()
 
 	ubo_vs.view_pos = glm::vec4(0.0f, 0.0f, -zoom, 0.0f);
 
-	uniform_buffer_vs->convert_and_update(ubo_vs);
+	get_frame_uniform_buffer(uniform_buffers_vs).convert_and_update(ubo_vs);
 }
 
 bool TextureLoading::prepare(const vkb::ApplicationOptions &options)
@@ -740,19 +750,12 @@ void TextureLoading::render(float delta_time)
 	draw();
 }
 
-void TextureLoading::view_changed()
-{
-	update_uniform_buffers();
-}
-
 void TextureLoading::on_update_ui_overlay(vkb::Drawer &drawer)
 {
 	if (drawer.header("Settings"))
 	{
-		if (drawer.slider_float("LOD bias", &ubo_vs.lod_bias, 0.0f, static_cast<float>(texture.mip_levels)))
-		{
-			update_uniform_buffers();
-		}
+		// The uniform buffers are written every frame
+		drawer.slider_float("LOD bias", &ubo_vs.lod_bias, 0.0f, static_cast<float>(texture.mip_levels));
 	}
 }
 
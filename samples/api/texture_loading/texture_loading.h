@@ -53,7 +53,8 @@ class TextureLoading : public ApiVulkanSample
 	std::unique_ptr<vkb::core::BufferC> index_buffer;
 	uint32_t                            index_count;
 
-	std::unique_ptr<vkb::core::BufferC> uniform_buffer_vs;
+	// Uniform buffers of each swapchain image
+	std::vector<std::unique_ptr<vkb::core::BufferC>> uniform_buffers_vs;
 
 	struct
 	{
@@ -69,8 +70,8 @@ class TextureLoading : public ApiVulkanSample
 	} pipelines;
 
 	VkPipelineLayout      pipeline_layout;
-	VkDescriptorSet       descriptor_set;
-	VkDescriptorSetLayout descriptor_set_layout;
+	std::vector<VkDescriptorSet> descriptor_sets;
+	VkDescriptorSetLayout        descriptor_set_layout;
 
 	TextureLoading();
 	~TextureLoading();
@@ -88,7 +89,6 @@ class TextureLoading : public ApiVulkanSample
 	void         update_uniform_buffers();
 	bool         prepare(const vkb::ApplicationOptions &options) override;
 	virtual void render(float delta_time) override;
-	virtual void view_changed() override;
 	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
 };
 
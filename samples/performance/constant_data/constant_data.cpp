@@ -325,7 +325,7 @@ vkb::PipelineLayout &ConstantData::PushConstantSubpass::prepare_pipeline_layout(
 	return command_buffer.get_device().get_resource_cache().request_pipeline_layout(shader_modules);
 }
 
-void ConstantData::PushConstantSubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
+void ConstantData::PushConstantSubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet)
 {
 	/**
 	 * POI
@@ -391,7 +391,7 @@ vkb::PipelineLayout &ConstantData::DescriptorSetSubpass::prepare_pipeline_layout
 	return command_buffer.get_device().get_resource_cache().request_pipeline_layout(shader_modules);
 }
 
-void ConstantData::DescriptorSetSubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
+void ConstantData::DescriptorSetSubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet)
 {
 	/**
 	 * POI
@@ -468,7 +468,7 @@ vkb::PipelineLayout &ConstantData::BufferArraySubpass::prepare_pipeline_layout(v
 	return command_buffer.get_device().get_resource_cache().request_pipeline_layout(shader_modules);
 }
 
-void ConstantData::BufferArraySubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
+void ConstantData::BufferArraySubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet)
 {
 	/**
 	 * POI
@@ -477,13 +477,13 @@ void ConstantData::BufferArraySubpass::prepare_push_constants(vkb::CommandBuffer
 	return;
 }
 
-void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
+void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, uint32_t instance_count)
 {
 	/**
 	 * POI
 	 * We control the shader `gl_InstanceIndex` value with the last argument of the draw commands.
 	 * The BufferArraySubpass stores a value `instance_index` which is cleared to 0 before each
-	 * pass, and is incremented for each mesh that we draw with this function.
+	 * pass, and is incremented for each mesh instance that we draw with this function.
 	 *
 	 * We bind a storage buffer object containing all the uniform data we require for the entire scene
 	 * in the right order, so the index's have to match that order of how the individual uniform data
@@ -494,10 +494,12 @@ void ConstantData::BufferArraySubpass::draw_submesh_command(vkb::CommandBuffer &
 		// Bind index buffer of submesh
 		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
 
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, instance_index++);
+		command_buffer.draw_indexed(sub_mesh.vertex_indices, instance_count, 0, 0, instance_index);
 	}
 	else
 	{
-		command_buffer.draw(sub_mesh.vertices_count, 1, 0, instance_index++);
+		command_buffer.draw(sub_mesh.vertices_count, instance_count, 0, instance_index);
 	}
+
+	instance_index += instance_count;
 }
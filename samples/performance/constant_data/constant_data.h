@@ -139,7 +139,7 @@ class ConstantData : public vkb::VulkanSampleC
 		/**
 		 * @brief Overridden to push a custom data structure to the shader
 		 */
-		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh) override;
+		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet) override;
 
 		// The MVP uniform data structure
 		MVPUniform mvp_uniform;
@@ -171,7 +171,7 @@ class ConstantData : public vkb::VulkanSampleC
 		/**
 		 * @brief Overridden to intentionally disable any push constants
 		 */
-		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh) override;
+		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet) override;
 
 		// The method by which the UBO subpass will operate
 		Method method;
@@ -205,12 +205,12 @@ class ConstantData : public vkb::VulkanSampleC
 		/**
 		 * @brief Overridden to intentionally disable any push constants
 		 */
-		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh) override;
+		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet) override;
 
 		/**
 		 * @brief Overridden to send an index
 		 */
-		virtual void draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh) override;
+		virtual void draw_submesh_command(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, uint32_t instance_count = 1) override;
 
 		uint32_t instance_index{0};
 	};
@@ -92,6 +92,9 @@ void DescriptorManagement::update(float delta_time)
 
 	render_context.get_active_frame().set_descriptor_management_strategy(descriptor_management_strategy);
 
+	// Each recording thread allocates its descriptor sets and buffers from its own pools of the frame
+	get_render_pipeline().set_thread_count(subpass_recording.value == 0 ? 1 : RECORDING_THREAD_COUNT);
+
 	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 	get_stats().begin_sampling(command_buffer);
 
@@ -147,6 +150,11 @@ void DescriptorManagement::draw_gui()
 	    /* lines = */ vkb::to_u32(lines));
 }
 
+void DescriptorManagement::prepare_render_context()
+{
+	get_render_context().prepare(RECORDING_THREAD_COUNT);
+}
+
 std::unique_ptr<vkb::VulkanSampleC> create_descriptor_management()
 {
 	return std::make_unique<DescriptorManagement>();
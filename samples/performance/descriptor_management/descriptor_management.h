@@ -54,11 +54,21 @@ class DescriptorManagement : public vkb::VulkanSampleC
 	    {"Disabled", "Enabled"},
 	    0};
 
-	std::vector<RadioButtonGroup *> radio_buttons = {&descriptor_caching, &buffer_allocation};
+	RadioButtonGroup subpass_recording{
+	    "Multithreaded recording",
+	    {"Disabled", "Enabled"},
+	    0};
+
+	std::vector<RadioButtonGroup *> radio_buttons = {&descriptor_caching, &buffer_allocation, &subpass_recording};
+
+	/// Number of threads recording the scene subpass, when multithreaded recording is enabled
+	static constexpr uint32_t RECORDING_THREAD_COUNT = 4;
 
 	vkb::sg::PerspectiveCamera *camera{nullptr};
 
 	virtual void draw_gui() override;
+
+	virtual void prepare_render_context() override;
 };
 
 std::unique_ptr<vkb::VulkanSampleC> create_descriptor_management();
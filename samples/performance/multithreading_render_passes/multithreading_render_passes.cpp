@@ -55,6 +55,9 @@ bool MultithreadingRenderPasses::prepare(const vkb::ApplicationOptions &options)
 		return false;
 	}
 
+	// Worker threads recording the first frames must not serialize on each other's pipeline builds
+	get_device().get_resource_cache().set_concurrent_mode(true);
+
 	shadow_render_targets.resize(get_render_context().get_render_frames().size());
 	for (uint32_t i = 0; i < shadow_render_targets.size(); i++)
 	{
@@ -197,11 +200,6 @@ std::vector<vkb::CommandBuffer *> MultithreadingRenderPasses::record_command_buf
 	auto use_multithreading = multithreading_mode != static_cast<int>(MultithreadingMode::None);
 	shadow_subpass->set_thread_index(use_multithreading ? 1 : 0);
 
-	if (use_multithreading && thread_pool.size() < 1)
-	{
-		thread_pool.resize(1);
-	}
-
 	switch (multithreading_mode)
 	{
 		case static_cast<int>(MultithreadingMode::PrimaryCommandBuffers):
@@ -234,8 +232,10 @@ void MultithreadingRenderPasses::record_separate_primary_command_buffers(std::ve
 	                                                                                             1);
 
 	// Recording shadow command buffer
-	auto shadow_buffer_future = thread_pool.push(
-	    [this, &shadow_command_buffer](size_t thread_id) {
+	auto &job_system = vkb::JobSystem::get();
+
+	auto shadow_buffer_job = job_system.schedule(
+	    [this, &shadow_command_buffer]() {
 		    shadow_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 		    draw_shadow_pass(shadow_command_buffer);
 		    shadow_command_buffer.end();
@@ -250,7 +250,7 @@ void MultithreadingRenderPasses::record_separate_primary_command_buffers(std::ve
 	command_buffers.push_back(&main_command_buffer);
 
 	// Wait for recording
-	shadow_buffer_future.get();
+	job_system.wait(shadow_buffer_job);
 }
 
 void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::vector<vkb::CommandBuffer *> &command_buffers, vkb::CommandBuffer &main_command_buffer)
@@ -281,8 +281,10 @@ void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::
 	auto &scene_framebuffer   = get_device().get_resource_cache().request_framebuffer(scene_render_target, scene_render_pass);
 
 	// Recording shadow command buffer
-	auto shadow_buffer_future = thread_pool.push(
-	    [this, &shadow_command_buffer, &shadow_render_pass, &shadow_framebuffer](size_t thread_id) {
+	auto &job_system = vkb::JobSystem::get();
+
+	auto shadow_buffer_job = job_system.schedule(
+	    [this, &shadow_command_buffer, &shadow_render_pass, &shadow_framebuffer]() {
 		    shadow_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &shadow_render_pass, &shadow_framebuffer, 0);
 		    draw_shadow_pass(shadow_command_buffer);
 		    shadow_command_buffer.end();
@@ -298,7 +300,7 @@ void MultithreadingRenderPasses::record_separate_secondary_command_buffers(std::
 	scene_command_buffer.end();
 
 	// Wait for recording
-	shadow_buffer_future.get();
+	job_system.wait(shadow_buffer_job);
 
 	// Recording main command buffer
 	main_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
@@ -548,7 +550,7 @@ vkb::PipelineLayout &MultithreadingRenderPasses::ShadowSubpass::prepare_pipeline
 	return command_buffer.get_device().get_resource_cache().request_pipeline_layout({vertex_shader_module});
 }
 
-void MultithreadingRenderPasses::ShadowSubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh)
+void MultithreadingRenderPasses::ShadowSubpass::prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet)
 {
 	// No push constants are used the in shadow pass
 	return;
@@ -17,9 +17,8 @@
 
 #pragma once
 
-#include <ctpl_stl.h>
-
 #include "core/command_buffer.h"
+#include "core/util/job_system.hpp"
 #include "rendering/render_pipeline.h"
 #include "rendering/subpasses/forward_subpass.h"
 #include "scene_graph/components/camera.h"
@@ -74,7 +73,7 @@ class MultithreadingRenderPasses : public vkb::VulkanSampleC
 
 		virtual vkb::PipelineLayout &prepare_pipeline_layout(vkb::CommandBuffer &command_buffer, const std::vector<vkb::ShaderModule *> &shader_modules) override;
 
-		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh) override;
+		virtual void prepare_push_constants(vkb::CommandBuffer &command_buffer, vkb::sg::SubMesh &sub_mesh, const DrawPacket &packet) override;
 	};
 
 	/**
@@ -148,8 +147,6 @@ class MultithreadingRenderPasses : public vkb::VulkanSampleC
 	 */
 	vkb::sg::Camera *camera{};
 
-	ctpl::thread_pool thread_pool;
-
 	uint32_t swapchain_attachment_index{0};
 
 	uint32_t depth_attachment_index{1};
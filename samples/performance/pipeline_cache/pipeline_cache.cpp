@@ -116,8 +116,8 @@ bool PipelineCache::prepare(const vkb::ApplicationOptions &options)
 		LOGW("No data cache found. {}", ex.what());
 	}
 
-	// Build all pipelines from a previous run
-	resource_cache.warmup(data_cache);
+	// Build all pipelines from a previous run, spreading independent objects across all cores
+	resource_cache.warmup(data_cache, true);
 
 	get_stats().request_stats({vkb::StatIndex::frame_times});
 
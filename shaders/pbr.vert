@@ -43,17 +43,32 @@ layout(set = 0, binding = 4) uniform LightsInfo
 }
 lights;
 
+#ifdef INSTANCED
+// Model matrices of the instances drawn together, written by GeometrySubpass
+layout(set = 0, binding = 5) readonly buffer InstanceData
+{
+	mat4 models[];
+}
+instance_data;
+#endif
+
 layout(location = 0) out vec3 o_pos;
 layout(location = 1) out vec2 o_uv;
 layout(location = 2) out vec3 o_normal;
 
 void main(void)
 {
-	o_pos = vec3(global_uniform.model * vec4(position, 1.0));
+#ifdef INSTANCED
+	mat4 model = instance_data.models[gl_InstanceIndex];
+#else
+	mat4 model = global_uniform.model;
+#endif
+
+	o_pos = vec3(model * vec4(position, 1.0));
 
 	o_uv = texcoord_0;
 
-	o_normal = mat3(global_uniform.model) * normal;
+	o_normal = mat3(model) * normal;
 
-	gl_Position = global_uniform.view_proj * global_uniform.model * vec4(position, 1.0);
+	gl_Position = global_uniform.view_proj * model * vec4(position, 1.0);
 }